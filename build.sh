@@ -96,6 +96,7 @@ BUILD_CONF_METAL=1
 BUILD_CONF_VULKAN=1
 BUILD_CONF_NET=1
 BUILD_CONF_VR=1
+BUILD_CONF_LOCK_STATS=0
 BUILD_CONF_LIBSTDCXX=0
 BUILD_CONF_NATIVE=0
 
@@ -142,6 +143,7 @@ for arg in "$@"; do
 			echo "	no-openal          disables openal support"
 			echo "	no-vr              disables VR support (default for macOS and iOS targets)"
 			echo "	no-net             disables network support"
+			echo "	lock-stats         enables lock contention statistics (see atomic_spin_lock::enable_stats)"
 			echo "	libstdc++          use libstdc++ instead of libc++ (highly discouraged unless building on mingw)"
 			echo "	native             optimize and specifically build for the host cpu"
 			echo ""
@@ -216,6 +218,9 @@ for arg in "$@"; do
 		"no-net")
 			BUILD_CONF_NET=0
 			;;
+		"lock-stats")
+			BUILD_CONF_LOCK_STATS=1
+			;;
 		"libstdc++")
 			BUILD_CONF_LIBSTDCXX=1
 			;;
@@ -673,6 +678,8 @@ if [ ${BUILD_CLEAN} -eq 0 -a ${BUILD_JSON} -eq 0 ]; then
 	set_conf_val "###FLOOR_OPENAL###" "FLOOR_NO_OPENAL" ${BUILD_CONF_OPENAL}
 	set_conf_val "###FLOOR_VR###" "FLOOR_NO_VR" ${BUILD_CONF_VR}
 	set_conf_val "###FLOOR_NET###" "FLOOR_NO_NET" ${BUILD_CONF_NET}
+	# NOTE: this enables a feature instead of disabling one -> inverted
+	set_conf_val "###FLOOR_LOCK_STATS###" "FLOOR_LOCK_STATS" $((1 - BUILD_CONF_LOCK_STATS))
 	echo "${CONF}" > floor/floor_conf.hpp.tmp
 
 	# check if this is an entirely new conf or if it differs from the existing conf
@@ -0,0 +1,102 @@
+/*
+ *  Flo's Open libRary (floor)
+ *  Copyright (C) 2004 - 2022 Florian Ziesche
+ *  
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; version 2 of the License only.
+ *  
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <floor/compute/compute_async.hpp>
+#include <floor/core/logger.hpp>
+
+compute_async_context::~compute_async_context() {
+	run();
+}
+
+void compute_async_context::post(coroutine_handle<> handle) {
+	// NOTE: notify while holding the lock, the context may be destroyed as soon as the last task has been resumed
+	lock_guard<mutex> guard(ready_lock);
+	ready_handles.emplace_back(handle);
+	ready_cv.notify_one();
+}
+
+bool compute_async_context::poll() {
+	vector<coroutine_handle<>> handles;
+	{
+		lock_guard<mutex> guard(ready_lock);
+		handles.swap(ready_handles);
+	}
+	for (auto& handle : handles) {
+		handle.resume();
+	}
+	return !handles.empty();
+}
+
+void compute_async_context::run() {
+	while (active_task_count > 0u) {
+		if (poll()) {
+			continue;
+		}
+		unique_lock<mutex> guard(ready_lock);
+		ready_cv.wait(guard, [this] { return (!ready_handles.empty() || active_task_count == 0u); });
+	}
+}
+
+void compute_async_context::task_completed(coroutine_handle<> handle, exception_ptr exc_ptr) {
+	if (exc_ptr) {
+		try {
+			rethrow_exception(exc_ptr);
+		} catch (exception& exc) {
+			log_error("encountered an unhandled exception in a compute task: $", exc.what());
+		} catch (...) {
+			log_error("encountered an unhandled exception in a compute task");
+		}
+	}
+	// NOTE: the coroutine is suspended at its final suspend point -> can safely be destroyed here
+	handle.destroy();
+	--active_task_count;
+}
+
+compute_task<> compute_async_context::read(const compute_queue& cqueue, compute_buffer& buffer, void* dst,
+										   const size_t size, const size_t offset) {
+	// backend reads block until the data is available -> don't block this context
+	co_await offload_blocking([&cqueue, &buffer, dst, size, offset]() {
+		buffer.read(cqueue, dst, size, offset);
+	});
+}
+
+compute_task<> compute_async_context::write(const compute_queue& cqueue, compute_buffer& buffer, const void* src,
+											const size_t size, const size_t offset) {
+	// backend writes block until the data has been copied -> don't block this context
+	co_await offload_blocking([&cqueue, &buffer, src, size, offset]() {
+		buffer.write(cqueue, src, size, offset);
+	});
+}
+
+compute_task<void*> compute_async_context::map(const compute_queue& cqueue, compute_buffer& buffer,
+											   const COMPUTE_MEMORY_MAP_FLAG flags,
+											   const size_t size, const size_t offset) {
+	auto mapped_ptr = buffer.map(cqueue, flags & ~COMPUTE_MEMORY_MAP_FLAG::BLOCK, size, offset);
+	if (mapped_ptr == nullptr) {
+		co_return nullptr;
+	}
+	co_await completion(cqueue);
+	co_return mapped_ptr;
+}
+
+compute_task<shared_ptr<compute_program>> compute_async_context::add_program_file(compute_context& ctx, const string file_name,
+																				  const compute_context::compile_options options) {
+	co_return co_await offload([&ctx, &file_name, &options]() {
+		return ctx.add_program_file(file_name, options);
+	});
+}
@@ -0,0 +1,341 @@
+/*
+ *  Flo's Open libRary (floor)
+ *  Copyright (C) 2004 - 2022 Florian Ziesche
+ *  
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; version 2 of the License only.
+ *  
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef __FLOOR_COMPUTE_ASYNC_HPP__
+#define __FLOOR_COMPUTE_ASYNC_HPP__
+
+#include <floor/core/essentials.hpp>
+#include <floor/compute/compute_queue.hpp>
+#include <floor/compute/compute_buffer.hpp>
+#include <floor/compute/compute_context.hpp>
+#include <floor/threading/task_scheduler.hpp>
+#include <floor/threading/task.hpp>
+#include <coroutine>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <vector>
+#include <optional>
+#include <exception>
+#include <type_traits>
+
+//! C++20 coroutine based asynchronous compute API:
+//! a single thread running a compute_async_context can drive any amount of in-flight compute pipelines,
+//! each written as a sequential compute_task coroutine that co_awaits queue completion, buffer transfers or program builds.
+//!
+//! example:
+//!   compute_task<> pipeline(compute_async_context& actx, const compute_queue& cqueue, compute_buffer& buf, ...) {
+//!       co_await actx.write(cqueue, buf, src_data);
+//!       cqueue.execute(*kernel, global_size, local_size, &buf);
+//!       co_await actx.completion(cqueue);
+//!       co_await actx.read(cqueue, buf, dst_data);
+//!   }
+//!   actx.spawn(pipeline(actx, *cqueue, *buf, ...));
+//!   actx.run(); // returns once all spawned pipelines have completed
+//!
+//! NOTE: all coroutines are resumed on the thread that runs the compute_async_context (run() or poll()),
+//!       never on internal backend or worker threads
+//! NOTE: as with all coroutines, reference arguments must stay valid until the coroutine has completed
+
+class compute_async_context;
+template <typename T = void> class compute_task;
+
+namespace compute_async_detail {
+	//! promise functionality that is shared by all compute_task types
+	struct promise_base {
+		//! coroutine that co_awaits this task (resumed once this task has completed)
+		coroutine_handle<> continuation;
+		//! if this task has been spawned: the owning context (destroys this task once it has completed)
+		compute_async_context* owning_ctx { nullptr };
+		//! exception that escaped the coroutine body
+		exception_ptr exception;
+		
+		//! tasks are started lazily (when they are co_await'ed or spawned)
+		suspend_always initial_suspend() noexcept { return {}; }
+		
+		void unhandled_exception() noexcept {
+			exception = current_exception();
+		}
+		
+		struct final_awaiter {
+			bool await_ready() const noexcept { return false; }
+			template <typename promise_type>
+			coroutine_handle<> await_suspend(coroutine_handle<promise_type> handle) noexcept;
+			void await_resume() const noexcept {}
+		};
+		final_awaiter final_suspend() noexcept { return {}; }
+	};
+	
+	//! promise result storage
+	template <typename T>
+	struct promise_result : public promise_base {
+		optional<T> value;
+		
+		template <typename U> requires is_convertible_v<U&&, T>
+		void return_value(U&& ret_value) {
+			value.emplace(std::forward<U>(ret_value));
+		}
+	};
+	template <>
+	struct promise_result<void> : public promise_base {
+		void return_void() noexcept {}
+	};
+} // namespace compute_async_detail
+
+//! lazily started coroutine task returning a value of type T (or nothing if void)
+template <typename T>
+class compute_task {
+public:
+	struct promise_type : public compute_async_detail::promise_result<T> {
+		compute_task get_return_object() {
+			return compute_task { coroutine_handle<promise_type>::from_promise(*this) };
+		}
+	};
+	using handle_type = coroutine_handle<promise_type>;
+	
+	compute_task() = default;
+	explicit compute_task(handle_type handle_) : handle(handle_) {}
+	compute_task(compute_task&& task) noexcept : handle(task.handle) {
+		task.handle = nullptr;
+	}
+	compute_task& operator=(compute_task&& task) noexcept {
+		if (this != &task) {
+			if (handle) {
+				handle.destroy();
+			}
+			handle = task.handle;
+			task.handle = nullptr;
+		}
+		return *this;
+	}
+	~compute_task() {
+		if (handle) {
+			handle.destroy();
+		}
+	}
+	
+	//! returns true if this refers to a coroutine
+	bool valid() const {
+		return (bool)handle;
+	}
+	
+	//! starts this task and suspends the awaiting coroutine until this task has completed,
+	//! then returns its result or rethrows its exception
+	auto operator co_await() && noexcept {
+		struct task_awaiter {
+			handle_type task_handle;
+			
+			bool await_ready() const noexcept {
+				return (!task_handle || task_handle.done());
+			}
+			coroutine_handle<> await_suspend(coroutine_handle<> awaiting_handle) noexcept {
+				task_handle.promise().continuation = awaiting_handle;
+				return task_handle;
+			}
+			T await_resume() {
+				auto& promise = task_handle.promise();
+				if (promise.exception) {
+					rethrow_exception(promise.exception);
+				}
+				if constexpr (!is_void_v<T>) {
+					return std::move(*promise.value);
+				}
+			}
+		};
+		return task_awaiter { handle };
+	}
+	
+	//! releases ownership of the coroutine
+	handle_type release() {
+		auto ret = handle;
+		handle = nullptr;
+		return ret;
+	}
+
+protected:
+	handle_type handle;
+	
+	// prohibit copying
+	compute_task(const compute_task&) = delete;
+	compute_task& operator=(const compute_task&) = delete;
+
+};
+
+//! runs compute_task coroutines: all coroutines are resumed on the thread that calls run() or poll(),
+//! backend completion handlers and worker threads only post coroutines back to this context
+class compute_async_context {
+public:
+	compute_async_context() = default;
+	//! NOTE: blocks until all spawned tasks have completed
+	~compute_async_context();
+	
+	//! starts the specified task in this context, the task is owned by this context and destroyed once it has completed
+	//! NOTE: exceptions escaping a spawned task are logged
+	template <typename T>
+	void spawn(compute_task<T>&& task) {
+		auto handle = task.release();
+		if (!handle) {
+			return;
+		}
+		handle.promise().owning_ctx = this;
+		++active_task_count;
+		post(handle);
+	}
+	
+	//! schedules the specified coroutine to be resumed in this context (thread-safe)
+	void post(coroutine_handle<> handle);
+	
+	//! resumes all coroutines that are ready right now, returns true if any coroutine was resumed
+	bool poll();
+	
+	//! resumes coroutines as they become ready, until all spawned tasks have completed
+	void run();
+	
+	//! returns the amount of spawned tasks that have not completed yet
+	uint32_t get_active_task_count() const {
+		return active_task_count;
+	}
+	
+	//! awaitable that completes once all work that has been scheduled in "cqueue" up to this point has been executed
+	//! NOTE: this uses the completion mechanism of the backend (see compute_queue::add_completion_handler)
+	auto completion(const compute_queue& cqueue) {
+		struct queue_completion_awaiter {
+			compute_async_context& ctx;
+			const compute_queue& cqueue;
+			
+			bool await_ready() const noexcept { return false; }
+			void await_suspend(coroutine_handle<> handle) {
+				cqueue.flush();
+				cqueue.add_completion_handler([ctx_ptr = &ctx, handle]() {
+					ctx_ptr->post(handle);
+				});
+			}
+			void await_resume() const noexcept {}
+		};
+		return queue_completion_awaiter { *this, cqueue };
+	}
+	
+	//! awaitable that executes "op" on the global task scheduler (for CPU-heavy work), then returns its result
+	//! NOTE: "op" must not block for a longer time (e.g. waiting on other queues or I/O), as it occupies a worker thread
+	template <typename F>
+	auto offload(F&& op, const task_scheduler::PRIORITY priority = task_scheduler::PRIORITY::NORMAL) {
+		return offload_awaiter<decay_t<F>, false> { *this, std::forward<F>(op), priority };
+	}
+	
+	//! awaitable that executes the blocking "op" in a separate thread (see task::spawn_blocking), then returns its result
+	//! NOTE: use this for calls that wait on devices or I/O, so that neither this context nor a worker thread is blocked
+	template <typename F>
+	auto offload_blocking(F&& op) {
+		return offload_awaiter<decay_t<F>, true> { *this, std::forward<F>(op), task_scheduler::PRIORITY::NORMAL };
+	}
+	
+	//! reads "size" bytes (or the complete buffer if 0) from "offset" onwards of "buffer" to "dst",
+	//! completes once the data is available in "dst"
+	//! NOTE: the (blocking) backend read is executed in a separate thread, this context is not blocked meanwhile
+	compute_task<> read(const compute_queue& cqueue, compute_buffer& buffer, void* dst,
+						const size_t size = 0, const size_t offset = 0);
+	
+	//! writes "size" bytes (or the complete buffer if 0) from "src" to "offset" onwards of "buffer",
+	//! completes once the data has been written ("src" may be modified/freed afterwards)
+	//! NOTE: the (blocking) backend write is executed in a separate thread, this context is not blocked meanwhile
+	compute_task<> write(const compute_queue& cqueue, compute_buffer& buffer, const void* src,
+						 const size_t size = 0, const size_t offset = 0);
+	
+	//! maps "size" bytes (or the complete buffer if 0) from "offset" onwards of "buffer" into host memory,
+	//! completes with the mapped pointer once the memory is accessible (nullptr on failure)
+	//! NOTE: BLOCK is implied by awaiting this and is removed from "flags"
+	compute_task<void*> map(const compute_queue& cqueue, compute_buffer& buffer,
+							const COMPUTE_MEMORY_MAP_FLAG flags = COMPUTE_MEMORY_MAP_FLAG::READ_WRITE,
+							const size_t size = 0, const size_t offset = 0);
+	
+	//! adds and compiles a program from a file (on the global task scheduler), completes with the program (nullptr on failure)
+	compute_task<shared_ptr<compute_program>> add_program_file(compute_context& ctx, const string file_name,
+															   const compute_context::compile_options options = {});
+	
+	//! internal: called once a spawned task has completed, logs its exception (if any) and destroys it
+	void task_completed(coroutine_handle<> handle, exception_ptr exc_ptr);
+
+protected:
+	//! executes "op" on the global task scheduler or in a separate thread (if "blocking"),
+	//! then resumes the awaiting coroutine in this context
+	template <typename F, bool blocking>
+	struct offload_awaiter {
+		using ret_type = invoke_result_t<F&>;
+		
+		compute_async_context& ctx;
+		F op;
+		task_scheduler::PRIORITY priority;
+		conditional_t<is_void_v<ret_type>, bool, optional<ret_type>> result {};
+		exception_ptr exception;
+		
+		bool await_ready() const noexcept { return false; }
+		void await_suspend(coroutine_handle<> handle) {
+			// NOTE: this awaiter lives in the (suspended) coroutine frame until the coroutine is resumed
+			auto run_op = [this, handle]() {
+				try {
+					if constexpr (is_void_v<ret_type>) {
+						op();
+					} else {
+						result.emplace(op());
+					}
+				} catch (...) {
+					exception = current_exception();
+				}
+				ctx.post(handle);
+			};
+			if constexpr (blocking) {
+				task::spawn_blocking(std::move(run_op), "compute async");
+			} else {
+				task_scheduler::get_global().submit(std::move(run_op), priority);
+			}
+		}
+		ret_type await_resume() {
+			if (exception) {
+				rethrow_exception(exception);
+			}
+			if constexpr (!is_void_v<ret_type>) {
+				return std::move(*result);
+			}
+		}
+	};
+	
+	mutex ready_lock;
+	condition_variable ready_cv;
+	vector<coroutine_handle<>> ready_handles;
+	atomic<uint32_t> active_task_count { 0u };
+	
+	// prohibit copying
+	compute_async_context(const compute_async_context&) = delete;
+	compute_async_context& operator=(const compute_async_context&) = delete;
+
+};
+
+template <typename promise_type>
+coroutine_handle<> compute_async_detail::promise_base::final_awaiter::await_suspend(coroutine_handle<promise_type> handle) noexcept {
+	auto& promise = handle.promise();
+	if (promise.continuation) {
+		// resume the awaiting coroutine (symmetric transfer)
+		return promise.continuation;
+	}
+	if (promise.owning_ctx != nullptr) {
+		promise.owning_ctx->task_completed(handle, promise.exception);
+	}
+	return noop_coroutine();
+}
+
+#endif
@@ -70,6 +70,16 @@ const compute_device* compute_context::get_device(const compute_device::TYPE typ
 	return (!devices.empty() ? devices[0].get() : nullptr);
 }
 
+shared_ptr<compute_program> compute_context::add_specializable_program_source(const string& source_code,
+																			 compile_options options) {
+	return make_shared<specializable_program>(*this, source_code, false, move(options));
+}
+
+shared_ptr<compute_program> compute_context::add_specializable_program_file(const string& file_name,
+																		   compile_options options) {
+	return make_shared<specializable_program>(*this, file_name, true, move(options));
+}
+
 vector<const compute_device*> compute_context::get_devices() const {
 	vector<const compute_device*> ret;
 	for (const auto& dev : devices) {
@@ -266,6 +266,16 @@ public:
 	virtual shared_ptr<compute_program> add_program_source(const string& source_code,
 														   compile_options options = {}) = 0;
 	
+	//! creates a program from the provided source code that is compiled on demand for each set of specialization constants,
+	//! specialized kernels can be retrieved via compute_program::get_specialized_kernel
+	shared_ptr<compute_program> add_specializable_program_source(const string& source_code,
+																 compile_options options = {});
+	
+	//! creates a program from a file that is compiled on demand for each set of specialization constants,
+	//! specialized kernels can be retrieved via compute_program::get_specialized_kernel
+	shared_ptr<compute_program> add_specializable_program_file(const string& file_name,
+															   compile_options options = {});
+	
 	//! adds a precompiled program and its functions, using the provided file name and function infos
 	virtual shared_ptr<compute_program> add_precompiled_program_file(const string& file_name,
 																	 const vector<llvm_toolchain::function_info>& functions) = 0;
@@ -809,7 +809,7 @@ unique_ptr<uint8_t[]> compute_image::rgba_to_rgb(const COMPUTE_IMAGE_TYPE& rgba_
 
 void compute_image::build_mip_map_minification_program() const {
 	// build mip-map minify kernels (do so in a separate thread so that we don't hold up anything)
-	task::spawn([this, ctx = dev.context]() {
+	task::spawn_blocking([this, ctx = dev.context]() {
 		auto prog = make_unique<minify_program>();
 		const llvm_toolchain::compile_options options {
 			// suppress any debug output for this, we only want to have console/log output if something goes wrong
@@ -17,6 +17,7 @@
  */
 
 #include <floor/compute/compute_program.hpp>
+#include <floor/compute/compute_context.hpp>
 
 compute_program::~compute_program() {}
 
@@ -25,3 +26,70 @@ shared_ptr<compute_kernel> compute_program::get_kernel(const string& func_name)
 	if(iter == cend(kernel_names)) return {};
 	return kernels[(size_t)distance(cbegin(kernel_names), iter)];
 }
+
+shared_ptr<compute_kernel> compute_program::get_specialized_kernel(const string& func_name,
+																   const specialization_constants& constants) const {
+	if(constants.empty()) return get_kernel(func_name);
+	log_error("program can not be specialized (kernel $)", func_name);
+	return {};
+}
+
+specializable_program::specializable_program(compute_context& ctx_, const string& source_or_file_name_, const bool is_file_,
+											 llvm_toolchain::compile_options options_) :
+ctx(ctx_), source_or_file_name(source_or_file_name_), is_file(is_file_), options(options_) {
+}
+
+shared_ptr<compute_kernel> specializable_program::get_kernel(const string& func_name) const {
+	return get_specialized_kernel(func_name, {});
+}
+
+shared_ptr<compute_kernel> specializable_program::get_specialized_kernel(const string& func_name,
+																		 const specialization_constants& constants) const {
+	const auto prog = get_specialization(constants);
+	if(!prog) return {};
+	return prog->get_kernel(func_name);
+}
+
+shared_ptr<compute_program> specializable_program::get_specialization(const specialization_constants& constants) const {
+	// canonical key: constants sorted by name, so that insertion order doesn't matter
+	vector<pair<string, string>> sorted_constants(constants.cbegin(), constants.cend());
+	sort(begin(sorted_constants), end(sorted_constants));
+	string key;
+	for(const auto& constant : sorted_constants) {
+		key += constant.first + '=' + constant.second + '\n';
+	}
+	
+	// existing (or in-flight) variant -> wait outside of the lock
+	// otherwise: insert a placeholder that is fulfilled once this thread has compiled the variant
+	promise<shared_ptr<compute_program>> prog_promise;
+	shared_future<shared_ptr<compute_program>> existing_prog;
+	{
+		GUARD(variants_lock);
+		const auto iter = variants.find(key);
+		if(iter != variants.end()) {
+			existing_prog = iter->second;
+		} else {
+			variants.emplace(key, prog_promise.get_future().share());
+		}
+	}
+	if(existing_prog.valid()) {
+		return existing_prog.get();
+	}
+	
+	auto variant_options = options;
+	variant_options.defines.insert(variant_options.defines.end(), sorted_constants.begin(), sorted_constants.end());
+	shared_ptr<compute_program> prog;
+	try {
+		prog = (is_file ?
+				ctx.add_program_file(source_or_file_name, variant_options) :
+				ctx.add_program_source(source_or_file_name, variant_options));
+	} catch(...) {
+		// -> failed (must still fulfill the promise, other threads may be waiting on it)
+	}
+	if(!prog) {
+		log_error("failed to compile program specialization:\n$", key);
+	}
+	// NOTE: failed compilations are cached as well, there is no point in retrying them
+	prog_promise.set_value(prog);
+	return prog;
+}
@@ -25,8 +25,12 @@
 #include <floor/compute/llvm_toolchain.hpp>
 #include <floor/compute/universal_binary.hpp>
 #include <floor/core/flat_map.hpp>
+#include <floor/threading/thread_safety.hpp>
+#include <unordered_map>
+#include <future>
 
 class compute_kernel;
+class compute_context;
 class compute_program {
 public:
 	virtual ~compute_program() = 0;
@@ -34,6 +38,16 @@ public:
 	//! returns the kernel with the exact function name of "func_name", nullptr if not found
 	virtual shared_ptr<compute_kernel> get_kernel(const string& func_name) const;
 	
+	//! named compile-time constants that are used to specialize a program: constant name -> value
+	//! NOTE: values are inserted verbatim as macro definitions, i.e. as they would be written in source code (e.g. "16u")
+	using specialization_constants = flat_map<string, string>;
+	
+	//! returns the kernel with the exact function name of "func_name" specialized with the specified compile-time "constants",
+	//! nullptr if not found or if this program can not be specialized
+	//! NOTE: only programs created via compute_context::add_specializable_program_* can be specialized
+	virtual shared_ptr<compute_kernel> get_specialized_kernel(const string& func_name,
+															  const specialization_constants& constants) const;
+	
 	//! returns a container of all kernels in this program
 	const vector<shared_ptr<compute_kernel>>& get_kernels() const {
 		return kernels;
@@ -72,4 +86,36 @@ protected:
 	
 };
 
+//! a program that is compiled on demand for each unique set of specialization constants,
+//! compiled variants are cached and reused for all subsequent requests with the same constants
+//! NOTE: constants are passed as macro definitions that are not part of the cached pch key, i.e. all variants share one pch
+class specializable_program final : public compute_program {
+public:
+	specializable_program(compute_context& ctx, const string& source_or_file_name, const bool is_file,
+						  llvm_toolchain::compile_options options);
+	~specializable_program() override = default;
+	
+	//! returns the kernel "func_name" of the unspecialized variant (no constants defined)
+	shared_ptr<compute_kernel> get_kernel(const string& func_name) const override;
+	
+	shared_ptr<compute_kernel> get_specialized_kernel(const string& func_name,
+													  const specialization_constants& constants) const override;
+	
+	//! returns the program variant for the specified "constants", compiling it if it doesn't exist yet
+	shared_ptr<compute_program> get_specialization(const specialization_constants& constants) const;
+	
+protected:
+	compute_context& ctx;
+	const string source_or_file_name;
+	const bool is_file;
+	const llvm_toolchain::compile_options options;
+	
+	mutable safe_mutex variants_lock;
+	//! canonical constants string -> compiled (or in-flight) program variant
+	//! NOTE: the future is inserted before compilation starts, so that a variant is only compiled once, while
+	//!       compilation itself happens outside of the lock (other variants are not blocked by it)
+	mutable unordered_map<string, shared_future<shared_ptr<compute_program>>> variants GUARDED_BY(variants_lock);
+	
+};
+
 #endif
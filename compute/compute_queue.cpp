@@ -19,6 +19,15 @@
 #include <floor/compute/compute_queue.hpp>
 #include <floor/core/core.hpp>
 #include <floor/compute/compute_kernel.hpp>
+#include <floor/threading/task.hpp>
+
+void compute_queue::add_completion_handler(queue_completion_handler_t&& completion_handler) const {
+	// generic fallback: block in a separate thread until all work has been executed
+	task::spawn_blocking([this, completion_handler = std::move(completion_handler)]() {
+		finish();
+		completion_handler();
+	}, "queue completion");
+}
 
 void compute_queue::start_profiling() {
 	finish();
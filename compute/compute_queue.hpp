@@ -21,6 +21,7 @@
 
 #include <string>
 #include <vector>
+#include <functional>
 #include <floor/math/vector_lib.hpp>
 #include <floor/compute/compute_kernel_arg.hpp>
 
@@ -81,6 +82,15 @@ public:
 	//! flushes all scheduled work to the associated device
 	virtual void flush() const = 0;
 	
+	//! completion handler type for "add_completion_handler"
+	using queue_completion_handler_t = function<void()>;
+	
+	//! calls "completion_handler" once all work that has been scheduled in this queue up to this point has been executed
+	//! NOTE: the handler may be called from any thread (e.g. an internal backend thread) and should return quickly
+	//! NOTE: the default implementation waits for completion (finish()) in a separate thread, backends override this
+	//!       with a native completion notification where possible
+	virtual void add_completion_handler(queue_completion_handler_t&& completion_handler) const;
+	
 	//! implementation specific queue object ptr (cl_command_queue or CUStream, both "struct _ *")
 	virtual const void* get_queue_ptr() const = 0;
 	virtual void* get_queue_ptr() = 0;
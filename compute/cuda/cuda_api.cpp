@@ -174,6 +174,9 @@ bool cuda_api_init(const bool use_internal_api) {
 	(void*&)cuda_api.launch_cooperative_kernel_multi_device = load_symbol(cuda_lib, "cuLaunchCooperativeKernelMultiDevice");
 	if(cuda_api.launch_cooperative_kernel_multi_device == nullptr) log_error("failed to retrieve function pointer for \"cuLaunchCooperativeKernelMultiDevice\"");
 	
+	// supported since CUDA 10.0 (optional, queue completion handlers fall back to a blocking wait if unavailable)
+	(void*&)cuda_api.launch_host_func = load_symbol(cuda_lib, "cuLaunchHostFunc");
+	
 	(void*&)cuda_api.link_add_data = load_symbol(cuda_lib, "cuLinkAddData_v2");
 	if(cuda_api.link_add_data == nullptr) log_error("failed to retrieve function pointer for \"cuLinkAddData_v2\"");
 	
@@ -499,6 +499,7 @@ using cu_surf_object = uint64_t;
 using cu_tex_object = uint64_t;
 using cu_tex_only_object = uint32_t;
 typedef size_t (CU_API *cu_occupancy_b2d_size)(int32_t block_size);
+typedef void (CU_API *cu_host_function)(void* user_data);
 
 // structs that can actually be filled by the user
 struct cu_array_3d_descriptor {
@@ -776,6 +777,7 @@ struct cuda_api_ptrs {
 	CU_API CU_RESULT (*launch_kernel)(cu_function f, uint32_t grid_dim_x, uint32_t grid_dim_y, uint32_t grid_dim_z, uint32_t block_dim_x, uint32_t block_dim_y, uint32_t block_dim_z, uint32_t shared_mem_bytes, const_cu_stream h_stream, void** kernel_params, void** extra);
 	CU_API CU_RESULT (*launch_cooperative_kernel)(cu_function f, uint32_t grid_dim_x, uint32_t grid_dim_y, uint32_t grid_dim_z, uint32_t block_dim_x, uint32_t block_dim_y, uint32_t block_dim_z, uint32_t shared_mem_bytes, const_cu_stream h_stream, void** kernel_params);
 	CU_API CU_RESULT (*launch_cooperative_kernel_multi_device)(cu_launch_params* launch_params, uint32_t num_devices, uint32_t flags);
+	CU_API CU_RESULT (*launch_host_func)(const_cu_stream h_stream, cu_host_function fn, void* user_data);
 	CU_API CU_RESULT (*link_add_data)(cu_link_state state, CU_JIT_INPUT_TYPE type, const void* data, size_t size, const char* name, uint32_t num_options, const CU_JIT_OPTION* options, const void* const* option_values);
 	CU_API CU_RESULT (*link_complete)(cu_link_state state, void** cubin_out, size_t* size_out);
 	CU_API CU_RESULT (*link_create)(uint32_t num_options, const CU_JIT_OPTION* options, const void* const* option_values, cu_link_state* state_out);
@@ -867,6 +869,7 @@ extern bool cuda_can_use_external_memory();
 #define cu_launch_kernel cuda_api.launch_kernel
 #define cu_launch_cooperative_kernel cuda_api.launch_cooperative_kernel
 #define cu_launch_cooperative_kernel_multi_device cuda_api.launch_cooperative_kernel_multi_device
+#define cu_launch_host_func cuda_api.launch_host_func
 #define cu_link_add_data cuda_api.link_add_data
 #define cu_link_complete cuda_api.link_complete
 #define cu_link_create cuda_api.link_create
@@ -43,6 +43,28 @@ void cuda_queue::flush() const {
 	// nop on cuda
 }
 
+static void CU_API cuda_queue_completion_handler(void* user_data) {
+	unique_ptr<compute_queue::queue_completion_handler_t> completion_handler((compute_queue::queue_completion_handler_t*)user_data);
+	(*completion_handler)();
+}
+
+void cuda_queue::add_completion_handler(queue_completion_handler_t&& completion_handler) const {
+	if (cu_launch_host_func == nullptr) {
+		compute_queue::add_completion_handler(std::move(completion_handler));
+		return;
+	}
+	
+	// host functions are executed in stream order (on an internal CUDA thread) once all previous work has completed
+	// NOTE: the handler must not make any CUDA calls (it doesn't: it only resumes/signals waiters)
+	auto handler_ptr = new queue_completion_handler_t(std::move(completion_handler));
+	CU_CALL_ERROR_EXEC(cu_launch_host_func(queue, &cuda_queue_completion_handler, handler_ptr),
+					   "failed to enqueue completion handler", {
+		// fall back to a blocking wait
+		compute_queue::add_completion_handler(std::move(*handler_ptr));
+		delete handler_ptr;
+	})
+}
+
 void cuda_queue::execute_indirect(const indirect_command_pipeline& indirect_cmd floor_unused,
 								  const uint32_t command_offset floor_unused,
 								  const uint32_t command_count floor_unused) const {
@@ -32,6 +32,7 @@ public:
 	
 	void finish() const override;
 	void flush() const override;
+	void add_completion_handler(queue_completion_handler_t&& completion_handler) const override;
 	
 	void execute_indirect(const indirect_command_pipeline& indirect_cmd,
 						  const uint32_t command_offset = 0u,
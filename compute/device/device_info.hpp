@@ -89,6 +89,12 @@ namespace device_info {
 		return (FLOOR_COMPUTE_INFO_HAS_FMA != 0);
 	}
 	
+	//! returns true if the device supports double-precision (fp64) floating point types and math functions
+	//! NOTE: for Metal and Vulkan this is false for all devices
+	constexpr bool has_double() {
+		return (FLOOR_COMPUTE_INFO_HAS_DOUBLE != 0);
+	}
+	
 	//! returns true if the device has native 64-bit atomics support
 	//! NOTE: for OpenCL this is true if cl_khr_int64_base_atomics is supported
 	//! NOTE: for CUDA this is true for all devices
@@ -309,6 +315,18 @@ namespace device_info {
 #endif
 	}
 	
+	//! when using Host-Compute (device execution), this returns the HOST_CPU_TIER value this is compiled for, returns 0 otherwise
+	//! NOTE: x86 tiers are in [1, 999], ARM tiers are in [1001, 1999] (see host_common.hpp)
+	//! NOTE: when building an archive for multiple CPU tiers, this can be used to select tier-specific code paths in hot functions,
+	//!       the best tier for the running CPU is then selected when loading the archive
+	constexpr uint32_t host_cpu_tier() {
+#if defined(FLOOR_COMPUTE_HOST_DEVICE)
+		return FLOOR_COMPUTE_INFO_HOST_CPU_TIER;
+#else
+		return 0;
+#endif
+	}
+	
 	//! returns true if images are supported by the device
 	constexpr bool has_image_support() {
 		return (FLOOR_COMPUTE_INFO_HAS_IMAGE_SUPPORT != 0);
@@ -114,6 +114,42 @@ floor_inline_always const_func float fmod(float a, float b) { return a - __built
 #endif
 floor_inline_always const_func float copysign(float a, float b) { return __builtin_copysignf(a, b); }
 
+#if !defined(FLOOR_COMPUTE_NO_DOUBLE)
+floor_inline_always const_func double sqrt(double x) { return __builtin_sqrt(x); }
+floor_inline_always const_func double fabs(double x) { return __builtin_fabs(x); }
+floor_inline_always const_func double abs(double x) { return __builtin_fabs(x); }
+floor_inline_always const_func double fmin(double a, double b) { return __builtin_fmin(a, b); }
+floor_inline_always const_func double min(double a, double b) { return __builtin_fmin(a, b); }
+floor_inline_always const_func double fmax(double a, double b) { return __builtin_fmax(a, b); }
+floor_inline_always const_func double max(double a, double b) { return __builtin_fmax(a, b); }
+floor_inline_always const_func double floor(double x) { return __builtin_floor(x); }
+floor_inline_always const_func double ceil(double x) { return __builtin_ceil(x); }
+floor_inline_always const_func double round(double x) { return __builtin_round(x); }
+floor_inline_always const_func double trunc(double x) { return __builtin_trunc(x); }
+floor_inline_always const_func double rint(double x) { return __builtin_rint(x); }
+floor_inline_always const_func double sin(double x) { return __builtin_sin(x); }
+floor_inline_always const_func double cos(double x) { return __builtin_cos(x); }
+floor_inline_always const_func double tan(double x) { return __builtin_tan(x); }
+floor_inline_always const_func double asin(double x) { return __builtin_asin(x); }
+floor_inline_always const_func double acos(double x) { return __builtin_acos(x); }
+floor_inline_always const_func double atan(double x) { return __builtin_atan(x); }
+floor_inline_always const_func double atan2(double a, double b) { return __builtin_atan2(a, b); }
+floor_inline_always const_func double sinh(double x) { return __builtin_sinh(x); }
+floor_inline_always const_func double cosh(double x) { return __builtin_cosh(x); }
+floor_inline_always const_func double tanh(double x) { return __builtin_tanh(x); }
+floor_inline_always const_func double asinh(double x) { return __builtin_asinh(x); }
+floor_inline_always const_func double acosh(double x) { return __builtin_acosh(x); }
+floor_inline_always const_func double atanh(double x) { return __builtin_atanh(x); }
+floor_inline_always const_func double fma(double a, double b, double c) { return (a * b + c); }
+floor_inline_always const_func double exp(double x) { return __builtin_exp(x); }
+floor_inline_always const_func double exp2(double x) { return __builtin_exp2(x); }
+floor_inline_always const_func double log(double x) { return __builtin_log(x); }
+floor_inline_always const_func double log2(double x) { return __builtin_log2(x); }
+floor_inline_always const_func double pow(double a, double b) { return __builtin_pow(a, b); }
+floor_inline_always const_func double fmod(double a, double b) { return a - __builtin_trunc(a / b) * b; }
+floor_inline_always const_func double copysign(double a, double b) { return __builtin_copysign(a, b); }
+#endif
+
 floor_inline_always const_func int8_t abs(int8_t x) { return __builtin_abs(x); }
 floor_inline_always const_func int16_t abs(int16_t x) { return __builtin_abs(x); }
 floor_inline_always const_func int32_t abs(int32_t x) { return __builtin_abs(x); }
@@ -133,6 +169,9 @@ floor_inline_always const_func int64_t floor_rt_min(int64_t a, int64_t b) { retu
 floor_inline_always const_func uint64_t floor_rt_min(uint64_t a, uint64_t b) { return a <= b ? a : b; }
 floor_inline_always const_func half floor_rt_min(half a, half b) { return (half)__builtin_fminf(float(a), float(b)); }
 floor_inline_always const_func float floor_rt_min(float a, float b) { return __builtin_fminf(a, b); }
+#if !defined(FLOOR_COMPUTE_NO_DOUBLE)
+floor_inline_always const_func double floor_rt_min(double a, double b) { return __builtin_fmin(a, b); }
+#endif
 floor_inline_always const_func int8_t floor_rt_max(int8_t a, int8_t b) { return a >= b ? a : b; }
 floor_inline_always const_func uint8_t floor_rt_max(uint8_t a, uint8_t b) { return a >= b ? a : b; }
 floor_inline_always const_func int16_t floor_rt_max(int16_t a, int16_t b) { return a >= b ? a : b; }
@@ -143,6 +182,9 @@ floor_inline_always const_func int64_t floor_rt_max(int64_t a, int64_t b) { retu
 floor_inline_always const_func uint64_t floor_rt_max(uint64_t a, uint64_t b) { return a >= b ? a : b; }
 floor_inline_always const_func half floor_rt_max(half a, half b) { return (half)__builtin_fmaxf(float(a), float(b)); }
 floor_inline_always const_func float floor_rt_max(float a, float b) { return __builtin_fmaxf(a, b); }
+#if !defined(FLOOR_COMPUTE_NO_DOUBLE)
+floor_inline_always const_func double floor_rt_max(double a, double b) { return __builtin_fmax(a, b); }
+#endif
 
 floor_inline_always const_func uint16_t floor_rt_clz(uint16_t x) { return __builtin_clzs(x); }
 floor_inline_always const_func uint32_t floor_rt_clz(uint32_t x) { return __builtin_clz(x); }
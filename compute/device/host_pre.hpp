@@ -191,6 +191,17 @@ floor_inline_always static std::locale locale_global(const std::locale& loc) {
 #define FLOOR_COMPUTE_INFO_HAS_FMA 0
 #define FLOOR_COMPUTE_INFO_HAS_FMA_0
 
+// all x86/arm CPUs have native fp64 support (unless explicitly disabled at compile-time)
+#if !defined(FLOOR_COMPUTE_INFO_HAS_DOUBLE)
+#if !defined(FLOOR_COMPUTE_NO_DOUBLE)
+#define FLOOR_COMPUTE_INFO_HAS_DOUBLE 1
+#define FLOOR_COMPUTE_INFO_HAS_DOUBLE_1
+#else
+#define FLOOR_COMPUTE_INFO_HAS_DOUBLE 0
+#define FLOOR_COMPUTE_INFO_HAS_DOUBLE_0
+#endif
+#endif
+
 // these are always set, as all targets (x86/arm) should/must support these
 #define FLOOR_COMPUTE_INFO_HAS_64_BIT_ATOMICS 1
 #define FLOOR_COMPUTE_INFO_HAS_64_BIT_ATOMICS_1
@@ -60,7 +60,8 @@ public:
 		//! IDs/sizes for this instance
 		instance_ids_t ids;
 		//! available function name -> function pointer map
-		flat_map<string, const void*> functions;
+		//! NOTE: binaries can contain many functions -> hashed lookup
+		flat_map<string, const void*, FLAT_MAP_POLICY::HASHED> functions;
 		
 		//! resets this instance to its initial state (so it can be executed again)
 		void reset(const uint3& global_work_size,
@@ -44,6 +44,11 @@
 #include <cpuid.h>
 #endif
 
+#if defined(__aarch64__) && defined(__LINUX__)
+#include <sys/auxv.h>
+#include <asm/hwcap.h>
+#endif
+
 #if defined(__WINDOWS__)
 #include <floor/core/platform_windows.hpp>
 #include <winreg.h>
@@ -232,8 +237,28 @@ host_compute::host_compute() : compute_context() {
 			break;
 	}
 	
+#elif defined(__LINUX__)
+	// figure out the supported ARMv8.x ISA via the HWCAP features that were introduced with each version
+	// NOTE: all tiers above 1 also require FP16 support
+	const auto hwcap = getauxval(AT_HWCAP);
+	const auto has_hwcap = [&hwcap](const unsigned long caps) {
+		return ((hwcap & caps) == caps);
+	};
+	device.cpu_tier = HOST_CPU_TIER::ARM_TIER_1;
+	if (has_hwcap(HWCAP_FPHP | HWCAP_ASIMDHP | HWCAP_ATOMICS | HWCAP_ASIMDRDM)) {
+		device.cpu_tier = HOST_CPU_TIER::ARM_TIER_2;
+		if (has_hwcap(HWCAP_DCPOP)) {
+			device.cpu_tier = HOST_CPU_TIER::ARM_TIER_3;
+			if (has_hwcap(HWCAP_JSCVT | HWCAP_FCMA | HWCAP_LRCPC)) {
+				device.cpu_tier = HOST_CPU_TIER::ARM_TIER_4;
+				if (has_hwcap(HWCAP_DIT | HWCAP_USCAT | HWCAP_ILRCPC | HWCAP_FLAGM)) {
+					device.cpu_tier = HOST_CPU_TIER::ARM_TIER_5;
+				}
+			}
+		}
+	}
 #else
-	// TODO: handle this on non-Apple platforms
+	// TODO: handle this on other non-Apple platforms
 	device.cpu_tier = HOST_CPU_TIER::ARM_TIER_1;
 #endif
 #else
@@ -43,15 +43,7 @@
 #include <floor/core/timer.hpp>
 #endif
 
-#if defined(__APPLE__)
-#include <mach/thread_policy.h>
-#include <mach/thread_act.h>
-#elif defined(__linux__) || defined(__FreeBSD__)
-#include <pthread.h>
-#if defined(__FreeBSD__)
-#include <pthread_np.h>
-#endif
-#endif
+#include <floor/threading/task.hpp>
 
 #if !defined(_WIN32)
 // sanity check (mostly necessary on os x where some fool had the idea to make the size of ucontext_t define dependent)
@@ -592,25 +584,6 @@ static_assert(offsetof(fiber_context, main_ctx) == 200);
 static_assert(offsetof(fiber_context, init_arg) == 208);
 #endif
 
-// thread affinity handling
-static void floor_set_thread_affinity(const uint32_t& affinity) {
-#if defined(__APPLE__)
-	thread_port_t thread_port = pthread_mach_thread_np(pthread_self());
-	thread_affinity_policy thread_affinity { int(affinity) };
-	thread_policy_set(thread_port, THREAD_AFFINITY_POLICY, (thread_policy_t)&thread_affinity, THREAD_AFFINITY_POLICY_COUNT);
-#elif defined(__linux__) || defined(__FreeBSD__)
-	// use gnu extension
-	cpu_set_t cpu_set;
-	CPU_ZERO(&cpu_set);
-	CPU_SET(affinity - 1, &cpu_set);
-	pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &cpu_set);
-#elif defined(__OpenBSD__)
-	// TODO: pthread gnu extension not available here
-#elif defined(__WINDOWS__)
-	SetThreadAffinityMask(GetCurrentThread(), 1u << (affinity - 1u));
-#endif
-}
-
 // id handling vars
 uint32_t floor_work_dim { 1u };
 uint3 floor_global_work_size;
@@ -1042,91 +1015,81 @@ void host_kernel::execute_host(const uint32_t& cpu_count, const uint3& group_dim
 #if defined(FLOOR_HOST_KERNEL_ENABLE_TIMING)
 	const auto time_start = floor_timer::start();
 #endif
-	vector<unique_ptr<thread>> worker_threads(cpu_count);
-	for(uint32_t cpu_idx = 0; cpu_idx < cpu_count; ++cpu_idx) {
-		worker_threads[cpu_idx] = make_unique<thread>([this, cpu_idx,
-													   &group_idx, group_count, group_dim,
-													   local_size, local_dim] {
-			// set cpu affinity for this thread to a particular cpu to prevent this thread from being constantly moved/scheduled
-			// on different cpus (starting at index 1, with 0 representing no affinity)
-			floor_set_thread_affinity(cpu_idx + 1);
+	// one task per cpu (i.e. per local memory/stack slot), each task works on groups until all are done
+	task::parallel_for(0, cpu_count, [this, &group_idx, group_count, group_dim, local_size, local_dim](const size_t cpu_idx_) {
+		const auto cpu_idx = uint32_t(cpu_idx_);
+			
+		// set the tls thread index for this (needed to compute local memory offsets)
+		floor_thread_idx = cpu_idx;
+		floor_thread_local_memory_offset = cpu_idx * floor_local_memory_max_size;
 			
-			// set the tls thread index for this (needed to compute local memory offsets)
-			floor_thread_idx = cpu_idx;
-			floor_thread_local_memory_offset = cpu_idx * floor_local_memory_max_size;
+		// init contexts (aka fibers)
+		fiber_context main_ctx;
+		main_ctx.init(nullptr, 0, nullptr, ~0u, nullptr, nullptr);
+		auto items = make_unique<fiber_context[]>(local_size);
+		item_contexts = items.get();
+			
+		// init fibers
+		for(uint32_t i = 0; i < local_size; ++i) {
+			items[i].init(&floor_stack_memory_data.get()[(i + local_size * cpu_idx) * fiber_context::min_stack_size],
+						  fiber_context::min_stack_size,
+						  run_mt_group_item, i,
+						  // continue with next on return, or return to main ctx when the last item returns
+						  // TODO: add option to use randomized order?
+						  (i + 1 < local_size ? &items[i + 1] : &main_ctx),
+						  &main_ctx);
+		}
+		
+		for(;;) {
+			// assign a new group to this thread/cpu and check if we're done
+			const auto group_linear_idx = group_idx++;
+			if(group_linear_idx >= group_count) break;
 			
-			// init contexts (aka fibers)
-			fiber_context main_ctx;
-			main_ctx.init(nullptr, 0, nullptr, ~0u, nullptr, nullptr);
-			auto items = make_unique<fiber_context[]>(local_size);
-			item_contexts = items.get();
+			// setup group
+			const uint3 group_id {
+				group_linear_idx % group_dim.x,
+				(group_linear_idx / group_dim.x) % group_dim.y,
+				group_linear_idx / (group_dim.x * group_dim.y)
+			};
+			floor_group_idx = group_id;
 			
-			// init fibers
+			// reset fibers
 			for(uint32_t i = 0; i < local_size; ++i) {
-				items[i].init(&floor_stack_memory_data.get()[(i + local_size * cpu_idx) * fiber_context::min_stack_size],
-							  fiber_context::min_stack_size,
-							  run_mt_group_item, i,
-							  // continue with next on return, or return to main ctx when the last item returns
-							  // TODO: add option to use randomized order?
-							  (i + 1 < local_size ? &items[i + 1] : &main_ctx),
-							  &main_ctx);
+				items[i].reset();
 			}
-			
-			for(;;) {
-				// assign a new group to this thread/cpu and check if we're done
-				const auto group_linear_idx = group_idx++;
-				if(group_linear_idx >= group_count) break;
-				
-				// setup group
-				const uint3 group_id {
-					group_linear_idx % group_dim.x,
-					(group_linear_idx / group_dim.x) % group_dim.y,
-					group_linear_idx / (group_dim.x * group_dim.y)
-				};
-				floor_group_idx = group_id;
-				
-				// reset fibers
-				for(uint32_t i = 0; i < local_size; ++i) {
-					items[i].reset();
-				}
 #if defined(FLOOR_DEBUG)
-				unfinished_items = local_size;
+			unfinished_items = local_size;
 #endif
+			
+			// run fibers/work-items for this group
+			static thread_local volatile bool done;
+			done = false;
+			main_ctx.get_context();
+			if(!done) {
+				done = true;
 				
-				// run fibers/work-items for this group
-				static thread_local volatile bool done;
-				done = false;
-				main_ctx.get_context();
-				if(!done) {
-					done = true;
-					
-					// start first fiber
-					items[0].set_context();
-				}
-				
-				// exit due to excessive local memory allocation?
-				if(local_memory_exceeded) {
-					log_error("exceeded local memory allocation in kernel \"$\" - requested $ bytes, limit is $ bytes",
-							  func_name, local_memory_alloc_offset, floor_local_memory_max_size);
-					break;
-				}
+				// start first fiber
+				items[0].set_context();
+			}
+			
+			// exit due to excessive local memory allocation?
+			if(local_memory_exceeded) {
+				log_error("exceeded local memory allocation in kernel \"$\" - requested $ bytes, limit is $ bytes",
+						  func_name, local_memory_alloc_offset, floor_local_memory_max_size);
+				break;
+			}
 				
-				// check if any items are still unfinished (in a valid program, all must be finished at this point)
-				// NOTE: this won't detect all barrier misuses, doing so would require *a lot* of work
+			// check if any items are still unfinished (in a valid program, all must be finished at this point)
+			// NOTE: this won't detect all barrier misuses, doing so would require *a lot* of work
 #if defined(FLOOR_DEBUG)
-				if(unfinished_items > 0) {
-					log_error("barrier misuse detected in kernel \"$\" - $ unfinished items in group $",
-							  func_name, unfinished_items, group_id);
-					break;
-				}
-#endif
+			if(unfinished_items > 0) {
+				log_error("barrier misuse detected in kernel \"$\" - $ unfinished items in group $",
+						  func_name, unfinished_items, group_id);
+				break;
 			}
-		});
-	}
-	// wait for worker threads to finish
-	for(auto& item : worker_threads) {
-		item->join();
-	}
+#endif
+		}
+	}, 1u, task_scheduler::PRIORITY::HIGH);
 #if defined(FLOOR_HOST_KERNEL_ENABLE_TIMING)
 	log_debug("kernel time: $ms", double(floor_timer::stop<chrono::microseconds>(time_start)) / 1000.0);
 #endif
@@ -1177,108 +1140,100 @@ void host_kernel::execute_device(const host_kernel_entry& func_entry,
 	const auto time_start = floor_timer::start();
 #endif
 	atomic<bool> success { true };
-	vector<unique_ptr<thread>> worker_threads(cpu_count);
-	for (uint32_t cpu_idx = 0; cpu_idx < cpu_count; ++cpu_idx) {
-		worker_threads[cpu_idx] = make_unique<thread>([this, &success, cpu_idx, &func_entry, &vptr_args,
-													   &group_idx, group_count, group_dim,
-													   local_size, local_dim, work_dim] {
-			// set cpu affinity for this thread to a particular cpu to prevent this thread from being constantly moved/scheduled
-			// on different cpus (starting at index 1, with 0 representing no affinity)
-			floor_set_thread_affinity(cpu_idx + 1);
+	// one task per cpu (i.e. per instance and local memory/stack slot), each task works on groups until all are done
+	task::parallel_for(0, cpu_count, [this, &success, &func_entry, &vptr_args,
+									  &group_idx, group_count, group_dim,
+									  local_size, local_dim, work_dim](const size_t cpu_idx_) {
+		const auto cpu_idx = uint32_t(cpu_idx_);
 			
-			// retrieve the instance for this CPU + reset/init it
-			auto instance = func_entry.program->get_instance(cpu_idx);
-			if (!instance) {
-				log_error("no instance for CPU #$", cpu_idx);
-				success = false;
-				return;
-			}
-			instance->reset(local_dim * group_dim, local_dim, group_dim, work_dim);
-			device_exec_context.ids = &instance->ids;
-			auto& ids = instance->ids;
+		// retrieve the instance for this CPU + reset/init it
+		auto instance = func_entry.program->get_instance(cpu_idx);
+		if (!instance) {
+			log_error("no instance for CPU #$", cpu_idx);
+			success = false;
+			return;
+		}
+		instance->reset(local_dim * group_dim, local_dim, group_dim, work_dim);
+		device_exec_context.ids = &instance->ids;
+		auto& ids = instance->ids;
 			
-			// get and set the (kernel) function for this instance
-			const auto& func_info = *func_entry.info;
-			const auto func_iter = instance->functions.find(func_info.name);
-			if (func_iter == instance->functions.end()) {
-				log_error("failed to find function \"$\" for CPU #$", func_name, cpu_idx);
-				success = false;
-				return;
-			}
-			const auto func_ptr = (const kernel_func_type)const_cast<void*>(func_iter->second);
-			device_exec_context.kernel_func = make_callable_kernel_function(func_ptr, vptr_args);
-			if (!device_exec_context.kernel_func) {
-				log_error("failed to create kernel function for CPU #$", cpu_idx);
-				success = false;
-				return;
+		// get and set the (kernel) function for this instance
+		const auto& func_info = *func_entry.info;
+		const auto func_iter = instance->functions.find(func_info.name);
+		if (func_iter == instance->functions.end()) {
+			log_error("failed to find function \"$\" for CPU #$", func_name, cpu_idx);
+			success = false;
+			return;
+		}
+		const auto func_ptr = (const kernel_func_type)const_cast<void*>(func_iter->second);
+		device_exec_context.kernel_func = make_callable_kernel_function(func_ptr, vptr_args);
+		if (!device_exec_context.kernel_func) {
+			log_error("failed to create kernel function for CPU #$", cpu_idx);
+			success = false;
+			return;
+		}
+		
+		// init contexts (aka fibers)
+		fiber_context main_ctx;
+		main_ctx.init(nullptr, 0, nullptr, ~0u, nullptr, nullptr);
+		auto items = make_unique<fiber_context[]>(local_size);
+		item_contexts = items.get();
+		
+		// init fibers
+		for (uint32_t i = 0; i < local_size; ++i) {
+			items[i].init(&floor_stack_memory_data.get()[(i + local_size * cpu_idx) * fiber_context::min_stack_size],
+						  fiber_context::min_stack_size,
+						  run_host_device_group_item, i,
+						  // continue with next on return, or return to main ctx when the last item returns
+						  (i + 1 < local_size ? &items[i + 1] : &main_ctx),
+						  &main_ctx);
+		}
+		
+		for (; success;) {
+			// assign a new group to this thread/cpu and check if we're done
+			const auto group_linear_idx = group_idx++;
+			if (group_linear_idx >= group_count) {
+				break;
 			}
 			
-			// init contexts (aka fibers)
-			fiber_context main_ctx;
-			main_ctx.init(nullptr, 0, nullptr, ~0u, nullptr, nullptr);
-			auto items = make_unique<fiber_context[]>(local_size);
-			item_contexts = items.get();
+			// setup group
+			const uint3 group_id {
+				group_linear_idx % group_dim.x,
+				(group_linear_idx / group_dim.x) % group_dim.y,
+				group_linear_idx / (group_dim.x * group_dim.y)
+			};
+			ids.instance_group_idx = group_id;
 			
-			// init fibers
-			for (uint32_t i = 0; i < local_size; ++i) {
-				items[i].init(&floor_stack_memory_data.get()[(i + local_size * cpu_idx) * fiber_context::min_stack_size],
-							  fiber_context::min_stack_size,
-							  run_host_device_group_item, i,
-							  // continue with next on return, or return to main ctx when the last item returns
-							  (i + 1 < local_size ? &items[i + 1] : &main_ctx),
-							  &main_ctx);
+			// reset fibers
+			for(uint32_t i = 0; i < local_size; ++i) {
+				items[i].reset();
 			}
-			
-			for (; success;) {
-				// assign a new group to this thread/cpu and check if we're done
-				const auto group_linear_idx = group_idx++;
-				if (group_linear_idx >= group_count) {
-					break;
-				}
-				
-				// setup group
-				const uint3 group_id {
-					group_linear_idx % group_dim.x,
-					(group_linear_idx / group_dim.x) % group_dim.y,
-					group_linear_idx / (group_dim.x * group_dim.y)
-				};
-				ids.instance_group_idx = group_id;
-				
-				// reset fibers
-				for(uint32_t i = 0; i < local_size; ++i) {
-					items[i].reset();
-				}
 #if defined(FLOOR_DEBUG)
-				unfinished_items = local_size;
+			unfinished_items = local_size;
 #endif
+			
+			// run fibers/work-items for this group
+			static thread_local volatile bool done;
+			done = false;
+			main_ctx.get_context();
+			if(!done) {
+				done = true;
 				
-				// run fibers/work-items for this group
-				static thread_local volatile bool done;
-				done = false;
-				main_ctx.get_context();
-				if(!done) {
-					done = true;
-					
-					// start first fiber
-					items[0].set_context();
-				}
-				
-				// check if any items are still unfinished (in a valid program, all must be finished at this point)
-				// NOTE: this won't detect all barrier misuses, doing so would require *a lot* of work
+				// start first fiber
+				items[0].set_context();
+			}
+			
+			// check if any items are still unfinished (in a valid program, all must be finished at this point)
+			// NOTE: this won't detect all barrier misuses, doing so would require *a lot* of work
 #if defined(FLOOR_DEBUG)
-				if (unfinished_items > 0) {
-					log_error("barrier misuse detected in kernel \"$\" - $ unfinished items in group $",
-							  func_name, unfinished_items, group_id);
-					break;
-				}
-#endif
+			if (unfinished_items > 0) {
+				log_error("barrier misuse detected in kernel \"$\" - $ unfinished items in group $",
+						  func_name, unfinished_items, group_id);
+				break;
 			}
-		});
-	}
-	// wait for worker threads to finish
-	for(auto& item : worker_threads) {
-		item->join();
-	}
+#endif
+		}
+	}, 1u, task_scheduler::PRIORITY::HIGH);
 }
 
 extern "C" void run_host_device_group_item(const uint32_t local_linear_idx) {
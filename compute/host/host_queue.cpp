@@ -31,6 +31,11 @@ void host_queue::flush() const {
 	// nop
 }
 
+void host_queue::add_completion_handler(queue_completion_handler_t&& completion_handler) const {
+	// all Host-Compute work is executed synchronously -> everything that has been scheduled has already been executed
+	completion_handler();
+}
+
 void host_queue::execute_indirect(const indirect_command_pipeline& indirect_cmd floor_unused,
 								  const uint32_t command_offset floor_unused,
 								  const uint32_t command_count floor_unused) const {
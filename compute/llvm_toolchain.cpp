@@ -18,8 +18,12 @@
 
 #include <floor/compute/llvm_toolchain.hpp>
 #include <floor/floor/floor.hpp>
+#include <floor/constexpr/sha_256.hpp>
+#include <floor/threading/thread_safety.hpp>
+#include <floor/core/timer.hpp>
 #include <regex>
 #include <climits>
+#include <cstdio>
 
 #include <floor/compute/opencl/opencl_device.hpp>
 #include <floor/compute/cuda/cuda_device.hpp>
@@ -213,11 +217,276 @@ program_data compile_precompiled_header(const string& pch_output_file_name,
 	return compile_input("", "", device, options, true);
 }
 
+//! returns the toolchain base path for the specified target
+static const string& get_toolchain_base_path(const TARGET target) {
+	switch (target) {
+		case TARGET::SPIR:
+		case TARGET::SPIRV_OPENCL:
+			return floor::get_opencl_base_path();
+		case TARGET::PTX:
+			return floor::get_cuda_base_path();
+		case TARGET::AIR:
+			return floor::get_metal_base_path();
+		case TARGET::SPIRV_VULKAN:
+			return floor::get_vulkan_base_path();
+		case TARGET::HOST_COMPUTE_CPU:
+			return floor::get_host_base_path();
+	}
+	floor_unreachable();
+}
+
+//! returns the file name of the cached pch for the specified "pch_key" (all flags/defines that influence the pch),
+//! the pch is built first if it doesn't exist yet or if "rebuild" is set
+//! NOTE: returns an empty string if the pch could not be built
+static string get_cached_pch(const string& pch_key,
+							 const compute_device& device,
+							 const compile_options& options,
+							 const bool rebuild) {
+	// NOTE: this serializes pch creation within this process, so that concurrent compilations don't build the same pch
+	static safe_mutex cached_pch_lock;
+	
+	const auto key_hash = sha_256::compute_hash((const uint8_t*)pch_key.data(), pch_key.size());
+	stringstream pch_path_sstr;
+	pch_path_sstr << get_toolchain_base_path(options.target) << "/pch/";
+	const auto pch_dir = pch_path_sstr.str();
+	pch_path_sstr << "rt_" << key_hash << ".pch";
+	const auto pch_path = pch_path_sstr.str();
+	
+	GUARD(cached_pch_lock);
+	if (!rebuild && file_io::is_file(pch_path)) {
+		return pch_path;
+	}
+	if (!file_io::is_directory(pch_dir) && !file_io::create_directory(pch_dir)) {
+		return {};
+	}
+	
+	// build into a temporary file in the same directory first, then move it into place,
+	// so that other processes never see a partially written pch
+	// NOTE: defines are not part of the pch key and must not be baked into the shared pch
+	//       (all variants of a specializable program share it, but use different defines)
+	auto pch_options = options;
+	pch_options.defines.clear();
+	const auto tmp_pch_path = pch_dir + core::strip_filename(core::create_tmp_file_name("rt_", ".pch.tmp"));
+	const auto pch = compile_precompiled_header(tmp_pch_path, device, pch_options);
+	if (!pch.valid) {
+		log_error("failed to build cached pch $", pch_path);
+		std::remove(tmp_pch_path.c_str());
+		return {};
+	}
+	if (std::rename(tmp_pch_path.c_str(), pch_path.c_str()) != 0) {
+		log_error("failed to move cached pch to $", pch_path);
+		std::remove(tmp_pch_path.c_str());
+		return {};
+	}
+	return pch_path;
+}
+
+//! returns "arg" quoted/escaped so that it is passed verbatim as a single argument through the shell
+static string shell_escape_arg(const string& arg) {
+#if !defined(__WINDOWS__)
+	// single quotes: everything is literal, except for single quotes themselves -> close, escape, reopen
+	string ret = "'";
+	for (const auto& ch : arg) {
+		if (ch == '\'') {
+			ret += "'\\''";
+		} else {
+			ret += ch;
+		}
+	}
+	return ret + "'";
+#else
+	string ret = "\"";
+	for (const auto& ch : arg) {
+		if (ch == '\"') {
+			ret += "\\\"";
+		} else {
+			ret += ch;
+		}
+	}
+	return ret + "\"";
+#endif
+}
+
+//! returns true if the compilation output indicates that the used pch is out-of-date/incompatible
+static bool is_pch_out_of_date(const string& compilation_output) {
+	return (compilation_output.find("precompiled header") != string::npos ||
+			compilation_output.find("PCH file") != string::npos);
+}
+
+const char* target_to_string(const TARGET target) {
+	switch (target) {
+		case TARGET::SPIR: return "SPIR";
+		case TARGET::PTX: return "PTX";
+		case TARGET::AIR: return "AIR";
+		case TARGET::SPIRV_VULKAN: return "SPIRV_VULKAN";
+		case TARGET::SPIRV_OPENCL: return "SPIRV_OPENCL";
+		case TARGET::HOST_COMPUTE_CPU: return "HOST_COMPUTE_CPU";
+	}
+	floor_unreachable();
+}
+
+json::json_value compile_report::to_json() const {
+	using namespace json;
+	json_value ret(json_value::VALUE_TYPE::OBJECT);
+	auto& members = ret.object.members;
+	members.insert_or_assign("target", json_value(string(target_to_string(target))));
+	members.insert_or_assign("device", json_value(device_name));
+	members.insert_or_assign("compile_time_ms", json_value(compile_time_ms));
+	members.insert_or_assign("binary_size", json_value(binary_size));
+	
+	json_value funcs(json_value::VALUE_TYPE::ARRAY);
+	for (const auto& func : functions) {
+		json_value func_obj(json_value::VALUE_TYPE::OBJECT);
+		auto& func_members = func_obj.object.members;
+		func_members.insert_or_assign("name", json_value(func.name));
+		if (func.code_size) {
+			func_members.insert_or_assign("code_size", json_value(*func.code_size));
+		}
+		if (func.stack_size) {
+			func_members.insert_or_assign("stack_size", json_value(*func.stack_size));
+		}
+		if (func.registers) {
+			func_members.insert_or_assign("registers", json_value(uint64_t(*func.registers)));
+		}
+		funcs.array.values.emplace_back(move(func_obj));
+	}
+	members.insert_or_assign("functions", funcs);
+	
+	json_value warns(json_value::VALUE_TYPE::ARRAY);
+	for (const auto& warning : warnings) {
+		warns.array.values.emplace_back(warning);
+	}
+	members.insert_or_assign("warnings", warns);
+	return ret;
+}
+
+//! returns the function report entry for "name" in "report", creating it if it doesn't exist yet
+static compile_report::function_report& get_function_report(compile_report& report, const string& name) {
+	for (auto& func : report.functions) {
+		if (func.name == name) {
+			return func;
+		}
+	}
+	report.functions.emplace_back(compile_report::function_report { .name = name });
+	return report.functions.back();
+}
+
+//! reads the sizes of all functions (code symbols) from the specified ELF64 binary
+//! NOTE: this only reads the section headers and symbol table, the binary is not otherwise validated (see elf_binary)
+static void add_elf_function_sizes(compile_report& report, const uint8_t* elf, const size_t elf_size) {
+	const auto read = [&elf, &elf_size]<typename T>(const uint64_t offset, T& val) {
+		if (offset + sizeof(T) > elf_size) {
+			return false;
+		}
+		memcpy(&val, elf + offset, sizeof(T));
+		return true;
+	};
+	if (elf_size < 64u || memcmp(elf, "\x7F" "ELF", 4) != 0 || elf[4] != 2 /* 64-bit */) {
+		return;
+	}
+	uint64_t sh_offset = 0;
+	uint16_t sh_entry_size = 0, sh_count = 0;
+	if (!read(0x28, sh_offset) || !read(0x3A, sh_entry_size) || !read(0x3C, sh_count) || sh_entry_size < 64u) {
+		return;
+	}
+	for (uint32_t sec_idx = 0; sec_idx < sh_count; ++sec_idx) {
+		const auto sec_hdr = sh_offset + uint64_t(sec_idx) * sh_entry_size;
+		uint32_t sec_type = 0, sec_link = 0;
+		uint64_t sym_offset = 0, sym_size = 0, sym_entry_size = 0;
+		if (!read(sec_hdr + 0x04, sec_type) || sec_type != 2u /* symbol table */) {
+			continue;
+		}
+		if (!read(sec_hdr + 0x18, sym_offset) || !read(sec_hdr + 0x20, sym_size) ||
+			!read(sec_hdr + 0x28, sec_link) || !read(sec_hdr + 0x38, sym_entry_size) ||
+			sym_entry_size < 24u || sec_link >= sh_count) {
+			return;
+		}
+		uint64_t str_offset = 0, str_size = 0;
+		const auto str_hdr = sh_offset + uint64_t(sec_link) * sh_entry_size;
+		if (!read(str_hdr + 0x18, str_offset) || !read(str_hdr + 0x20, str_size) || str_offset + str_size > elf_size) {
+			return;
+		}
+		for (uint64_t sym = sym_offset; sym + sym_entry_size <= sym_offset + sym_size; sym += sym_entry_size) {
+			uint32_t name_offset = 0;
+			uint8_t sym_info = 0;
+			uint64_t code_size = 0;
+			if (!read(sym, name_offset) || !read(sym + 4, sym_info) || !read(sym + 16, code_size)) {
+				return;
+			}
+			// only consider code symbols with a known size
+			if ((sym_info & 0xFu) != 2u || code_size == 0 || name_offset >= str_size) {
+				continue;
+			}
+			const auto name_ptr = (const char*)elf + str_offset + name_offset;
+			const string name(name_ptr, strnlen(name_ptr, str_size - name_offset));
+			get_function_report(report, name).code_size = code_size;
+		}
+	}
+}
+
+//! parses a stack usage file as emitted by -fstack-usage ("<file>:<line>:<col>:<function>\t<size>\t<qualifiers>")
+static void add_stack_usage(compile_report& report, const string& su_file_name) {
+	string su_data;
+	if (!file_io::file_to_string(su_file_name, su_data)) {
+		return;
+	}
+	for (const auto& line : core::tokenize(su_data, '\n')) {
+		const auto fields = core::tokenize(line, '\t');
+		if (fields.size() < 2) {
+			continue;
+		}
+		const auto name_pos = fields[0].rfind(':');
+		const auto name = (name_pos != string::npos ? fields[0].substr(name_pos + 1) : fields[0]);
+		if (name.empty()) {
+			continue;
+		}
+		get_function_report(report, name).stack_size = strtoull(fields[1].c_str(), nullptr, 10);
+	}
+}
+
+//! parses the generated PTX code for per-function local memory depot sizes and virtual register counts
+static void add_ptx_function_info(compile_report& report, const string& ptx_code) {
+	static const regex rx_func_start(R"(^\s*(?:\.visible\s+|\.weak\s+)?(?:\.entry|\.func(?:\s*\([^)]*\))?)\s+([A-Za-z_$%][\w$]*))");
+	static const regex rx_local_depot(R"(\.local\s+\.align\s+\d+\s+\.b8\s+__local_depot\d+\[(\d+)\])");
+	static const regex rx_reg_decl(R"(\.reg\s+\.\w+\s+%\w+<(\d+)>)");
+	compile_report::function_report* cur_func = nullptr;
+	smatch match;
+	for (const auto& line : core::tokenize(ptx_code, '\n')) {
+		if (regex_search(line, match, rx_func_start)) {
+			cur_func = &get_function_report(report, match[1]);
+			cur_func->registers = 0u;
+			continue;
+		}
+		if (cur_func == nullptr) {
+			continue;
+		}
+		if (regex_search(line, match, rx_local_depot)) {
+			cur_func->stack_size = stoull(match[1]);
+		} else if (regex_search(line, match, rx_reg_decl)) {
+			*cur_func->registers += uint32_t(stoul(match[1]));
+		} else if (!line.empty() && line[0] == '}') {
+			cur_func = nullptr;
+		}
+	}
+}
+
+//! adds all register allocator spill remarks (-Rpass-missed=regalloc) from the compilation output as warnings
+static void add_spill_remarks(compile_report& report, const string& compilation_output) {
+	for (const auto& line : core::tokenize(compilation_output, '\n')) {
+		if (line.find("remark: ") != string::npos && line.find(" spills ") != string::npos) {
+			report.warnings.emplace_back(core::trim(line));
+		}
+	}
+}
+
 program_data compile_input(const string& input,
 						   const string& cmd_prefix,
 						   const compute_device& device,
 						   const compile_options options,
 						   const bool build_pch) {
+	const auto compile_start = floor_timer::start();
+	const bool emit_report = (options.report && !build_pch);
+	
 	// create the initial clang compilation command
 	string clang_cmd = cmd_prefix;
 	string libcxx_path, clang_path, floor_path;
@@ -230,6 +499,7 @@ program_data compile_input(const string& input,
 	const bool metal_preprocess = (options.target == TARGET::AIR && options.debug.preprocess_condense);
 	bool primitive_id_support = device.primitive_id_support;
 	bool barycentric_coord_support = device.barycentric_coord_support;
+	bool double_support = device.double_support;
 	switch (options.target) {
 		case TARGET::SPIR:
 			toolchain_version = floor::get_opencl_toolchain_version();
@@ -262,6 +532,7 @@ program_data compile_input(const string& input,
 		case TARGET::AIR: {
 			toolchain_version = floor::get_metal_toolchain_version();
 			output_file_type = "metallib";
+			double_support = false;
 			
 			const auto& mtl_dev = (const metal_device&)device;
 			auto metal_version = mtl_dev.metal_language_version;
@@ -457,6 +728,7 @@ program_data compile_input(const string& input,
 		case TARGET::SPIRV_VULKAN: {
 			toolchain_version = floor::get_vulkan_toolchain_version();
 			output_file_type = "spvc";
+			double_support = false; // not supported yet (see below)
 			
 			const auto& vk_device = (const vulkan_device&)device;
 			string vulkan_std = "vulkan1.2";
@@ -602,9 +874,7 @@ program_data compile_input(const string& input,
 				prefer_vec_width +
 				" -mcmodel=large" +
 				" -DFLOOR_COMPUTE_HOST_DEVICE -DFLOOR_COMPUTE_HOST" +
-				// TODO/NOTE: for now, doubles are not supported
-				//(!device.double_support ? " -DFLOOR_COMPUTE_NO_DOUBLE" : "")
-				" -DFLOOR_COMPUTE_NO_DOUBLE"
+				(!double_support ? " -DFLOOR_COMPUTE_NO_DOUBLE" : "") +
 				" -fno-stack-protector"
 			};
 			libcxx_path += floor::get_host_base_path() + "libcxx";
@@ -613,14 +883,9 @@ program_data compile_input(const string& input,
 		} break;
 	}
 	
-	// handle pch
-	string pch_include;
+	// handle pch output
 	if (build_pch) {
 		output_file_type = "pch";
-	} else {
-		if (options.pch) {
-			pch_include = " -include-pch " + *options.pch;
-		}
 	}
 	
 	// set toolchain version define
@@ -696,6 +961,11 @@ program_data compile_input(const string& input,
 	clang_cmd += " -DFLOOR_COMPUTE_INFO_HAS_FMA="s + has_fma_str;
 	clang_cmd += " -DFLOOR_COMPUTE_INFO_HAS_FMA_"s + has_fma_str;
 	
+	// double/fp64 support
+	const auto has_double_str = to_string(double_support);
+	clang_cmd += " -DFLOOR_COMPUTE_INFO_HAS_DOUBLE="s + has_double_str;
+	clang_cmd += " -DFLOOR_COMPUTE_INFO_HAS_DOUBLE_"s + has_double_str;
+	
 	// base and extended 64-bit atomics support
 	const auto has_base_64_bit_atomics_str = to_string(device.basic_64_bit_atomics_support);
 	const auto has_extended_64_bit_atomics_str = to_string(device.extended_64_bit_atomics_support);
@@ -954,13 +1224,6 @@ program_data compile_input(const string& input,
 		clang_cmd += " -DFLOOR_COMPUTE_PARAM_WORKAROUND=1";
 	}
 	
-	// floor function info
-	string function_info_file_name;
-	if (!build_pch) {
-		function_info_file_name = core::create_tmp_file_name("ffi", ".txt");
-		clang_cmd += " -Xclang -floor-function-info=" + function_info_file_name;
-	}
-	
 	// target specific compute info
 	switch(options.target) {
 		case TARGET::PTX:
@@ -978,6 +1241,13 @@ program_data compile_input(const string& input,
 			clang_cmd += " -DFLOOR_COMPUTE_INFO_VULKAN_HAS_FLOAT16_SUPPORT_"s + has_float16_support;
 			break;
 		}
+		case TARGET::HOST_COMPUTE_CPU: {
+			// set CPU tier, so that hot code can be specialized for each tier when building multi-tier archives
+			const auto cpu_tier_str = to_string(uint32_t(((const host_device&)device).cpu_tier));
+			clang_cmd += " -DFLOOR_COMPUTE_INFO_HOST_CPU_TIER="s + cpu_tier_str + "u";
+			clang_cmd += " -DFLOOR_COMPUTE_INFO_HOST_CPU_TIER_"s + cpu_tier_str;
+			break;
+		}
 		default: break;
 	}
 
@@ -1029,22 +1299,13 @@ program_data compile_input(const string& input,
 		" "
 	};
 	
-	// add generic flags/options that are always used
-	string compiled_file_or_code;
-	string include_flags {
-		" -isystem \"" + libcxx_path + "\"" +
-		" -isystem \"" + clang_path + "\"" +
-		" -isystem \"" + floor_path + "\"" +
-		" -include floor/compute/device/common.hpp" +
-		pch_include
-	};
-	clang_cmd += {
+	// generic flags/options that are always used
+	const string generic_flags {
 #if defined(FLOOR_DEBUG)
 		" -DFLOOR_DEBUG"
 #endif
 		" -DFLOOR_COMPUTE"
 		" -DFLOOR_NO_MATH_STR"s +
-		(!metal_preprocess ? include_flags : "") +
 		(options.target != TARGET::HOST_COMPUTE_CPU ? " -fno-pic" : "") +
 		" -fno-exceptions -fno-unwind-tables -fno-asynchronous-unwind-tables -fno-addrsig"
 		" -fno-rtti -fstrict-aliasing -ffast-math -funroll-loops -Ofast -ffp-contract=fast"
@@ -1065,6 +1326,48 @@ program_data compile_input(const string& input,
 		options.cli +
 		" -m64"
 	};
+	const string include_paths {
+		" -isystem \"" + libcxx_path + "\"" +
+		" -isystem \"" + clang_path + "\"" +
+		" -isystem \"" + floor_path + "\""
+	};
+	
+	// handle pch usage
+	// NOTE: a cached pch is keyed by everything that was added to the command so far (toolchain version, defines, flags)
+	//       plus the include paths, but not by the input/output files or the function info file
+	string pch_include, cached_pch_file, cached_pch_key;
+	if (!build_pch) {
+		if (options.pch) {
+			pch_include = " -include-pch " + *options.pch;
+		} else if (!metal_preprocess && (options.cached_pch ? *options.cached_pch : floor::get_toolchain_use_cache())) {
+			cached_pch_key = clang_cmd.substr(cmd_prefix.size()) + generic_flags + include_paths;
+			cached_pch_file = get_cached_pch(cached_pch_key, device, options, false);
+			if (!cached_pch_file.empty()) {
+				pch_include = " -include-pch " + cached_pch_file;
+			}
+			// else: just compile without a pch
+		}
+	}
+	
+	// add generic flags/options and include paths
+	const string include_flags {
+		include_paths +
+		" -include floor/compute/device/common.hpp" +
+		pch_include
+	};
+	clang_cmd += (!metal_preprocess ? include_flags : "") + generic_flags;
+	for (const auto& define : options.defines) {
+		clang_cmd += " " + shell_escape_arg("-D" + define.first + '=' + define.second);
+	}
+	
+	// floor function info
+	string function_info_file_name;
+	if (!build_pch) {
+		function_info_file_name = core::create_tmp_file_name("ffi", ".txt");
+		clang_cmd += " -Xclang -floor-function-info=" + function_info_file_name;
+	}
+	
+	string compiled_file_or_code;
 	if (!build_pch) {
 		compiled_file_or_code = core::create_tmp_file_name("", '.' + output_file_type);
 		if (options.target != TARGET::HOST_COMPUTE_CPU && options.target != TARGET::PTX) {
@@ -1081,6 +1384,10 @@ program_data compile_input(const string& input,
 		} else {
 			metal_debug_preprocess += " -o " + compiled_file_or_code + " " + input;
 		}
+		if (emit_report && options.target == TARGET::HOST_COMPUTE_CPU) {
+			// emit per-function stack usage (<output>.su) and register allocator spill remarks
+			clang_cmd += " -fstack-usage -Rpass-missed=regalloc";
+		}
 	} else {
 		compiled_file_or_code = *options.pch;
 		clang_cmd += " \"" + floor_path + "/floor/compute/device/common.hpp\"";
@@ -1118,6 +1425,26 @@ program_data compile_input(const string& input,
 	}
 	string compilation_output;
 	core::system(clang_cmd, compilation_output);
+	// a cached pch may be out-of-date if headers changed without a toolchain version change -> rebuild it once and retry
+	if (!cached_pch_file.empty() && is_pch_out_of_date(compilation_output)) {
+		log_warn("cached pch $ is out-of-date, rebuilding it", cached_pch_file);
+		bool use_pch = !get_cached_pch(cached_pch_key, device, options, true).empty();
+		if (use_pch) {
+			compilation_output.clear();
+			core::system(clang_cmd, compilation_output);
+			use_pch = !is_pch_out_of_date(compilation_output);
+		}
+		if (!use_pch) {
+			// the pch is only a cache -> compile without it instead of failing
+			log_warn("failed to rebuild cached pch $, compiling without it", cached_pch_file);
+			const auto pch_include_pos = clang_cmd.find(pch_include);
+			if (pch_include_pos != string::npos) {
+				clang_cmd.erase(pch_include_pos, pch_include.size());
+			}
+			compilation_output.clear();
+			core::system(clang_cmd, compilation_output);
+		}
+	}
 	// check if the output contains an error string (yes, a bit ugly, but it works for now - can't actually check the return code)
 	if(compilation_output.find(" error: ") != string::npos ||
 	   compilation_output.find(" errors:") != string::npos) {
@@ -1150,6 +1477,12 @@ program_data compile_input(const string& input,
 		compiled_file_or_code = metal_final_output_file;
 	}
 	
+	// gather compile report info that is only available in the compilation output
+	compile_report report;
+	if (emit_report) {
+		add_spill_remarks(report, compilation_output);
+	}
+	
 	// grab floor function info and create the internal per-function info
 	vector<function_info> functions;
 	if (!build_pch) {
@@ -1199,6 +1532,9 @@ program_data compile_input(const string& input,
 				log_error("PTX compilation failed!\n$", ptx_code);
 				return {};
 			}
+			if (emit_report) {
+				add_ptx_function_info(report, ptx_code);
+			}
 			compiled_file_or_code.swap(ptx_code);
 		} else if (options.target == TARGET::SPIRV_VULKAN ||
 				   options.target == TARGET::SPIRV_OPENCL) {
@@ -1234,10 +1570,36 @@ program_data compile_input(const string& input,
 			// NOTE: will cleanup the binary in opencl_compute/vulkan_compute
 		} else if (options.target == TARGET::HOST_COMPUTE_CPU) {
 			// nop, already a binary
+			if (emit_report) {
+				const auto [elf_data, elf_size] = file_io::file_to_buffer(compiled_file_or_code);
+				if (elf_data) {
+					add_elf_function_sizes(report, elf_data.get(), elf_size);
+				}
+				const auto su_file_name = compiled_file_or_code.substr(0, compiled_file_or_code.rfind('.')) + ".su";
+				add_stack_usage(report, su_file_name);
+				if (!floor::get_toolchain_keep_temp()) {
+					core::system("rm " + su_file_name);
+				}
+			}
 		}
 	}
 	
-	return { true, compiled_file_or_code, functions, options };
+	program_data ret { true, compiled_file_or_code, functions, options };
+	if (emit_report) {
+		report.target = options.target;
+		report.device_name = device.name;
+		report.compile_time_ms = floor_timer::stop<chrono::milliseconds>(compile_start);
+		if (options.target == TARGET::SPIR || options.target == TARGET::PTX) {
+			report.binary_size = compiled_file_or_code.size();
+		} else {
+			file_io binary_file(compiled_file_or_code, file_io::OPEN_TYPE::READ_BINARY);
+			if (binary_file.is_open()) {
+				report.binary_size = uint64_t(max(binary_file.get_filesize(), 0ll));
+			}
+		}
+		ret.report = move(report);
+	}
+	return ret;
 }
 
 } // llvm_toolchain
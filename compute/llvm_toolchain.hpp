@@ -21,6 +21,7 @@
 
 #include <floor/core/essentials.hpp>
 #include <floor/compute/compute_device.hpp>
+#include <floor/core/json.hpp>
 #include <memory>
 #include <optional>
 
@@ -208,6 +209,11 @@ namespace llvm_toolchain {
 		//! options that are directly passed through to the compiler
 		string cli { "" };
 		
+		//! additional macro definitions ("-D<name>=<value>") that only apply to the compiled program code,
+		//! i.e. these are not part of the cached pch key (see "cached_pch")
+		//! NOTE: this is used for program/kernel specialization
+		vector<pair<string, string>> defines;
+		
 		//! if true, enables the default set of warning flags
 		bool enable_warnings { false };
 		
@@ -272,6 +278,51 @@ namespace llvm_toolchain {
 		//! optional pre-compiled header that should be used for compilation
 		//! NOTE: the caller *must* ensure that the pch is compatible to the current compile options and the target device
 		optional<string> pch;
+		
+		//! if true and no "pch" is specified, automatically creates and uses a cached pre-compiled header
+		//! for the current target, device and compile options
+		//! NOTE: cached pchs are stored in "<toolchain base path>/pch/", keyed by the toolchain version and all defines/flags,
+		//!       and are automatically rebuilt when the compiler reports them as out-of-date
+		//! if unset, use the global floor option (toolchain.use_cache)
+		optional<bool> cached_pch;
+		
+		//! if true, gathers a compile report (compile time, binary/code size, resource usage, spill warnings)
+		//! that is stored in program_data::report (see compile_report)
+		bool report { false };
+	};
+	
+	//! compile time, code size and resource usage information of a compiled program
+	//! NOTE: resource usage is only available if the target backend provides it:
+	//!       Host-Compute: per-function code size (ELF symbols), stack usage (-fstack-usage) and register allocator spill remarks
+	//!       PTX: per-function local memory/stack usage and virtual register counts (prior to ptxas register allocation)
+	//!       all other targets: only compile time and binary size
+	struct compile_report {
+		//! per-function report information
+		struct function_report {
+			string name;
+			//! code size in bytes
+			optional<uint64_t> code_size;
+			//! stack/frame size in bytes
+			optional<uint64_t> stack_size;
+			//! number of used (PTX: virtual) registers
+			optional<uint32_t> registers;
+		};
+		
+		//! compilation target
+		TARGET target { TARGET::SPIR };
+		//! name of the device that was compiled for
+		string device_name;
+		//! total wall time of the compilation in milliseconds (including all pre- and post-processing steps)
+		uint64_t compile_time_ms { 0u };
+		//! size of the compiled binary or code in bytes
+		uint64_t binary_size { 0u };
+		//! per-function information
+		vector<function_report> functions;
+		//! any backend warnings/remarks related to code quality (e.g. register spilling)
+		vector<string> warnings;
+		
+		//! returns this report as a json object
+		json::json_value to_json() const;
 	};
 	
 	//! contains all information about a compiled compute/graphics program
@@ -288,6 +339,9 @@ namespace llvm_toolchain {
 		
 		//! the options that were used to compile this program
 		compile_options options;
+		
+		//! compile report (only set if compile_options::report is enabled)
+		optional<compile_report> report;
 	};
 	
 	//! compiles a program from a source code string
@@ -311,6 +365,9 @@ namespace llvm_toolchain {
 									vector<function_info>& functions,
 									const uint32_t toolchain_version);
 
+	//! returns the name of the specified target
+	const char* target_to_string(const TARGET target);
+
 } // llvm_toolchain
 
 #endif
@@ -34,6 +34,8 @@ public:
 	void finish() const override REQUIRES(!cmd_buffers_lock);
 	void flush() const override REQUIRES(!cmd_buffers_lock);
 	
+	void add_completion_handler(queue_completion_handler_t&& completion_handler) const override REQUIRES(!cmd_buffers_lock);
+	
 	void execute_indirect(const indirect_command_pipeline& indirect_cmd,
 						  const uint32_t command_offset = 0u,
 						  const uint32_t command_count = ~0u) const override REQUIRES(!cmd_buffers_lock);
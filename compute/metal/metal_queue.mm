@@ -64,6 +64,17 @@ void metal_queue::flush() const {
 	}
 }
 
+void metal_queue::add_completion_handler(queue_completion_handler_t&& completion_handler) const {
+	// command buffers of a queue are executed and completed in commit order -> commit an empty command buffer and
+	// call the handler from its completed handler (called on an internal Metal thread)
+	auto handler = make_shared<queue_completion_handler_t>(std::move(completion_handler));
+	id <MTLCommandBuffer> cmd_buffer = make_command_buffer();
+	[cmd_buffer addCompletedHandler:^(id <MTLCommandBuffer>) {
+		(*handler)();
+	}];
+	[cmd_buffer commit];
+}
+
 void metal_queue::execute_indirect(const indirect_command_pipeline& indirect_cmd,
 								   const uint32_t command_offset,
 								   const uint32_t command_count) const {
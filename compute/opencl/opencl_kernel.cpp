@@ -104,7 +104,7 @@ void opencl_kernel::execute(const compute_queue& cqueue,
 				"failed to execute kernel " + entry.info->name)
 	
 	if(handler->needs_param_workaround && has_tmp_buffers) {
-		task::spawn([handler, wait_evt]() {
+		task::spawn_blocking([handler, wait_evt]() {
 			CL_CALL_IGNORE(clWaitForEvents(1, &wait_evt), "waiting for kernel execution failed")
 			// NOTE: will hold onto all tmp buffers of handler until the end of this scope, then auto-destruct everything
 		}, "kernel cleanup");
@@ -33,6 +33,42 @@ void opencl_queue::flush() const {
 	clFlush(queue);
 }
 
+static void CL_CALLBACK opencl_queue_completion_handler(cl_event evt, cl_int exec_status, void* user_data) {
+	unique_ptr<compute_queue::queue_completion_handler_t> completion_handler((compute_queue::queue_completion_handler_t*)user_data);
+	if (exec_status < 0) {
+		// NOTE: still call the handler, so that nothing waits forever
+		log_error("queue execution failed: $: $", exec_status, cl_error_to_string(exec_status));
+	}
+	(*completion_handler)();
+	clReleaseEvent(evt);
+}
+
+void opencl_queue::add_completion_handler(queue_completion_handler_t&& completion_handler) const {
+	// a marker without a wait list completes once all previously enqueued commands have completed,
+	// the event callback is then called from an OpenCL implementation thread
+	cl_event marker_evt = nullptr;
+	const auto marker_err = clEnqueueMarkerWithWaitList(queue, 0, nullptr, &marker_evt);
+	if (marker_err != CL_SUCCESS) {
+		log_error("failed to enqueue completion marker: $: $", marker_err, cl_error_to_string(marker_err));
+		// fall back to a blocking wait
+		compute_queue::add_completion_handler(std::move(completion_handler));
+		return;
+	}
+	
+	auto handler_ptr = new queue_completion_handler_t(std::move(completion_handler));
+	const auto cb_err = clSetEventCallback(marker_evt, CL_COMPLETE, &opencl_queue_completion_handler, handler_ptr);
+	if (cb_err != CL_SUCCESS) {
+		log_error("failed to set completion marker callback: $: $", cb_err, cl_error_to_string(cb_err));
+		clReleaseEvent(marker_evt);
+		// fall back to a blocking wait
+		compute_queue::add_completion_handler(std::move(*handler_ptr));
+		delete handler_ptr;
+		return;
+	}
+	// make sure the marker is actually submitted (otherwise the callback might never be called)
+	clFlush(queue);
+}
+
 void opencl_queue::execute_indirect(const indirect_command_pipeline& indirect_cmd floor_unused,
 									const uint32_t command_offset floor_unused,
 									const uint32_t command_count floor_unused) const {
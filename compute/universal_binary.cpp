@@ -505,8 +505,8 @@ namespace universal_binary {
 				}
 				host_dev.simd_range = { 1, host_dev.simd_width };
 				
-				// no double support for now
-				host_dev.double_support = false;
+				// all supported CPUs have native fp64 support
+				host_dev.double_support = true;
 				
 				break;
 			}
@@ -621,9 +621,10 @@ namespace universal_binary {
 	static bool build_archive(const string& src_input,
 							  const bool is_file_input,
 							  const string& dst_archive_file_name,
-							  const llvm_toolchain::compile_options& options,
+							  const llvm_toolchain::compile_options& user_options,
 							  const vector<target>& targets_in,
-							  const bool use_precompiled_header) {
+							  const bool use_precompiled_header,
+							  const string& report_file_name) {
 		// make sure we can open the output file before we start doing anything else
 		file_io archive(dst_archive_file_name, file_io::OPEN_TYPE::WRITE_BINARY);
 		if (!archive.is_open()) {
@@ -631,6 +632,12 @@ namespace universal_binary {
 			return false;
 		}
 		
+		// enable compile reports if requested
+		auto options = user_options;
+		if (!report_file_name.empty()) {
+			options.report = true;
+		}
+		
 		// ensure targets are unique
 		unordered_set<target> unique_targets_in;
 		unique_targets_in.reserve(targets_in.size());
@@ -638,14 +645,13 @@ namespace universal_binary {
 			unique_targets_in.emplace(target);
 		}
 		
-		// create a thread pool of #logical-cpus threads that build all targets
+		// all targets are built in parallel on the global task scheduler
 		const auto target_count = unique_targets_in.size();
-		const auto compile_job_count = uint32_t(min(size_t(core::get_hw_thread_count()), target_count));
 		
-		// enqueue + sanitize targets
-		safe_mutex targets_lock;
+		// sanitize targets
 		vector<target_v2> targets;
-		deque<pair<size_t, target>> remaining_targets;
+		vector<target> build_targets;
+		build_targets.reserve(target_count);
 		auto unique_target_iter = unique_targets_in.begin();
 		for (size_t i = 0; i < target_count; ++i, ++unique_target_iter) {
 			auto target = *unique_target_iter;
@@ -671,7 +677,7 @@ namespace universal_binary {
 			}
 			
 			targets.emplace_back(target);
-			remaining_targets.emplace_back(i, target);
+			build_targets.emplace_back(target);
 		}
 		
 		safe_mutex prog_data_lock;
@@ -679,71 +685,54 @@ namespace universal_binary {
 		vector<uint32_t> targets_toolchain_version(target_count);
 		vector<sha_256::hash_t> targets_hashes(target_count);
 		
-		atomic<uint32_t> remaining_compile_jobs { compile_job_count };
 		atomic<bool> compilation_successful { true };
-		for (uint32_t i = 0; i < compile_job_count; ++i) {
-			task::spawn([&src_input, &is_file_input, &options, &use_precompiled_header,
-						 &targets_lock, &remaining_targets,
-						 &prog_data_lock, &targets_prog_data, &targets_toolchain_version, &targets_hashes,
-						 &remaining_compile_jobs,
-						 &compilation_successful]() {
-				while (compilation_successful) {
-					// get a target
-					pair<size_t, target> build_target;
-					{
-						GUARD(targets_lock);
-						if (remaining_targets.empty()) {
-							break;
-						}
-						build_target = remaining_targets[0];
-						remaining_targets.pop_front();
-					}
+		task::parallel_for(0, target_count, [&src_input, &is_file_input, &options, &use_precompiled_header,
+											 &build_targets,
+											 &prog_data_lock, &targets_prog_data, &targets_toolchain_version, &targets_hashes,
+											 &compilation_successful](const size_t target_idx) {
+			// don't start any further builds once one has failed
+			if (!compilation_successful) {
+				return;
+			}
+			const pair<size_t, target> build_target { target_idx, build_targets[target_idx] };
 					
-					// compile the target
-					auto compile_ret = compile_target(src_input, is_file_input, options, build_target.second, use_precompiled_header);
-					if (!compile_ret.success || !compile_ret.prog_data.valid) {
-						compilation_successful = false;
-						break;
-					}
+			// compile the target
+			auto compile_ret = compile_target(src_input, is_file_input, options, build_target.second, use_precompiled_header);
+			if (!compile_ret.success || !compile_ret.prog_data.valid) {
+				compilation_successful = false;
+				return;
+			}
 					
-					// TODO: cleanup binary as in opencl_compute/vulkan_compute + in general for other backends?
+			// TODO: cleanup binary as in opencl_compute/vulkan_compute + in general for other backends?
 					
-					// for SPIR-V, AIR and Host-Compute, the binary data is written as a file -> read it so we have it in memory
-					if (compile_ret.prog_data.options.target == llvm_toolchain::TARGET::SPIRV_OPENCL ||
-						compile_ret.prog_data.options.target == llvm_toolchain::TARGET::SPIRV_VULKAN ||
-						compile_ret.prog_data.options.target == llvm_toolchain::TARGET::AIR ||
-						compile_ret.prog_data.options.target == llvm_toolchain::TARGET::HOST_COMPUTE_CPU) {
-						string bin_data;
-						if (!file_io::file_to_string(compile_ret.prog_data.data_or_filename, bin_data)) {
-							compilation_successful = false;
-							break;
-						}
-						compile_ret.prog_data.data_or_filename = move(bin_data);
-					}
+			// for SPIR-V, AIR and Host-Compute, the binary data is written as a file -> read it so we have it in memory
+			if (compile_ret.prog_data.options.target == llvm_toolchain::TARGET::SPIRV_OPENCL ||
+				compile_ret.prog_data.options.target == llvm_toolchain::TARGET::SPIRV_VULKAN ||
+				compile_ret.prog_data.options.target == llvm_toolchain::TARGET::AIR ||
+				compile_ret.prog_data.options.target == llvm_toolchain::TARGET::HOST_COMPUTE_CPU) {
+				string bin_data;
+				if (!file_io::file_to_string(compile_ret.prog_data.data_or_filename, bin_data)) {
+					compilation_successful = false;
+					return;
+				}
+				compile_ret.prog_data.data_or_filename = move(bin_data);
+			}
 					
-					// compute binary hash
-					const auto binary_hash = sha_256::compute_hash((const uint8_t*)compile_ret.prog_data.data_or_filename.c_str(),
-																   compile_ret.prog_data.data_or_filename.size());
+			// compute binary hash
+			const auto binary_hash = sha_256::compute_hash((const uint8_t*)compile_ret.prog_data.data_or_filename.c_str(),
+														   compile_ret.prog_data.data_or_filename.size());
 					
-					// add to program data array
-					{
-						auto prog_data = make_unique<llvm_toolchain::program_data>();
-						*prog_data = move(compile_ret.prog_data);
+			// add to program data array
+			{
+				auto prog_data = make_unique<llvm_toolchain::program_data>();
+				*prog_data = move(compile_ret.prog_data);
 						
-						GUARD(prog_data_lock);
-						targets_prog_data[build_target.first] = move(prog_data);
-						targets_toolchain_version[build_target.first] = compile_ret.toolchain_version;
-						targets_hashes[build_target.first] = binary_hash;
-					}
-				}
-				--remaining_compile_jobs;
-			}, "build_job_" + to_string(i));
-		}
-		
-		while (remaining_compile_jobs > 0) {
-			this_thread::sleep_for(250ms);
-			this_thread::yield();
-		}
+				GUARD(prog_data_lock);
+				targets_prog_data[build_target.first] = move(prog_data);
+				targets_toolchain_version[build_target.first] = compile_ret.toolchain_version;
+				targets_hashes[build_target.first] = binary_hash;
+			}
+		}, 1u /* each target is its own chunk */);
 		
 		// check success and output validity
 		if (!compilation_successful) {
@@ -870,6 +859,23 @@ namespace universal_binary {
 		ar_stream.seekp(header_offsets_pos);
 		archive.write_block(header.offsets.data(), header.offsets.size() * sizeof(typename decltype(header.offsets)::value_type));
 		
+		// write the compile report of all targets
+		if (!report_file_name.empty()) {
+			json::json_value reports(json::json_value::VALUE_TYPE::ARRAY);
+			for (size_t i = 0; i < target_count; ++i) {
+				if (!targets_prog_data[i]->report) {
+					continue;
+				}
+				auto report = targets_prog_data[i]->report->to_json();
+				report.object.members.insert_or_assign("archive_target", json::json_value(uint64_t(targets[i].value)));
+				reports.array.values.emplace_back(move(report));
+			}
+			if (!file_io::string_to_file(report_file_name, reports.to_string())) {
+				log_error("failed to write compile report to $", report_file_name);
+				return false;
+			}
+		}
+		
 		return true;
 	}
 	
@@ -877,16 +883,43 @@ namespace universal_binary {
 								 const string& dst_archive_file_name,
 								 const llvm_toolchain::compile_options& options,
 								 const vector<target>& targets,
-								 const bool use_precompiled_header) {
-		return build_archive(src_file_name, true, dst_archive_file_name, options, targets, use_precompiled_header);
+								 const bool use_precompiled_header,
+								 const string& report_file_name) {
+		return build_archive(src_file_name, true, dst_archive_file_name, options, targets, use_precompiled_header, report_file_name);
 	}
 	
 	bool build_archive_from_memory(const string& src_code,
 								   const string& dst_archive_file_name,
 								   const llvm_toolchain::compile_options& options,
 								   const vector<target>& targets,
-								   const bool use_precompiled_header) {
-		return build_archive(src_code, false, dst_archive_file_name, options, targets, use_precompiled_header);
+								   const bool use_precompiled_header,
+								   const string& report_file_name) {
+		return build_archive(src_code, false, dst_archive_file_name, options, targets, use_precompiled_header, report_file_name);
+	}
+	
+	vector<target> create_host_cpu_tier_targets(const HOST_CPU_TIER min_tier, const HOST_CPU_TIER max_tier) {
+		const auto is_x86_tier = [](const HOST_CPU_TIER& tier) {
+			return (tier > HOST_CPU_TIER::__X86_OFFSET && tier <= HOST_CPU_TIER::X86_TIER_4);
+		};
+		const auto is_arm_tier = [](const HOST_CPU_TIER& tier) {
+			return (tier > HOST_CPU_TIER::__ARM_OFFSET && tier <= HOST_CPU_TIER::ARM_TIER_5);
+		};
+		if (min_tier > max_tier ||
+			!((is_x86_tier(min_tier) && is_x86_tier(max_tier)) || (is_arm_tier(min_tier) && is_arm_tier(max_tier)))) {
+			log_error("invalid CPU tier range: $ - $", host_cpu_tier_to_string(min_tier), host_cpu_tier_to_string(max_tier));
+			return {};
+		}
+		
+		vector<target> targets;
+		for (auto tier = uint64_t(min_tier); tier <= uint64_t(max_tier); ++tier) {
+			target host_target;
+			host_target.host.version = target_format_version;
+			host_target.host.type = COMPUTE_TYPE::HOST;
+			host_target.host.cpu_tier = HOST_CPU_TIER(tier);
+			host_target.host._unused = 0;
+			targets.emplace_back(host_target);
+		}
+		return targets;
 	}
 	
 	pair<const binary_dynamic_v2*, const target_v2>
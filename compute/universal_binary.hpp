@@ -398,17 +398,26 @@ namespace universal_binary {
 	//! builds an archive from the given source file/code, with the specified options, for the specified targets,
 	//! writing the binary output to the specified destination if successful (returns false if not),
 	//! if "use_precompiled_header" is set, a pre-compiled header will be generated and used for each target
+	//! if "report_file_name" is not empty, a compile report (see llvm_toolchain::compile_report) of all targets is written
+	//! to this file as a json array
 	//! NOTE: compile_options::target is ignored for this
 	bool build_archive_from_file(const string& src_file_name,
 								 const string& dst_archive_file_name,
 								 const llvm_toolchain::compile_options& options,
 								 const vector<target>& targets,
-								 const bool use_precompiled_header = false);
+								 const bool use_precompiled_header = false,
+								 const string& report_file_name = "");
 	bool build_archive_from_memory(const string& src_code,
 								   const string& dst_archive_file_name,
 								   const llvm_toolchain::compile_options& options,
 								   const vector<target>& targets,
-								   const bool use_precompiled_header = false);
+								   const bool use_precompiled_header = false,
+								   const string& report_file_name = "");
+	
+	//! returns Host-Compute targets for all CPU tiers in [min_tier, max_tier] (both must be either x86 or ARM tiers),
+	//! building an archive with these targets creates a multi-tier binary, from which the best tier for the running CPU
+	//! is selected at load time (see find_best_match_for_device)
+	vector<target> create_host_cpu_tier_targets(const HOST_CPU_TIER min_tier, const HOST_CPU_TIER max_tier);
 	
 	//! finds the best matching binary for the specified device inside the specified archive,
 	//! returns nullptr if no compatible binary has been found at all
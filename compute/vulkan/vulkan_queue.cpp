@@ -24,6 +24,7 @@
 #include <floor/core/logger.hpp>
 #include <floor/core/core.hpp>
 #include <floor/threading/task.hpp>
+#include <floor/threading/safe_resource_container.hpp>
 
 //! returns the debug name of the specified buffer or "unknown"
 static inline const char* cmd_buffer_name(const vulkan_command_buffer& cmd_buffer) {
@@ -55,39 +56,55 @@ struct vulkan_command_pool_t {
 	bitset<cmd_buffer_count> cmd_buffers_in_use GUARDED_BY(cmd_buffers_lock) {};
 	
 	static constexpr const uint32_t fence_count { 32 };
-	safe_mutex fence_lock;
-	array<VkFence, fence_count> fences GUARDED_BY(fence_lock) {};
-	bitset<fence_count> fences_in_use GUARDED_BY(fence_lock) {};
+	unique_ptr<safe_resource_container<VkFence, fence_count>> fences;
 	
-	//! acquire an unused fence
-	pair<VkFence, uint32_t> acquire_fence() REQUIRES(!fence_lock) {
-		for (uint32_t trial = 0, limiter = 10; trial < limiter; ++trial) {
-			{
-				GUARD(fence_lock);
-				if (!fences_in_use.all()) {
-					for (uint32_t i = 0; i < fence_count; ++i) {
-						if (!fences_in_use[i]) {
-							fences_in_use.set(i);
-							return { fences[i], i };
-						}
-					}
-					floor_unreachable();
-				}
-			}
-			this_thread::yield();
+	//! waiting longer than this for a fence to become available is reported (diagnostic only)
+	static constexpr const auto fence_acquire_warn_time { 10s };
+	
+	//! acquire an unused fence (blocks until one is released if all are in use)
+	pair<VkFence, uint32_t> acquire_fence() {
+		if (auto fence = fences->try_acquire(); fence.second != ~0u) {
+			return fence;
+		}
+		const auto wait_start = chrono::steady_clock::now();
+		auto fence = fences->acquire();
+		if (const auto wait_time = chrono::steady_clock::now() - wait_start; wait_time >= fence_acquire_warn_time) {
+			log_warn("waited $ms for a fence (all $ fences were in use)",
+					 chrono::duration_cast<chrono::milliseconds>(wait_time).count(), fence_count);
 		}
-		log_error("failed to acquire a fence");
-		return { nullptr, ~0u };
+		return fence;
 	}
 	
-	//! release a used fence again
-	void release_fence(const pair<VkFence, uint32_t>& fence) REQUIRES(!fence_lock) {
-		VK_CALL_RET(vkResetFences(dev.device, 1, &fence.first), "failed to reset fence")
-		
-		GUARD(fence_lock);
-		fences_in_use.reset(fence.second);
+	//! reset + release a used fence again
+	//! NOTE: the fence slot is always released, even if the reset fails
+	void release_fence(const pair<VkFence, uint32_t>& fence) {
+		const auto reset_err = vkResetFences(dev.device, 1, &fence.first);
+		if (reset_err != VK_SUCCESS) {
+			log_error("failed to reset fence: $: $", reset_err, vulkan_error_to_string(reset_err));
+		}
+		fences->release(fence);
 	}
 	
+	//! releases an acquired fence when going out of scope (incl. on early return or throw)
+	struct fence_release_guard {
+		vulkan_command_pool_t& pool;
+		pair<VkFence, uint32_t> fence;
+		
+		~fence_release_guard() {
+			if (fence.first != nullptr) {
+				pool.release_fence(fence);
+			}
+		}
+		
+		//! releases the fence now (no-op if it was already released)
+		void release() {
+			if (fence.first != nullptr) {
+				pool.release_fence(fence);
+				fence = { nullptr, ~0u };
+			}
+		}
+	};
+	
 	//! acquires an unused command buffer (resets an old unused one)
 	vulkan_command_buffer make_command_buffer(const char* name = nullptr) REQUIRES(!cmd_buffers_lock) {
 		GUARD(cmd_buffers_lock);
@@ -119,9 +136,7 @@ struct vulkan_command_pool_t {
 								  wait_semas, wait_sema_count, wait_stage_flags]() {
 			// must sync/lock queue
 			auto fence = acquire_fence();
-			if (fence.first == nullptr) {
-				return;
-			}
+			fence_release_guard fence_guard { *this, fence };
 			
 			const VkSubmitInfo submit_info {
 				.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO,
@@ -160,7 +175,7 @@ struct vulkan_command_pool_t {
 			}
 			
 			// reset + release fence
-			release_fence(fence);
+			fence_guard.release();
 			
 			// call user-specified handler
 			if (completion_handler) {
@@ -233,7 +248,7 @@ struct vulkan_queue_impl {
 			return true;
 		}
 		thread_cmd_pool = make_unique<vulkan_command_pool_t>(dev, queue);
-		MULTI_GUARD(thread_cmd_pool->cmd_buffers_lock, thread_cmd_pool->fence_lock);
+		GUARD(thread_cmd_pool->cmd_buffers_lock);
 		
 		// create command pool for this queue + device
 		const VkCommandPoolCreateInfo cmd_pool_info {
@@ -286,16 +301,18 @@ struct vulkan_queue_impl {
 			.pNext = nullptr,
 			.flags = 0,
 		};
+		array<VkFence, vulkan_command_pool_t::fence_count> fences {};
 		for (uint32_t i = 0; i < vulkan_command_pool_t::fence_count; ++i) {
-			VK_CALL_RET(vkCreateFence(dev.device, &fence_info, nullptr, &thread_cmd_pool->fences[i]),
+			VK_CALL_RET(vkCreateFence(dev.device, &fence_info, nullptr, &fences[i]),
 						"failed to create fence #" + to_string(i), false)
 		}
-		thread_cmd_pool->fences_in_use.reset();
+		thread_cmd_pool->fences = make_unique<safe_resource_container<VkFence, vulkan_command_pool_t::fence_count>>(move(fences));
 		
 #if defined(FLOOR_DEBUG)
 		const auto fence_prefix = "fence:" + thread_name + ":";
 		for (uint32_t fence_idx = 0; fence_idx < vulkan_command_pool_t::fence_count; ++fence_idx) {
-			((const vulkan_compute*)dev.context)->set_vulkan_debug_label(dev, VK_OBJECT_TYPE_FENCE, uint64_t(thread_cmd_pool->fences[fence_idx]),
+			((const vulkan_compute*)dev.context)->set_vulkan_debug_label(dev, VK_OBJECT_TYPE_FENCE,
+																		 uint64_t(thread_cmd_pool->fences->get_resource(fence_idx)),
 																		 fence_prefix + to_string(fence_idx));
 		}
 #endif
@@ -325,6 +342,13 @@ void vulkan_queue::flush() const {
 	// nop
 }
 
+void vulkan_queue::add_completion_handler(queue_completion_handler_t&& completion_handler) const {
+	// all command buffer submissions are currently blocking (waiting on their fence, see vulkan_command_pool_t),
+	// i.e. everything that has been submitted to this queue up to this point has already been executed
+	// TODO: once non-blocking submission is supported, attach this to the last submitted command buffer instead
+	completion_handler();
+}
+
 void vulkan_queue::execute_indirect(const indirect_command_pipeline& indirect_cmd floor_unused,
 									const uint32_t command_offset floor_unused,
 									const uint32_t command_count floor_unused) const {
@@ -690,7 +690,9 @@ bool cpu_has_avx512() {
 #if defined(__x86_64__)
 	uint32_t eax { 0 }, ebx { 0 }, ecx { 0 }, edx { 0 };
 	if (__get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx) == 1) {
-		return (ebx & 0x00010000) > 0;
+		// F (16), DQ (17), CD (28), BW (30), VL (31)
+		static constexpr const uint32_t avx512_skx_mask { 0xD0030000u };
+		return (ebx & avx512_skx_mask) == avx512_skx_mask;
 	}
 #endif
 	return false;
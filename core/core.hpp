@@ -220,6 +220,7 @@ namespace core {
 	//! returns true if the cpu has avx2 instruction support
 	bool cpu_has_avx2();
 	//! returns true if the cpu has avx-512 instruction support
+	//! NOTE: this requires the F, CD, VL, DQ and BW subsets (i.e. the Skylake-Server feature set)
 	bool cpu_has_avx512();
 
 }
@@ -20,12 +20,17 @@
 #include <floor/floor/floor.hpp>
 #include <floor/core/unicode.hpp>
 #include <floor/vr/vr_context.hpp>
+#include <bit>
 
 event::event() : thread_base("event") {
 	const uint32_t cur_time { SDL_GetTicks() };
 	lm_double_click_timer = cur_time;
 	rm_double_click_timer = cur_time;
 	mm_double_click_timer = cur_time;
+	
+	// user events are only handled when there are any (-> notified in handle_event)
+	this->set_event_driven(true);
+	this->set_thread_delay(0);
 	this->start();
 }
 
@@ -37,13 +42,6 @@ event::~event() {
 void event::run() {
 	// user events are handled "asynchronously", so they don't
 	// interfere with other (internal) events or engine code
-	
-	// copy/move user events to a processing queue, so the queue can
-	// still be used in the other (main) event thread
-	user_queue_lock.lock();
-	user_event_queue_processing.swap(user_event_queue);
-	user_queue_lock.unlock();
-	
 	handle_user_events();
 }
 
@@ -53,6 +51,15 @@ void event::handle_events() {
 	// always acquire the gl context for internal handlers, since these are very likely to modify gl data
 	floor::acquire_context();
 	
+	// dispatch all events that have been added since the last call (from any thread)
+	{
+		EVENT_TYPE added_type;
+		shared_ptr<event_object> added_obj;
+		while (added_events.pop(added_type, added_obj)) {
+			handle_event(added_type, std::move(added_obj));
+		}
+	}
+	
 	// internal engine event handler
 	const int coord_scale = (floor::get_hidpi() ? int(floor::get_scale_factor()) : 1);
 	const auto coord_scalef = float(coord_scale);
@@ -77,19 +84,19 @@ void event::handle_events() {
 						case SDL_BUTTON_LEFT:
 							if(event_handle.button.state == SDL_PRESSED) {
 								handle_event(EVENT_TYPE::MOUSE_LEFT_DOWN,
-											 make_shared<mouse_left_down_event>(cur_ticks, mouse_coord, pressure));
+											 make_event<mouse_left_down_event>(cur_ticks, mouse_coord, pressure));
 							}
 							break;
 						case SDL_BUTTON_RIGHT:
 							if(event_handle.button.state == SDL_PRESSED) {
 								handle_event(EVENT_TYPE::MOUSE_RIGHT_DOWN,
-											 make_shared<mouse_right_down_event>(cur_ticks, mouse_coord, pressure));
+											 make_event<mouse_right_down_event>(cur_ticks, mouse_coord, pressure));
 							}
 							break;
 						case SDL_BUTTON_MIDDLE:
 							if(event_handle.button.state == SDL_PRESSED) {
 								handle_event(EVENT_TYPE::MOUSE_MIDDLE_DOWN,
-											 make_shared<mouse_middle_down_event>(cur_ticks, mouse_coord, pressure));
+											 make_event<mouse_middle_down_event>(cur_ticks, mouse_coord, pressure));
 							}
 							break;
 						default: break;
@@ -101,12 +108,12 @@ void event::handle_events() {
 						case SDL_BUTTON_LEFT:
 							if(event_handle.button.state == SDL_RELEASED) {
 								handle_event(EVENT_TYPE::MOUSE_LEFT_UP,
-											 make_shared<mouse_left_up_event>(cur_ticks, mouse_coord, pressure));
+											 make_event<mouse_left_up_event>(cur_ticks, mouse_coord, pressure));
 								
 								if(cur_ticks - lm_double_click_timer < ldouble_click_time) {
 									// emit a double click event
 									handle_event(EVENT_TYPE::MOUSE_LEFT_DOUBLE_CLICK,
-												 make_shared<mouse_left_double_click_event>(
+												 make_event<mouse_left_double_click_event>(
 													cur_ticks,
 													prev_events[EVENT_TYPE::MOUSE_LEFT_DOWN],
 													prev_events[EVENT_TYPE::MOUSE_LEFT_UP]));
@@ -114,7 +121,7 @@ void event::handle_events() {
 								else {
 									// only emit a normal click event
 									handle_event(EVENT_TYPE::MOUSE_LEFT_CLICK,
-												 make_shared<mouse_left_click_event>(
+												 make_event<mouse_left_click_event>(
 													cur_ticks,
 													prev_events[EVENT_TYPE::MOUSE_LEFT_DOWN],
 													prev_events[EVENT_TYPE::MOUSE_LEFT_UP]));
@@ -126,12 +133,12 @@ void event::handle_events() {
 						case SDL_BUTTON_RIGHT:
 							if(event_handle.button.state == SDL_RELEASED) {
 								handle_event(EVENT_TYPE::MOUSE_RIGHT_UP,
-											 make_shared<mouse_right_up_event>(cur_ticks, mouse_coord, pressure));
+											 make_event<mouse_right_up_event>(cur_ticks, mouse_coord, pressure));
 								
 								if(cur_ticks - rm_double_click_timer < rdouble_click_time) {
 									// emit a double click event
 									handle_event(EVENT_TYPE::MOUSE_RIGHT_DOUBLE_CLICK,
-												 make_shared<mouse_right_double_click_event>(
+												 make_event<mouse_right_double_click_event>(
 													cur_ticks,
 													prev_events[EVENT_TYPE::MOUSE_RIGHT_DOWN],
 													prev_events[EVENT_TYPE::MOUSE_RIGHT_UP]));
@@ -139,7 +146,7 @@ void event::handle_events() {
 								else {
 									// only emit a normal click event
 									handle_event(EVENT_TYPE::MOUSE_RIGHT_CLICK,
-												 make_shared<mouse_right_click_event>(
+												 make_event<mouse_right_click_event>(
 													cur_ticks,
 													prev_events[EVENT_TYPE::MOUSE_RIGHT_DOWN],
 													prev_events[EVENT_TYPE::MOUSE_RIGHT_UP]));
@@ -151,12 +158,12 @@ void event::handle_events() {
 						case SDL_BUTTON_MIDDLE:
 							if(event_handle.button.state == SDL_RELEASED) {
 								handle_event(EVENT_TYPE::MOUSE_MIDDLE_UP,
-											 make_shared<mouse_middle_up_event>(cur_ticks, mouse_coord, pressure));
+											 make_event<mouse_middle_up_event>(cur_ticks, mouse_coord, pressure));
 								
 								if(SDL_GetTicks() - mm_double_click_timer < mdouble_click_time) {
 									// emit a double click event
 									handle_event(EVENT_TYPE::MOUSE_MIDDLE_DOUBLE_CLICK,
-												 make_shared<mouse_middle_double_click_event>(
+												 make_event<mouse_middle_double_click_event>(
 													cur_ticks,
 													prev_events[EVENT_TYPE::MOUSE_MIDDLE_DOWN],
 													prev_events[EVENT_TYPE::MOUSE_MIDDLE_UP]));
@@ -164,7 +171,7 @@ void event::handle_events() {
 								else {
 									// only emit a normal click event
 									handle_event(EVENT_TYPE::MOUSE_MIDDLE_CLICK,
-												 make_shared<mouse_middle_click_event>(
+												 make_event<mouse_middle_click_event>(
 													cur_ticks,
 													prev_events[EVENT_TYPE::MOUSE_MIDDLE_DOWN],
 													prev_events[EVENT_TYPE::MOUSE_MIDDLE_UP]));
@@ -191,7 +198,7 @@ void event::handle_events() {
 					const float pressure = 0.0f;
 #endif
 					handle_event(EVENT_TYPE::MOUSE_MOVE,
-								 make_shared<mouse_move_event>(cur_ticks, abs_pos, rel_move, pressure));
+								 make_event<mouse_move_event>(cur_ticks, abs_pos, rel_move, pressure));
 				}
 				break;
 				case SDL_MOUSEWHEEL: {
@@ -200,16 +207,16 @@ void event::handle_events() {
 					SDL_GetMouseState(&mouse_coord.x, &mouse_coord.y);
 					if(event_handle.wheel.y > 0) {
 						handle_event(EVENT_TYPE::MOUSE_WHEEL_UP,
-									 make_shared<mouse_wheel_up_event>(cur_ticks,
-																	   mouse_coord,
-																	   event_handle.wheel.y));
+									 make_event<mouse_wheel_up_event>(cur_ticks,
+																	  mouse_coord,
+																	  event_handle.wheel.y));
 					}
 					else if(event_handle.wheel.y < 0) {
 						const auto abs_wheel_move = (uint32_t)abs(event_handle.wheel.y);
 						handle_event(EVENT_TYPE::MOUSE_WHEEL_DOWN,
-									 make_shared<mouse_wheel_down_event>(cur_ticks,
-																		 mouse_coord,
-																		 abs_wheel_move));
+									 make_event<mouse_wheel_down_event>(cur_ticks,
+																		mouse_coord,
+																		abs_wheel_move));
 					}
 				}
 				break;
@@ -227,20 +234,20 @@ void event::handle_events() {
 			if(event_type == SDL_FINGERDOWN) {
 				if(event_handle.tfinger.type == SDL_FINGERDOWN) {
 					handle_event(EVENT_TYPE::FINGER_DOWN,
-								 make_shared<finger_down_event>(cur_ticks, finger_coord, pressure, finger_id));
+								 make_event<finger_down_event>(cur_ticks, finger_coord, pressure, finger_id));
 				}
 			}
 			else if(event_type == SDL_FINGERUP) {
 				if(event_handle.tfinger.type == SDL_FINGERUP) {
 					handle_event(EVENT_TYPE::FINGER_UP,
-								 make_shared<finger_up_event>(cur_ticks, finger_coord, pressure, finger_id));
+								 make_event<finger_up_event>(cur_ticks, finger_coord, pressure, finger_id));
 				}
 			}
 			else if(event_type == SDL_FINGERMOTION) {
 				if(event_handle.tfinger.type == SDL_FINGERMOTION) {
 					const float2 rel_move { event_handle.tfinger.dx, event_handle.tfinger.dy };
 					handle_event(EVENT_TYPE::FINGER_MOVE,
-								 make_shared<finger_move_event>(cur_ticks, finger_coord, rel_move, pressure, finger_id));
+								 make_event<finger_move_event>(cur_ticks, finger_coord, rel_move, pressure, finger_id));
 				}
 			}
 		}
@@ -249,11 +256,11 @@ void event::handle_events() {
 			switch(event_type) {
 				case SDL_KEYUP:
 					handle_event(EVENT_TYPE::KEY_UP,
-								 make_shared<key_up_event>(cur_ticks, event_handle.key.keysym.sym));
+								 make_event<key_up_event>(cur_ticks, event_handle.key.keysym.sym));
 					break;
 				case SDL_KEYDOWN:
 					handle_event(EVENT_TYPE::KEY_DOWN,
-								 make_shared<key_up_event>(cur_ticks, event_handle.key.keysym.sym));
+								 make_event<key_up_event>(cur_ticks, event_handle.key.keysym.sym));
 					break;
 				case SDL_TEXTINPUT: {
 					string text;
@@ -264,7 +271,7 @@ void event::handle_events() {
 					const auto codes = unicode::utf8_to_unicode(text);
 					for(const auto& code : codes) {
 						handle_event(EVENT_TYPE::UNICODE_INPUT,
-									 make_shared<unicode_input_event>(cur_ticks, code));
+									 make_event<unicode_input_event>(cur_ticks, code));
 					}
 				}
 				break;
@@ -272,15 +279,15 @@ void event::handle_events() {
 					if(event_handle.window.event == SDL_WINDOWEVENT_RESIZED) {
 						const size2 new_size((size_t)event_handle.window.data1, (size_t)event_handle.window.data2);
 						handle_event(EVENT_TYPE::WINDOW_RESIZE,
-									 make_shared<window_resize_event>(cur_ticks, new_size));
+									 make_event<window_resize_event>(cur_ticks, new_size));
 					}
 					break;
 				case SDL_QUIT:
-					handle_event(EVENT_TYPE::QUIT, make_shared<quit_event>(cur_ticks));
+					handle_event(EVENT_TYPE::QUIT, make_event<quit_event>(cur_ticks));
 					break;
 				case SDL_CLIPBOARDUPDATE:
 					handle_event(EVENT_TYPE::CLIPBOARD_UPDATE,
-								 make_shared<clipboard_update_event>(cur_ticks, SDL_HasClipboardText() ? SDL_GetClipboardText() : ""));
+								 make_event<clipboard_update_event>(cur_ticks, SDL_HasClipboardText() ? SDL_GetClipboardText() : ""));
 					break;
 				default: break;
 			}
@@ -319,12 +326,55 @@ void event::set_mdouble_click_time(uint32_t dctime) {
 	mdouble_click_time = dctime;
 }
 
+pair<uint32_t, uint32_t> event::get_handler_index(const EVENT_TYPE type) {
+	// category: 0 = user, 1 = other, 2 = mouse, 3 = key, 4 = touch, 5 = ui, 6 = VR controller, 7 = none
+	static constexpr const uint32_t index_mask { (uint32_t(EVENT_TYPE::__VR_CONTROLLER_EVENT) << 1u) - 1u };
+	const auto type_value = uint32_t(type);
+	return { min(uint32_t(countl_zero(type_value)), event_category_count - 1u), type_value & index_mask };
+}
+
+const vector<event::handler*>* event::get_handlers(const handler_table& table, const EVENT_TYPE type) {
+	const auto [category, index] = get_handler_index(type);
+	if (index >= table[category].size() || table[category][index].empty()) {
+		return nullptr;
+	}
+	return &table[category][index];
+}
+
+void event::insert_handler(handler_table& table, handler& handler_, const EVENT_TYPE type) {
+	const auto [category, index] = get_handler_index(type);
+	if (index >= table[category].size()) {
+		table[category].resize(index + 1u);
+	}
+	table[category][index].emplace_back(&handler_);
+}
+
+void event::erase_handler(handler_table& table, const handler& handler_, const EVENT_TYPE type) {
+	const auto [category, index] = get_handler_index(type);
+	if (index >= table[category].size()) {
+		return;
+	}
+	// good old pointer comparison ...
+	auto& type_handlers = table[category][index];
+	if (const auto iter = find(type_handlers.begin(), type_handlers.end(), &handler_); iter != type_handlers.end()) {
+		type_handlers.erase(iter);
+	}
+}
+
+void event::erase_handler(handler_table& table, const handler& handler_) {
+	for (auto& category_handlers : table) {
+		for (auto& type_handlers : category_handlers) {
+			erase(type_handlers, &handler_);
+		}
+	}
+}
+
 void event::add_event_handler(handler& handler_, EVENT_TYPE type) {
 	int cas_zero = 0;
 	while(!handlers_lock.compare_exchange_strong(cas_zero, handlers_locked)) {
 		this_thread::yield();
 	}
-	handlers.insert(pair<EVENT_TYPE, handler&>(type, handler_));
+	insert_handler(handlers, handler_, type);
 	handlers_lock = 0;
 }
 
@@ -333,13 +383,13 @@ void event::add_internal_event_handler(handler& handler_, EVENT_TYPE type) {
 	while(!handlers_lock.compare_exchange_strong(cas_zero, handlers_locked)) {
 		this_thread::yield();
 	}
-	internal_handlers.insert(pair<EVENT_TYPE, handler&>(type, handler_));
+	insert_handler(internal_handlers, handler_, type);
 	handlers_lock = 0;
 }
 
 void event::add_event(const EVENT_TYPE type, shared_ptr<event_object> obj) {
-	// for now, just pass it through
-	handle_event(type, obj); // TODO: add to queue and handle in handle_events (-> required for correct mt)
+	// will be dispatched in the next handle_events call
+	added_events.push(type, std::move(obj));
 }
 
 void event::handle_event(const EVENT_TYPE& type, shared_ptr<event_object> obj) {
@@ -354,26 +404,24 @@ void event::handle_event(const EVENT_TYPE& type, shared_ptr<event_object> obj) {
 		cur_hl = handlers_lock;
 	}
 	
-	const auto range = internal_handlers.equal_range(type);
-	for(auto iter = range.first; iter != range.second; iter++) {
-		// ignore return value for now (TODO: actually use this?)
-		iter->second(type, obj);
+	if (const auto type_handlers = get_handlers(internal_handlers, type); type_handlers != nullptr) {
+		for (const auto& internal_handler : *type_handlers) {
+			// ignore return value for now (TODO: actually use this?)
+			(*internal_handler)(type, obj);
+		}
 	}
 	
 	handlers_lock--;
 	
 	// push to user event queue (these will be handled later on)
-	user_queue_lock.lock();
-	user_event_queue.push(make_pair(type, obj));
-	user_queue_lock.unlock();
+	user_events.push(type, std::move(obj));
+	notify();
 }
 
 void event::handle_user_events() {
-	while(!user_event_queue_processing.empty()) {
-		// pop next event
-		pair<EVENT_TYPE, shared_ptr<event_object>> evt = user_event_queue_processing.front();
-		user_event_queue_processing.pop();
-		
+	EVENT_TYPE type;
+	shared_ptr<event_object> obj;
+	while (user_events.pop(type, obj)) {
 		// call user event handlers
 		int cur_hl = handlers_lock;
 		while(cur_hl == handlers_locked ||
@@ -382,9 +430,10 @@ void event::handle_user_events() {
 			cur_hl = handlers_lock;
 		}
 		
-		const auto range = handlers.equal_range(evt.first);
-		for(auto iter = range.first; iter != range.second; iter++) {
-			iter->second(evt.first, evt.second);
+		if (const auto type_handlers = get_handlers(handlers, type); type_handlers != nullptr) {
+			for (const auto& user_handler : *type_handlers) {
+				(*user_handler)(type, obj);
+			}
 		}
 		
 		handlers_lock--;
@@ -397,19 +446,8 @@ void event::remove_event_handler(const handler& handler_) {
 		this_thread::yield();
 	}
 	
-	for(auto handler_iter = handlers.cbegin(); handler_iter != handlers.cend(); ) {
-		// good old pointer comparison ...
-		if(&handler_iter->second == &handler_) {
-			handler_iter = handlers.erase(handler_iter);
-		}
-		else ++handler_iter;
-	}
-	for(auto handler_iter = internal_handlers.cbegin(); handler_iter != internal_handlers.cend(); ) {
-		if(&handler_iter->second == &handler_) {
-			handler_iter = internal_handlers.erase(handler_iter);
-		}
-		else ++handler_iter;
-	}
+	erase_handler(handlers, handler_);
+	erase_handler(internal_handlers, handler_);
 	
 	handlers_lock = 0;
 }
@@ -421,21 +459,8 @@ void event::remove_event_types_from_handler(const handler& handler_, const set<E
 	}
 	
 	for(const auto& type : types) {
-		const auto range_0 = handlers.equal_range(type);
-		for(auto iter = range_0.first; iter != range_0.second; iter++) {
-			if(&iter->second == &handler_) {
-				handlers.erase(iter);
-				break;
-			}
-		}
-		
-		const auto range_1 = internal_handlers.equal_range(type);
-		for(auto iter = range_1.first; iter != range_1.second; iter++) {
-			if(&iter->second == &handler_) {
-				internal_handlers.erase(iter);
-				break;
-			}
-		}
+		erase_handler(handlers, handler_, type);
+		erase_handler(internal_handlers, handler_, type);
 	}
 	
 	handlers_lock = 0;
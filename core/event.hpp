@@ -22,6 +22,7 @@
 #include <floor/core/core.hpp>
 #include <floor/threading/thread_base.hpp>
 #include <floor/core/event_objects.hpp>
+#include <floor/core/event_queue.hpp>
 
 class vr_context;
 
@@ -31,7 +32,10 @@ public:
 	event();
 	~event() override;
 
+	//! handles all pending SDL, VR and added events (must be called from the main thread)
 	void handle_events();
+	//! adds an event that will be dispatched to all handlers in the next handle_events() call
+	//! NOTE: this is thread-safe and lock-free, use make_event to create the event object in pooled memory
 	void add_event(const EVENT_TYPE type, shared_ptr<event_object> obj);
 
 	void set_vr_context(vr_context* vr_ctx_) {
@@ -68,13 +72,29 @@ protected:
 	
 	void run() override;
 	
-	//
-	unordered_multimap<EVENT_TYPE, handler&> internal_handlers;
-	unordered_multimap<EVENT_TYPE, handler&> handlers;
-	queue<pair<EVENT_TYPE, shared_ptr<event_object>>> user_event_queue, user_event_queue_processing;
-	recursive_mutex user_queue_lock;
+	//! flat event handler table: indexed by the event category (see EVENT_TYPE) and the event index within that category
+	static constexpr const uint32_t event_category_count { 8u };
+	using handler_table = array<vector<vector<handler*>>, event_category_count>;
+	handler_table internal_handlers;
+	handler_table handlers;
 	atomic<int> handlers_lock { 0 };
 	static constexpr const int handlers_locked { (int)0x80000000 };
+	
+	//! returns the <category, index> of the specified event type in a handler table
+	static pair<uint32_t, uint32_t> get_handler_index(const EVENT_TYPE type);
+	//! returns the handlers for the specified event type in "table" (or nullptr if there are none)
+	static const vector<handler*>* get_handlers(const handler_table& table, const EVENT_TYPE type);
+	//! adds "handler_" for the specified event type to "table"
+	static void insert_handler(handler_table& table, handler& handler_, const EVENT_TYPE type);
+	//! removes "handler_" for the specified event type from "table"
+	static void erase_handler(handler_table& table, const handler& handler_, const EVENT_TYPE type);
+	//! removes "handler_" for all event types from "table"
+	static void erase_handler(handler_table& table, const handler& handler_);
+	
+	//! events that have been added via add_event (from any thread), consumed in handle_events
+	event_queue added_events;
+	//! events that will be dispatched to the user event handlers (consumed by the event thread)
+	event_queue user_events;
 	void handle_user_events();
 	void handle_event(const EVENT_TYPE& type, shared_ptr<event_object> obj);
 	
@@ -0,0 +1,144 @@
+/*
+ *  Flo's Open libRary (floor)
+ *  Copyright (C) 2004 - 2022 Florian Ziesche
+ *  
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; version 2 of the License only.
+ *  
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <floor/core/event_queue.hpp>
+#include <new>
+#include <array>
+
+//! pooled block (only used while a block is unused)
+struct event_memory_block {
+	event_memory_block* next;
+};
+
+//! global free lists (one per size class)
+//! NOTE: blocks are pushed individually, but are always popped as a whole list (-> ABA-free)
+static array<atomic<event_memory_block*>, event_memory_pool::size_class_count> event_memory_free_lists {};
+
+//! per-thread block cache, returned to the global free lists on thread exit
+struct event_memory_thread_cache {
+	array<event_memory_block*, event_memory_pool::size_class_count> blocks {};
+	
+	~event_memory_thread_cache() {
+		for (uint32_t cls = 0; cls < event_memory_pool::size_class_count; ++cls) {
+			while (blocks[cls] != nullptr) {
+				auto block = blocks[cls];
+				blocks[cls] = block->next;
+				event_memory_pool::deallocate(block, event_memory_pool::min_block_size << cls);
+			}
+		}
+	}
+};
+static thread_local event_memory_thread_cache event_memory_cache;
+
+void* event_memory_pool::allocate(const size_t size) {
+	if (size > max_block_size) {
+		return ::operator new(size, align_val_t { block_alignment });
+	}
+	
+	const auto cls = size_class(size);
+	auto& cached_blocks = event_memory_cache.blocks[cls];
+	if (cached_blocks == nullptr) {
+		// take all blocks that are currently in the global pool
+		cached_blocks = event_memory_free_lists[cls].exchange(nullptr, memory_order_acquire);
+		if (cached_blocks == nullptr) {
+			return ::operator new(min_block_size << cls, align_val_t { block_alignment });
+		}
+	}
+	auto block = cached_blocks;
+	cached_blocks = block->next;
+	return block;
+}
+
+void event_memory_pool::deallocate(void* ptr, const size_t size) noexcept {
+	if (ptr == nullptr) {
+		return;
+	}
+	if (size > max_block_size) {
+		::operator delete(ptr, align_val_t { block_alignment });
+		return;
+	}
+	
+	// blocks are usually freed by a different thread than the one that allocated them
+	// (-> always return them to the global pool, so that they can be reused by the producing threads)
+	auto block = (event_memory_block*)ptr;
+	auto& free_list = event_memory_free_lists[size_class(size)];
+	block->next = free_list.load(memory_order_relaxed);
+	while (!free_list.compare_exchange_weak(block->next, block, memory_order_release, memory_order_relaxed)) {
+		// retry
+	}
+}
+
+event_queue::event_queue() : head(&stub), tail(&stub) {
+}
+
+event_queue::~event_queue() {
+	// drop all remaining events
+	EVENT_TYPE type;
+	shared_ptr<event_object> obj;
+	while (pop(type, obj)) {
+		// nop
+	}
+}
+
+void event_queue::push_node(node* n) {
+	n->next.store(nullptr, memory_order_relaxed);
+	auto prev = head.exchange(n, memory_order_acq_rel);
+	// NOTE: between the exchange and this store, the queue is temporarily "disconnected" for the consumer
+	prev->next.store(n, memory_order_release);
+}
+
+void event_queue::push(const EVENT_TYPE type, shared_ptr<event_object> obj) {
+	auto n = new (event_memory_pool::allocate(sizeof(node))) node {};
+	n->type = type;
+	n->obj = std::move(obj);
+	push_node(n);
+}
+
+bool event_queue::pop(EVENT_TYPE& type, shared_ptr<event_object>& obj) {
+	auto cur_tail = tail;
+	auto next = cur_tail->next.load(memory_order_acquire);
+	if (cur_tail == &stub) {
+		if (next == nullptr) {
+			return false;
+		}
+		tail = next;
+		cur_tail = next;
+		next = next->next.load(memory_order_acquire);
+	}
+	
+	if (next == nullptr) {
+		if (cur_tail != head.load(memory_order_acquire)) {
+			// a push is in progress
+			return false;
+		}
+		// "cur_tail" is the last node: re-insert the stub, so that "cur_tail" can be dequeued
+		push_node(&stub);
+		next = cur_tail->next.load(memory_order_acquire);
+		if (next == nullptr) {
+			// another push is in progress
+			return false;
+		}
+	}
+	tail = next;
+	
+	type = cur_tail->type;
+	obj = std::move(cur_tail->obj);
+	cur_tail->~node();
+	event_memory_pool::deallocate(cur_tail, sizeof(node));
+	return true;
+}
@@ -0,0 +1,128 @@
+/*
+ *  Flo's Open libRary (floor)
+ *  Copyright (C) 2004 - 2022 Florian Ziesche
+ *  
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; version 2 of the License only.
+ *  
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef __FLOOR_EVENT_QUEUE_HPP__
+#define __FLOOR_EVENT_QUEUE_HPP__
+
+#include <floor/core/essentials.hpp>
+#include <floor/core/event_objects.hpp>
+#include <atomic>
+#include <memory>
+using namespace std;
+
+//! lock-free pool of fixed-size memory blocks that is used to store event objects and event queue nodes
+//! (-> type-erased: events of any type are stored in the smallest block size class they fit into),
+//! blocks are cached per thread and are only ever returned to the pool, never to the system
+class event_memory_pool {
+public:
+	//! amount of block size classes (64, 128, 256 and 512 bytes)
+	static constexpr const uint32_t size_class_count { 4u };
+	//! size of the smallest block size class
+	static constexpr const size_t min_block_size { 64u };
+	//! size of the largest block size class, larger allocations are directly passed through to the system allocator
+	static constexpr const size_t max_block_size { min_block_size << (size_class_count - 1u) };
+	//! alignment of all blocks
+	static constexpr const size_t block_alignment { 64u };
+	
+	//! allocates a block of at least "size" bytes (thread-safe)
+	static void* allocate(const size_t size);
+	//! returns a block of "size" bytes (as specified in allocate) back to the pool (thread-safe)
+	static void deallocate(void* ptr, const size_t size) noexcept;
+	
+	//! returns the size class index of the specified size (only valid if size <= max_block_size)
+	static constexpr uint32_t size_class(const size_t size) {
+		uint32_t cls = 0u;
+		for (size_t block_size = min_block_size; block_size < size; block_size <<= 1u) {
+			++cls;
+		}
+		return cls;
+	}
+
+};
+
+//! std allocator that allocates from the event_memory_pool (used with allocate_shared)
+template <typename T>
+struct event_allocator {
+	using value_type = T;
+	
+	constexpr event_allocator() noexcept = default;
+	template <typename U> constexpr event_allocator(const event_allocator<U>&) noexcept {}
+	
+	T* allocate(const size_t n) {
+		static_assert(alignof(T) <= event_memory_pool::block_alignment, "unsupported alignment");
+		return (T*)event_memory_pool::allocate(n * sizeof(T));
+	}
+	void deallocate(T* ptr, const size_t n) noexcept {
+		event_memory_pool::deallocate(ptr, n * sizeof(T));
+	}
+	
+	template <typename U> constexpr bool operator==(const event_allocator<U>&) const noexcept { return true; }
+	template <typename U> constexpr bool operator!=(const event_allocator<U>&) const noexcept { return false; }
+};
+
+//! creates an event object of type "event_type" in pooled event memory (event object and shared_ptr control block
+//! are allocated together, like make_shared)
+template <typename event_type, typename... Args>
+floor_inline_always shared_ptr<event_type> make_event(Args&&... args) {
+	return allocate_shared<event_type>(event_allocator<event_type> {}, std::forward<Args>(args)...);
+}
+
+//! lock-free unbounded multi-producer single-consumer queue of events (intrusive Vyukov MPSC queue),
+//! queue nodes are allocated from the event_memory_pool
+//! NOTE: push may be called from any thread, pop must only be called from one thread at a time
+class event_queue {
+public:
+	event_queue();
+	~event_queue();
+	
+	//! enqueues the specified event (thread-safe, lock-free)
+	void push(const EVENT_TYPE type, shared_ptr<event_object> obj);
+	
+	//! dequeues the next event, returns false if the queue is empty
+	//! NOTE: an event whose push is still in progress in another thread may not be visible yet
+	bool pop(EVENT_TYPE& type, shared_ptr<event_object>& obj);
+	
+	//! returns true if the queue is (currently) empty
+	bool empty() const {
+		return (tail == &stub && stub.next.load(memory_order_acquire) == nullptr);
+	}
+
+protected:
+	struct node {
+		atomic<node*> next { nullptr };
+		EVENT_TYPE type { EVENT_TYPE(0u) };
+		shared_ptr<event_object> obj;
+	};
+	
+	//! last enqueued node (written by producers)
+	alignas(64) atomic<node*> head;
+	//! next node to dequeue (only accessed by the consumer)
+	alignas(64) node* tail;
+	//! always-present dummy node
+	node stub;
+	
+	//! links "n" as the new head
+	void push_node(node* n);
+	
+	// prohibit copying
+	event_queue(const event_queue&) = delete;
+	event_queue& operator=(const event_queue&) = delete;
+
+};
+
+#endif
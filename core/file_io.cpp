@@ -17,6 +17,8 @@
  */
 
 #include <floor/core/file_io.hpp>
+#include <utility>
+#include <iterator>
 
 #if defined(__WINDOWS__)
 #if defined(MINGW)
@@ -37,6 +39,10 @@
 
 #else // !__WINDOWS__
 #include <dirent.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
 #endif
 
 #if !defined(__APPLE__) // can't use <filesystem> when targeting 10.13 (need at least 10.15)
@@ -45,6 +51,163 @@
 #include <sys/stat.h>
 #endif
 
+memory_mapped_file::memory_mapped_file(const string& filename, const ACCESS_HINT hint) {
+#if !defined(__WINDOWS__)
+	const auto fd = ::open(filename.c_str(), O_RDONLY | O_CLOEXEC);
+	if (fd < 0) {
+		error = "failed to open file: "s + strerror(errno);
+		return;
+	}
+	
+	struct stat file_stat;
+	if (fstat(fd, &file_stat) != 0) {
+		error = "failed to query file size: "s + strerror(errno);
+		::close(fd);
+		return;
+	}
+	if (!S_ISREG(file_stat.st_mode)) {
+		error = "not a regular file";
+		::close(fd);
+		return;
+	}
+	
+	mapping_size = size_t(file_stat.st_size);
+	if (mapping_size > 0) {
+		auto ptr = mmap(nullptr, mapping_size, PROT_READ, MAP_PRIVATE, fd, 0);
+		if (ptr == MAP_FAILED) {
+			error = "failed to map file: "s + strerror(errno);
+			mapping_size = 0;
+			::close(fd);
+			return;
+		}
+		mapping = (uint8_t*)ptr;
+	}
+	// the mapping stays valid after the file descriptor has been closed
+	::close(fd);
+	valid = true;
+	
+	if (hint != ACCESS_HINT::NORMAL) {
+		(void)advise(hint);
+	}
+#else
+	DWORD flags = FILE_ATTRIBUTE_NORMAL;
+	if (hint == ACCESS_HINT::SEQUENTIAL) {
+		flags |= FILE_FLAG_SEQUENTIAL_SCAN;
+	} else if (hint == ACCESS_HINT::RANDOM) {
+		flags |= FILE_FLAG_RANDOM_ACCESS;
+	}
+	auto file = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, flags, nullptr);
+	if (file == INVALID_HANDLE_VALUE) {
+		error = "failed to open file: " + to_string(GetLastError());
+		return;
+	}
+	file_handle = file;
+	
+	LARGE_INTEGER file_size;
+	if (!GetFileSizeEx(file, &file_size)) {
+		error = "failed to query file size: " + to_string(GetLastError());
+		unmap();
+		return;
+	}
+	
+	mapping_size = size_t(file_size.QuadPart);
+	if (mapping_size > 0) {
+		mapping_handle = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		if (mapping_handle == nullptr) {
+			error = "failed to create file mapping: " + to_string(GetLastError());
+			unmap();
+			return;
+		}
+		mapping = (uint8_t*)MapViewOfFile(mapping_handle, FILE_MAP_READ, 0, 0, 0);
+		if (mapping == nullptr) {
+			error = "failed to map file: " + to_string(GetLastError());
+			unmap();
+			return;
+		}
+	}
+	valid = true;
+#endif
+}
+
+memory_mapped_file::memory_mapped_file(memory_mapped_file&& mapped_file) noexcept {
+	*this = move(mapped_file);
+}
+
+memory_mapped_file& memory_mapped_file::operator=(memory_mapped_file&& mapped_file) noexcept {
+	if (this != &mapped_file) {
+		unmap();
+		mapping = exchange(mapped_file.mapping, nullptr);
+		mapping_size = exchange(mapped_file.mapping_size, 0u);
+		valid = exchange(mapped_file.valid, false);
+		error = move(mapped_file.error);
+#if defined(__WINDOWS__)
+		file_handle = exchange(mapped_file.file_handle, nullptr);
+		mapping_handle = exchange(mapped_file.mapping_handle, nullptr);
+#endif
+	}
+	return *this;
+}
+
+memory_mapped_file::~memory_mapped_file() {
+	unmap();
+}
+
+void memory_mapped_file::unmap() {
+#if !defined(__WINDOWS__)
+	if (mapping != nullptr) {
+		munmap(mapping, mapping_size);
+	}
+#else
+	if (mapping != nullptr) {
+		UnmapViewOfFile(mapping);
+	}
+	if (mapping_handle != nullptr) {
+		CloseHandle(mapping_handle);
+		mapping_handle = nullptr;
+	}
+	if (file_handle != nullptr) {
+		CloseHandle(file_handle);
+		file_handle = nullptr;
+	}
+#endif
+	mapping = nullptr;
+	mapping_size = 0;
+	valid = false;
+}
+
+bool memory_mapped_file::advise(const ACCESS_HINT hint, const size_t offset, const size_t size) const {
+	if (mapping == nullptr || offset >= mapping_size) {
+		return false;
+	}
+#if !defined(__WINDOWS__)
+	int advice = MADV_NORMAL;
+	switch (hint) {
+		case ACCESS_HINT::NORMAL:
+			advice = MADV_NORMAL;
+			break;
+		case ACCESS_HINT::SEQUENTIAL:
+			advice = MADV_SEQUENTIAL;
+			break;
+		case ACCESS_HINT::RANDOM:
+			advice = MADV_RANDOM;
+			break;
+		case ACCESS_HINT::WILL_NEED:
+			advice = MADV_WILLNEED;
+			break;
+	}
+	
+	// madvise requires a page-aligned start address
+	static const auto page_size = size_t(sysconf(_SC_PAGESIZE));
+	const auto end = (size == 0 ? mapping_size : std::min(offset + size, mapping_size));
+	const auto aligned_offset = offset & ~(page_size - 1u);
+	return (madvise(mapping + aligned_offset, end - aligned_offset, advice) == 0);
+#else
+	(void)hint;
+	(void)size;
+	return true;
+#endif
+}
+
 file_io::file_io(const string& filename_, const OPEN_TYPE open_type_) {
 	open(filename_, open_type_);
 }
@@ -114,6 +277,15 @@ void file_io::close() {
 }
 
 bool file_io::file_to_buffer(const string& filename, stringstream& buffer) {
+	if (memory_mapped_file mapped_file(filename, memory_mapped_file::ACCESS_HINT::SEQUENTIAL); mapped_file.is_valid()) {
+		buffer.seekp(0);
+		buffer.seekg(0);
+		buffer.clear();
+		buffer.str("");
+		buffer.write((const char*)mapped_file.data(), streamsize(mapped_file.size()));
+		return true;
+	}
+	
 	file_io file(filename, file_io::OPEN_TYPE::READ_BINARY);
 	if(!file.is_open()) {
 		return false;
@@ -129,6 +301,15 @@ bool file_io::file_to_buffer(const string& filename, stringstream& buffer) {
 }
 
 pair<unique_ptr<uint8_t[]>, size_t> file_io::file_to_buffer(const string& filename) {
+	if (memory_mapped_file mapped_file(filename, memory_mapped_file::ACCESS_HINT::SEQUENTIAL); mapped_file.is_valid()) {
+		// NOTE: no need to zero-initialize, since everything is overwritten
+		unique_ptr<uint8_t[]> data(new uint8_t[mapped_file.size()]);
+		if (mapped_file.size() > 0) {
+			memcpy(data.get(), mapped_file.data(), mapped_file.size());
+		}
+		return { move(data), mapped_file.size() };
+	}
+	
 	file_io file(filename, file_io::OPEN_TYPE::READ_BINARY);
 	if (!file.is_open()) {
 		return {};
@@ -160,6 +341,11 @@ pair<unique_ptr<uint8_t[]>, size_t> file_io::file_to_buffer(const string& filena
 }
 
 bool file_io::file_to_string(const string& filename, string& str) {
+	if (memory_mapped_file mapped_file(filename, memory_mapped_file::ACCESS_HINT::SEQUENTIAL); mapped_file.is_valid()) {
+		str.assign(mapped_file.get_string_view());
+		return true;
+	}
+	
 	file_io file(filename, file_io::OPEN_TYPE::READ_BINARY);
 	if(!file.is_open()) {
 		return false;
@@ -543,7 +729,16 @@ bool file_io::read_file(stringstream& buffer) {
 }
 
 bool file_io::read_file(string& str) {
-	const auto size = (size_t)get_filesize();
+	const auto size_ll = get_filesize();
+	if(size_ll < 0) {
+		// size is unknown (non-regular file, e.g. pipe or procfs entry) -> read until EOF
+		filestream.clear();
+		str.assign(istreambuf_iterator<char>(filestream), istreambuf_iterator<char>());
+		filestream.clear();
+		return !filestream.bad();
+	}
+
+	const auto size = (size_t)size_ll;
 	str.resize(size);
 	if(str.size() != size) return false;
 	filestream.read(&str.front(), (streamsize)size);
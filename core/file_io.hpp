@@ -20,6 +20,87 @@
 #define __FLOOR_FILE_IO_HPP__
 
 #include <floor/core/platform.hpp>
+#include <span>
+#include <string_view>
+
+//! RAII read-only (private) memory mapping of a whole file,
+//! allows consuming file data in place without reading/copying it first
+//! NOTE: mapping an empty file succeeds and results in an empty mapping (data() == nullptr, size() == 0)
+//! NOTE: pages that haven't been accessed yet are still backed by the file, i.e. accessing them after the file was
+//!       truncated by someone else raises SIGBUS -> only keep mappings around for the duration of a read/parse
+class memory_mapped_file {
+public:
+	//! access pattern hint for the OS (madvise on POSIX, file flags on Windows)
+	enum class ACCESS_HINT : uint32_t {
+		//! no special treatment
+		NORMAL,
+		//! data is accessed sequentially (aggressive read-ahead, pages may be freed soon after access)
+		SEQUENTIAL,
+		//! data is accessed randomly (no read-ahead)
+		RANDOM,
+		//! data will be accessed soon (start reading it in now)
+		WILL_NEED,
+	};
+	
+	memory_mapped_file() noexcept = default;
+	//! maps the whole file "filename", check is_valid() for success and get_error() for the failure reason
+	explicit memory_mapped_file(const string& filename, const ACCESS_HINT hint = ACCESS_HINT::NORMAL);
+	memory_mapped_file(memory_mapped_file&& mapped_file) noexcept;
+	memory_mapped_file& operator=(memory_mapped_file&& mapped_file) noexcept;
+	~memory_mapped_file();
+	
+	//! returns true if the file has been mapped successfully
+	bool is_valid() const {
+		return valid;
+	}
+	
+	//! returns the reason why mapping the file failed
+	const string& get_error() const {
+		return error;
+	}
+	
+	//! returns the mapped file data
+	const uint8_t* data() const {
+		return mapping;
+	}
+	//! returns the size of the mapped file
+	size_t size() const {
+		return mapping_size;
+	}
+	
+	//! returns the mapped file data as a span
+	span<const uint8_t> get_span() const {
+		return { mapping, mapping_size };
+	}
+	
+	//! returns the mapped file data as a string_view (e.g. for text files)
+	string_view get_string_view() const {
+		return { (const char*)mapping, mapping_size };
+	}
+	
+	//! hints the expected access pattern of the range ["offset", "offset" + "size") to the OS ("size" == 0: until the end)
+	//! NOTE: this is a no-op on Windows, where the hint can only be specified when mapping the file
+	bool advise(const ACCESS_HINT hint, const size_t offset = 0, const size_t size = 0) const;
+	
+	//! unmaps the file (also done on destruction)
+	void unmap();
+
+protected:
+	uint8_t* mapping { nullptr };
+	size_t mapping_size { 0u };
+	bool valid { false };
+	string error;
+#if defined(__WINDOWS__)
+	//! file and file mapping HANDLEs
+	void* file_handle { nullptr };
+	void* mapping_handle { nullptr };
+#endif
+	
+	// prohibit copying
+	memory_mapped_file(const memory_mapped_file&) = delete;
+	memory_mapped_file& operator=(const memory_mapped_file&) = delete;
+
+};
 
 //! file input/output
 class file_io {
@@ -50,6 +131,9 @@ public:
 		DIR,
 	};
 	
+	//! NOTE: file_to_buffer, file_to_string and file_to_vector read the file through a read-only memory mapping
+	//!       (with sequential access hint) and fall back to stream reading if the file can't be mapped
+	//! NOTE: to consume file data in place (without copying it), use memory_mapped_file directly
 	static bool file_to_buffer(const string& filename, stringstream& buffer);
 	static pair<unique_ptr<uint8_t[]>, size_t> file_to_buffer(const string& filename);
 	static bool file_to_string(const string& filename, string& str);
@@ -118,6 +202,15 @@ public:
 	//! reads all data as binary from "filename" and returns it as a vector of the specified "data_type"
 	template <typename data_type>
 	static optional<vector<data_type>> file_to_vector(const string& filename) {
+		if (memory_mapped_file mapped_file(filename, memory_mapped_file::ACCESS_HINT::SEQUENTIAL); mapped_file.is_valid()) {
+			const size_t readable_count = mapped_file.size() / sizeof(data_type); // drop last bytes if they don't fit
+			vector<data_type> ret(readable_count);
+			if (readable_count > 0) {
+				memcpy((void*)ret.data(), mapped_file.data(), readable_count * sizeof(data_type));
+			}
+			return ret;
+		}
+		
 		file_io file(filename, file_io::OPEN_TYPE::READ_BINARY);
 		if (!file.is_open()) {
 			return {};
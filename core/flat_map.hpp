@@ -23,11 +23,37 @@
 #include <algorithm>
 #include <vector>
 #include <exception>
+#include <cstdint>
+#include <bit>
+#include <concepts>
+#include <unordered_set>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#endif
 using namespace std;
 
+//! lookup/insertion policy of a flat_map
+enum class FLAT_MAP_POLICY : uint32_t {
+	//! entries are stored in insertion order, O(n) lookup and insert
+	//! NOTE: this is the only policy that supports reference keys and keys that are only equality comparable
+	LINEAR,
+	//! entries are sorted by key (requires operator<), O(log n) lookup, insert is O(log n) + moving all following entries,
+	//! use the vector constructor or insert_batch() to efficiently insert many entries at once (single sort)
+	SORTED,
+	//! entries are stored in insertion order and are additionally indexed by an open addressing hash table
+	//! (requires std::hash<key_type>), O(1) lookup and insert, O(n) erase (the hash table is rebuilt)
+	//! NOTE: small maps (<= max_linear_hashed_size entries) don't build a hash table and are searched linearly
+	HASHED,
+};
+
 //! simple <key, value> map backed by a vector stored contiguously in memory (hence flat map),
-//! technically O(n) lookup and insert, but usually faster than unordered_map or map for small maps
-template <typename key_type, typename value_type> class flat_map {
+//! with the default LINEAR policy: technically O(n) lookup and insert, but usually faster than unordered_map or map for
+//! small maps, for larger maps use the SORTED or HASHED policy (see FLAT_MAP_POLICY)
+//! NOTE: for all policies, entries are stored contiguously and iteration is over the <key, value> entries
+//! NOTE: with the SORTED or HASHED policy, keys must not be modified through iterators
+template <typename key_type, typename value_type, FLAT_MAP_POLICY policy = FLAT_MAP_POLICY::LINEAR> class flat_map {
 public:
 	//! returns true if the key is a reference
 	static constexpr bool is_ref_key() {
@@ -41,16 +67,124 @@ public:
 	//! single <key, value> entry in this map
 	using entry_type = pair<storage_key_type, value_type>;
 	
+	static_assert(policy == FLAT_MAP_POLICY::LINEAR || !is_lvalue_reference_v<key_type>, "reference keys are only supported by the LINEAR policy");
+	
+	//! returns the lookup/insertion policy of this map
+	static constexpr FLAT_MAP_POLICY get_policy() {
+		return policy;
+	}
+	
+	//! with the HASHED policy: max amount of entries for which no hash table is built (linear lookup)
+	static constexpr const size_t max_linear_hashed_size { 8u };
+	//! with the LINEAR policy: max amount of entries for which duplicates are removed by a linear search,
+	//! larger maps use a temporary hash set (if the key type is hashable)
+	static constexpr const size_t max_linear_unique_size { 16u };
+	
+	//! tag type to construct a map from entries whose keys are known to be unique (-> no duplicate removal)
+	struct unique_entries_t {};
+	static constexpr const unique_entries_t unique_entries {};
+
 protected:
 	//! map storage
 	vector<entry_type> data;
 	
+	typedef typename decltype(data)::iterator iterator;
+	typedef typename decltype(data)::const_iterator const_iterator;
+	
+	//! hash table of the HASHED policy:
+	//! "ctrl" contains one control byte per slot (empty_ctrl or the lower 7 bits of the key hash), probing is performed
+	//! on groups of group_size control bytes at once, "slots" contains the entry index of each occupied slot
+	struct hash_index_t {
+		vector<uint8_t> ctrl;
+		vector<uint32_t> slots;
+	};
+	struct no_index_t {};
+	[[no_unique_address]] conditional_t<policy == FLAT_MAP_POLICY::HASHED, hash_index_t, no_index_t> index;
+	
+	static constexpr const uint32_t group_size { 16u };
+	static constexpr const uint8_t empty_ctrl { 0x80u };
+	
 	//! removes all duplicate entries for each unique key in this map
+	//! NOTE: for duplicate keys, the first entry is kept, for the SORTED policy, entries are sorted first,
+	//!       for the HASHED policy, the hash table is rebuilt
 	void unique() {
-		const auto end_iter = unique(begin(), end(), [](const entry_type& kv_1, const entry_type& kv_2) {
-			return (kv_1.first == kv_2.first);
-		});
-		data.erase(end_iter, end());
+		if constexpr (policy == FLAT_MAP_POLICY::HASHED) {
+			auto entries = move(data);
+			data.clear();
+			data.reserve(entries.size());
+			rebuild_index();
+			for (auto& entry : entries) {
+				if (find_index(entry.first) == ~size_t(0)) {
+					data.emplace_back(move(entry));
+					add_last_entry_to_index();
+				}
+			}
+		} else if constexpr (policy == FLAT_MAP_POLICY::SORTED) {
+			stable_sort(begin(), end(), [](const entry_type& kv_1, const entry_type& kv_2) {
+				return (kv_1.first < kv_2.first);
+			});
+			const auto end_iter = std::unique(begin(), end(), [](const entry_type& kv_1, const entry_type& kv_2) {
+				return (kv_1.first == kv_2.first);
+			});
+			data.erase(end_iter, end());
+		} else if constexpr (is_hashable_key()) {
+			if (data.size() > max_linear_unique_size) {
+				// flag duplicates first (the set references the keys, so entries must not be moved yet), then compact
+				struct key_ptr_hash {
+					size_t operator()(const remove_reference_t<key_type>* key) const {
+						return std::hash<remove_cvref_t<key_type>> {}(*key);
+					}
+				};
+				struct key_ptr_equal {
+					bool operator()(const remove_reference_t<key_type>* lhs, const remove_reference_t<key_type>* rhs) const {
+						return (*lhs == *rhs);
+					}
+				};
+				unordered_set<const remove_reference_t<key_type>*, key_ptr_hash, key_ptr_equal> keys;
+				keys.reserve(data.size());
+				vector<bool> is_duplicate(data.size(), false);
+				for (size_t i = 0, count = data.size(); i < count; ++i) {
+					is_duplicate[i] = !keys.emplace(&get_key(data[i].first)).second;
+				}
+				keys.clear();
+				size_t unique_end = 0;
+				for (size_t i = 0, count = data.size(); i < count; ++i) {
+					if (!is_duplicate[i]) {
+						if (i != unique_end) {
+							data[unique_end] = move(data[i]);
+						}
+						++unique_end;
+					}
+				}
+				data.erase(data.begin() + ptrdiff_t(unique_end), data.end());
+			} else {
+				unique_linear();
+			}
+		} else {
+			unique_linear();
+		}
+	}
+	
+	//! LINEAR: removes duplicate entries by comparing each entry against all previously kept entries, O(n^2)
+	void unique_linear() {
+		// NOTE: duplicates are not necessarily adjacent -> compare against all previously kept entries
+		auto unique_end = begin();
+		for (auto iter = begin(); iter != end(); ++iter) {
+			if (find_if(begin(), unique_end, [&iter](const entry_type& entry) {
+				return (get_key(entry.first) == get_key(iter->first));
+			}) == unique_end) {
+				if (iter != unique_end) {
+					*unique_end = move(*iter);
+				}
+				++unique_end;
+			}
+		}
+		data.erase(unique_end, end());
+	}
+	
+	//! returns true if std::hash is available for the key type
+	static constexpr bool is_hashable_key() {
+		return requires (const remove_cvref_t<key_type>& key) { { std::hash<remove_cvref_t<key_type>> {}(key) } -> convertible_to<size_t>; };
 	}
 	
 	//! helper function to get the underlying key type from the storage_key_type
@@ -71,28 +205,157 @@ protected:
 		}
 	}
 	
-public:
-	typedef typename decltype(data)::iterator iterator;
-	typedef typename decltype(data)::const_iterator const_iterator;
+	//! SORTED: returns an iterator to the first entry whose key is not less than 'key'
+	auto lower_bound_iter(const key_type& key) const {
+		return lower_bound(data.cbegin(), data.cend(), key, [](const entry_type& entry, const key_type& cmp_key) {
+			return (entry.first < cmp_key);
+		});
+	}
+	
+	//! returns the index of the entry corresponding to 'key', returns ~0 if not found
+	size_t find_index(const key_type& key) const {
+		if constexpr (policy == FLAT_MAP_POLICY::SORTED) {
+			const auto iter = lower_bound_iter(key);
+			return (iter != data.cend() && !(key < iter->first) ? size_t(iter - data.cbegin()) : ~size_t(0));
+		} else if constexpr (policy == FLAT_MAP_POLICY::HASHED) {
+			if (!index.ctrl.empty()) {
+				const auto hash = hash_key(key);
+				const auto tag = uint8_t(hash & 0x7Fu);
+				const auto group_mask = index.ctrl.size() / group_size - 1u;
+				for (size_t group = (hash >> 7u) & group_mask; ; group = (group + 1u) & group_mask) {
+					const auto group_ctrl = &index.ctrl[group * group_size];
+					for (auto mask = match_group(group_ctrl, tag); mask != 0u; mask &= mask - 1u) {
+						const auto entry_idx = index.slots[group * group_size + uint32_t(countr_zero(mask))];
+						if (data[entry_idx].first == key) {
+							return entry_idx;
+						}
+					}
+					// an empty slot in this group terminates the probe sequence
+					if (match_group(group_ctrl, empty_ctrl) != 0u) {
+						return ~size_t(0);
+					}
+				}
+			}
+		}
+		
+		// LINEAR and small HASHED maps
+		for (size_t i = 0, count = data.size(); i < count; ++i) {
+			if (get_key(data[i].first) == key) {
+				return i;
+			}
+		}
+		return ~size_t(0);
+	}
+	
+	//! inserts a new <key, value> entry, 'key' must not exist in this map yet
+	template <typename insert_key_type, typename insert_value_type>
+	iterator insert_new(insert_key_type&& key, insert_value_type&& value) {
+		if constexpr (policy == FLAT_MAP_POLICY::SORTED) {
+			const auto pos = lower_bound_iter(key);
+			return data.emplace(pos, forward<insert_key_type>(key), forward<insert_value_type>(value));
+		} else {
+			data.emplace_back(forward<insert_key_type>(key), forward<insert_value_type>(value));
+			if constexpr (policy == FLAT_MAP_POLICY::HASHED) {
+				add_last_entry_to_index();
+			}
+			return prev(data.end());
+		}
+	}
+	
+	//! HASHED: hash of a key
+	static size_t hash_key(const key_type& key) {
+		return std::hash<key_type> {}(key);
+	}
+	
+	//! HASHED: returns a bit mask of all control bytes in the group at 'group_ctrl' that are equal to 'value'
+	static uint32_t match_group(const uint8_t* group_ctrl, const uint8_t value) {
+#if defined(__SSE2__)
+		const auto group = _mm_loadu_si128((const __m128i*)group_ctrl);
+		return uint32_t(_mm_movemask_epi8(_mm_cmpeq_epi8(group, _mm_set1_epi8(char(value)))));
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+		static constexpr const uint8_t bit_weights[16] { 1, 2, 4, 8, 16, 32, 64, 128, 1, 2, 4, 8, 16, 32, 64, 128 };
+		const auto matches = vandq_u8(vceqq_u8(vld1q_u8(group_ctrl), vdupq_n_u8(value)), vld1q_u8(bit_weights));
+		return uint32_t(vaddv_u8(vget_low_u8(matches))) | (uint32_t(vaddv_u8(vget_high_u8(matches))) << 8u);
+#else
+		uint32_t mask = 0u;
+		for (uint32_t i = 0; i < group_size; ++i) {
+			mask |= (group_ctrl[i] == value ? (1u << i) : 0u);
+		}
+		return mask;
+#endif
+	}
+	
+	//! HASHED: adds the entry at 'entry_idx' to the hash table (which must have a free slot)
+	void add_to_index(const size_t entry_idx, const size_t hash) {
+		const auto group_mask = index.ctrl.size() / group_size - 1u;
+		for (size_t group = (hash >> 7u) & group_mask; ; group = (group + 1u) & group_mask) {
+			const auto empty_mask = match_group(&index.ctrl[group * group_size], empty_ctrl);
+			if (empty_mask != 0u) {
+				const auto slot = group * group_size + uint32_t(countr_zero(empty_mask));
+				index.ctrl[slot] = uint8_t(hash & 0x7Fu);
+				index.slots[slot] = uint32_t(entry_idx);
+				return;
+			}
+		}
+	}
+	
+	//! HASHED: adds the last entry to the hash table, builds or grows the hash table if necessary
+	void add_last_entry_to_index() {
+		const auto entry_count = data.size();
+		if (index.ctrl.empty()) {
+			if (entry_count > max_linear_hashed_size) {
+				rebuild_index();
+			}
+			return;
+		}
+		// max load factor: 7/8
+		if (entry_count * 8u > index.ctrl.size() * 7u) {
+			rebuild_index();
+			return;
+		}
+		add_to_index(entry_count - 1u, hash_key(data.back().first));
+	}
 	
+	//! HASHED: (re)builds the hash table for all entries, or clears it if there are only a few entries
+	void rebuild_index() {
+		if constexpr (policy == FLAT_MAP_POLICY::HASHED) {
+			const auto entry_count = data.size();
+			if (entry_count <= max_linear_hashed_size) {
+				index.ctrl.clear();
+				index.slots.clear();
+				return;
+			}
+			// start at a load factor of <= 1/2
+			const auto slot_count = std::bit_ceil(std::max(size_t(group_size), entry_count * 2u));
+			index.ctrl.assign(slot_count, empty_ctrl);
+			index.slots.resize(slot_count);
+			for (size_t i = 0; i < entry_count; ++i) {
+				add_to_index(i, hash_key(data[i].first));
+			}
+		}
+	}
+
+public:
 	//! default empty map constructor
 	constexpr flat_map() noexcept = default;
 	
 	//! move construct from another flat_map
-	flat_map(flat_map&& fmap) : data(move(fmap.data)) {}
+	flat_map(flat_map&& fmap) : data(move(fmap.data)), index(move(fmap.index)) {}
 	
 	//! copy construct from another flat_map
-	flat_map(const flat_map& fmap) : data(fmap.data) {}
+	flat_map(const flat_map& fmap) : data(fmap.data), index(fmap.index) {}
 	
 	//! move assignment from another flat_map
 	flat_map& operator=(flat_map&& fmap) {
 		data = move(fmap.data);
+		index = move(fmap.index);
 		return *this;
 	}
 	
 	//! copy assignment from another flat_map
 	flat_map& operator=(const flat_map& fmap) {
 		data = fmap.data;
+		index = fmap.index;
 		return *this;
 	}
 	
@@ -106,6 +369,19 @@ public:
 		unique();
 	}
 	
+	//! move construct through a vector whose keys are already unique (this is not checked),
+	//! e.g.: flat_map(move(entries), flat_map::unique_entries)
+	//! NOTE: with the SORTED policy, entries are still sorted, with the HASHED policy, the hash table is built
+	flat_map(vector<entry_type>&& vec, unique_entries_t) : data(move(vec)) {
+		if constexpr (policy == FLAT_MAP_POLICY::SORTED) {
+			sort(begin(), end(), [](const entry_type& kv_1, const entry_type& kv_2) {
+				return (kv_1.first < kv_2.first);
+			});
+		} else if constexpr (policy == FLAT_MAP_POLICY::HASHED) {
+			rebuild_index();
+		}
+	}
+	
 	//! copy construct through a vector, note that all entries will be uniqued
 	flat_map(const vector<entry_type>& vec) : data(vec) {
 		unique();
@@ -118,7 +394,7 @@ public:
 		if(iter != end()) {
 			return iter->second;
 		}
-		return insert_or_assign(key, value_type {})->second;
+		return insert_new(key, value_type {})->second;
 	}
 	
 	//! look up 'key' and if found, return its associated value,
@@ -171,7 +447,7 @@ public:
 			iter->second = value;
 			return iter;
 		}
-		return data.emplace(end(), key, value);
+		return insert_new(key, value);
 	}
 	
 	//! inserts a new <key, value> pair if no entry for 'key' exists yet and returns pair<true, iterator to it>,
@@ -181,7 +457,7 @@ public:
 		if(iter != end()) {
 			return { false, iter };
 		}
-		return { true, data.emplace(end(), key, value) };
+		return { true, insert_new(key, value) };
 	}
 	
 	//! inserts a new <key, value> pair if no entry for 'key' exists yet and returns pair<true, iterator to it>,
@@ -191,7 +467,7 @@ public:
 		if(iter != end()) {
 			return { false, iter };
 		}
-		return { true, data.emplace(end(), move(key), move(value)) };
+		return { true, insert_new(move(key), move(value)) };
 	}
 	
 	//! inserts a new <key, value> pair if no entry for 'key' exists yet, or replaces the current <key, value> entry if it does,
@@ -202,19 +478,50 @@ public:
 			iter->second = move(value);
 			return iter;
 		}
-		return data.emplace(end(), forward<key_type>(key), forward<value_type>(value));
+		return insert_new(forward<key_type>(key), forward<value_type>(value));
+	}
+	
+	//! inserts all <key, value> entries whose key doesn't exist in this map yet
+	//! (for duplicate keys in 'entries', the first entry is inserted)
+	//! NOTE: with the SORTED and LINEAR policy, entries are appended and duplicates are removed at once
+	void insert_batch(vector<entry_type>&& entries) {
+		if constexpr (policy == FLAT_MAP_POLICY::SORTED || policy == FLAT_MAP_POLICY::LINEAR) {
+			// existing entries come first and stable sort keeps them in front of new entries with the same key
+			data.insert(data.end(), make_move_iterator(entries.begin()), make_move_iterator(entries.end()));
+			unique();
+		} else {
+			for (auto& entry : entries) {
+				if (find_index(entry.first) == ~size_t(0)) {
+					insert_new(move(entry.first), move(entry.second));
+				}
+			}
+		}
 	}
 	
 	//! erases the <key, value> pair at 'iter',
 	//! returns an iterator to the next entry
 	iterator erase(iterator iter) {
-		return data.erase(iter);
+		if constexpr (policy == FLAT_MAP_POLICY::HASHED) {
+			const auto next_idx = iter - data.begin();
+			data.erase(iter);
+			rebuild_index();
+			return data.begin() + next_idx;
+		} else {
+			return data.erase(iter);
+		}
 	}
 	
 	//! erases the <key, value> pairs from 'first' to 'last',
 	//! returns an iterator to the next entry
 	iterator erase(iterator first, iterator last) {
-		return data.erase(first, last);
+		if constexpr (policy == FLAT_MAP_POLICY::HASHED) {
+			const auto next_idx = first - data.begin();
+			data.erase(first, last);
+			rebuild_index();
+			return data.begin() + next_idx;
+		} else {
+			return data.erase(first, last);
+		}
 	}
 	
 	//! erases the <key, value> pair for the specified 'key', returns a <erased flag, iterator> pair set to
@@ -222,23 +529,21 @@ public:
 	pair<bool, iterator> erase(const key_type& key) {
 		const auto iter = find(key);
 		if(iter != end()) {
-			return { true, data.erase(iter) };
+			return { true, erase(iter) };
 		}
 		return { false, end() };
 	}
 	
 	//! returns an iterator to the <key, value> pair corresponding to 'key', returns end() if not found
 	iterator find(const key_type& key) {
-		return find_if(data.begin(), data.end(), [&key](const entry_type& entry) {
-			return (get_key(entry.first) == key);
-		});
+		const auto idx = find_index(key);
+		return (idx != ~size_t(0) ? data.begin() + ptrdiff_t(idx) : data.end());
 	}
 	
 	//! returns a const_iterator to the <key, value> pair corresponding to 'key', returns end() if not found
 	const_iterator find(const key_type& key) const {
-		return find_if(data.cbegin(), data.cend(), [&key](const entry_type& entry) {
-			return (get_key(entry.first) == key);
-		});
+		const auto idx = find_index(key);
+		return (idx != ~size_t(0) ? data.cbegin() + ptrdiff_t(idx) : data.cend());
 	}
 	
 	//! returns 1 if a <key, value> entry for 'key' exists in this map, 0 if not
@@ -255,7 +560,12 @@ public:
 	auto cend() const { return data.cend(); }
 	auto size() const { return data.size(); }
 	auto empty() const { return data.empty(); }
-	auto clear() { data.clear(); }
+	auto clear() {
+		data.clear();
+		if constexpr (policy == FLAT_MAP_POLICY::HASHED) {
+			rebuild_index();
+		}
+	}
 	void reserve(const size_t& count) { data.reserve(count); }
 	
 };
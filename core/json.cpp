@@ -17,10 +17,12 @@
  */
 
 #include <floor/core/json.hpp>
+#include <floor/core/json_writer.hpp>
 #include <floor/core/unicode.hpp>
 #include <floor/core/logger.hpp>
 #include <floor/core/file_io.hpp>
 #include <floor/core/core.hpp>
+#include <bit>
 
 //#define FLOOR_DEBUG_PARSER 1
 //#define FLOOR_DEBUG_PARSER_SET_NAMES 1
@@ -40,7 +42,8 @@ json_value::json_value(const VALUE_TYPE& value_type) : type(value_type) {
 			// nop
 			break;
 		case VALUE_TYPE::OBJECT:
-			new (&this->object) json_object();
+			new (&this->object.members) json_object();
+			new (&this->object.index) shared_ptr<const json_object_index>();
 			break;
 		case VALUE_TYPE::ARRAY:
 			new (&this->array) json_array();
@@ -68,7 +71,8 @@ json_value& json_value::operator=(json_value&& val) {
 			fp_number = val.fp_number;
 			break;
 		case VALUE_TYPE::OBJECT:
-			new (&this->object) json_object(move(val.object.members));
+			new (&this->object.members) json_object(move(val.object.members));
+			new (&this->object.index) shared_ptr<const json_object_index>(move(val.object.index));
 			break;
 		case VALUE_TYPE::ARRAY:
 			new (&this->array) json_array(move(val.array.values));
@@ -97,7 +101,11 @@ json_value& json_value::operator=(const json_value& val) {
 			fp_number = val.fp_number;
 			break;
 		case VALUE_TYPE::OBJECT:
-			new (&this->object) json_object(val.object.members);
+			new (&this->object.members) json_object(val.object.members);
+			// NOTE: each copy gets its own index, since either copy may be modified independently
+			new (&this->object.index) shared_ptr<const json_object_index>(val.object.index ?
+																		  make_shared<const json_object_index>(*val.object.index) :
+																		  nullptr);
 			break;
 		case VALUE_TYPE::ARRAY:
 			new (&this->array) json_array(val.array.values);
@@ -118,6 +126,7 @@ json_value::~json_value() {
 			// nop
 			break;
 		case VALUE_TYPE::OBJECT:
+			object.index.~shared_ptr();
 			object.members.~flat_map();
 			break;
 		case VALUE_TYPE::ARRAY:
@@ -128,6 +137,90 @@ json_value::~json_value() {
 			break;
 	}
 }
+const json_value* json_value::find_member(const string_view name, const uint64_t name_hash) const {
+	if (type != VALUE_TYPE::OBJECT) {
+		return nullptr;
+	}
+	
+	// use the hash index if there is one and it is in sync with the members: hits are verified against the actual
+	// member name, a miss means there is no such member
+	// NOTE: if the member count changed since the index was built, the index is stale -> use the linear search below
+	if (object.index && object.index->hashes.size() == object.members.size()) {
+		const auto& slots = object.index->slots;
+		const auto& hashes = object.index->hashes;
+		const auto mask = slots.size() - 1u;
+		for (size_t slot_idx = (name_hash & mask); ; slot_idx = (slot_idx + 1u) & mask) {
+			const auto slot = slots[slot_idx];
+			if (slot == 0u) {
+				return nullptr;
+			}
+			const auto& member = *(object.members.begin() + ptrdiff_t(slot - 1u));
+			if (hashes[slot - 1u] == name_hash && member.first == name) {
+				return &member.second;
+			}
+		}
+	}
+	
+	for (const auto& member : object.members) {
+		if (member.first == name) {
+			return &member.second;
+		}
+	}
+	return nullptr;
+}
+
+const json_value* json_value::find(const json_path& path) const {
+	if (!path.is_valid()) {
+		return nullptr;
+	}
+	const json_value* cur_node = this;
+	for (const auto& seg : path) {
+		cur_node = cur_node->find_member(seg.name, seg.hash);
+		if (cur_node == nullptr) {
+			return nullptr;
+		}
+	}
+	return cur_node;
+}
+
+void json_value::build_member_index(const size_t min_member_count) {
+	if (type == VALUE_TYPE::ARRAY) {
+		for (auto& value : array.values) {
+			value.build_member_index(min_member_count);
+		}
+		return;
+	}
+	if (type != VALUE_TYPE::OBJECT) {
+		return;
+	}
+	
+	for (auto& member : object.members) {
+		member.second.build_member_index(min_member_count);
+	}
+	
+	const auto member_count = object.members.size();
+	if (member_count < min_member_count || member_count == 0) {
+		object.index = nullptr;
+		return;
+	}
+	
+	// keep the load factor <= 50%
+	auto index = make_shared<json_object_index>();
+	index->slots.resize(std::bit_ceil(member_count * 2u), 0u);
+	index->hashes.reserve(member_count);
+	const auto mask = index->slots.size() - 1u;
+	for (size_t i = 0; i < member_count; ++i) {
+		const auto name_hash = json_path::hash((object.members.begin() + ptrdiff_t(i))->first);
+		index->hashes.emplace_back(name_hash);
+		size_t slot_idx = (name_hash & mask);
+		while (index->slots[slot_idx] != 0u) {
+			slot_idx = (slot_idx + 1u) & mask;
+		}
+		index->slots[slot_idx] = uint32_t(i + 1u);
+	}
+	object.index = move(index);
+}
+
 void json_value::print(const uint32_t depth) const {
 	switch(type) {
 		case VALUE_TYPE::NULL_VALUE:
@@ -180,6 +273,12 @@ void json_value::print(const uint32_t depth) const {
 	if(depth == 0) cout << endl;
 }
 
+string json_value::to_string(const bool pretty) const {
+	json_writer writer(pretty);
+	writer.value(*this);
+	return writer.take_string();
+}
+
 class json_lexer final : public lexer {
 public:
 	static bool lex(translation_unit& tu);
@@ -772,10 +871,9 @@ struct json_grammar {
 						}
 						case SOURCE_TOKEN_TYPE::STRING_LITERAL: {
 							json_value val { json_value::VALUE_TYPE::STRING };
-							val.str = token->second.to_string();
-							// remove " from front and back
-							val.str.erase(val.str.begin());
-							val.str.pop_back();
+							// remove " from front and back, decode escape sequences
+							const auto token_str = token->second.to_string();
+							unescape_string(string_view(token_str).substr(1, token_str.size() - 2), val.str);
 							return { make_unique<value_node>(move(val)) };
 						}
 						default:
@@ -838,10 +936,10 @@ struct json_grammar {
 		member_list.on_match(push_to_parent_even);
 		member.on_match([](auto& matches) -> parser_context::match_list {
 			if(matches.size() == 3) {
-				// remove " from front and back of key
-				auto key = matches[0].token->second.to_string();
-				key.erase(key.begin());
-				key.pop_back();
+				// remove " from front and back of key, decode escape sequences
+				const auto token_str = matches[0].token->second.to_string();
+				string key;
+				unescape_string(string_view(token_str).substr(1, token_str.size() - 2), key);
 				return { make_unique<member_node>(move(key), move(matches[2].ast_node)) };
 			}
 			log_error("invalid member match size: $!", matches.size());
@@ -895,7 +993,102 @@ struct json_grammar {
 	}
 };
 
+//! returns the value of the hex digit "ch" (must be valid)
+static uint32_t hex_digit_value(const char ch) {
+	if(ch >= '0' && ch <= '9') return uint32_t(ch - '0');
+	if(ch >= 'a' && ch <= 'f') return uint32_t(ch - 'a') + 10u;
+	return uint32_t(ch - 'A') + 10u;
+}
+
+//! reads the 4 hex digits of a \u escape sequence starting at "ptr"
+static uint32_t read_utf16_code_unit(const char* ptr) {
+	return ((hex_digit_value(ptr[0]) << 12u) | (hex_digit_value(ptr[1]) << 8u) |
+			(hex_digit_value(ptr[2]) << 4u) | hex_digit_value(ptr[3]));
+}
+
+void unescape_string(const string_view str, string& dst) {
+	dst.reserve(dst.size() + str.size());
+	const char* ptr = str.data();
+	const char* const str_end = str.data() + str.size();
+	while(ptr != str_end) {
+		// append runs of chars that don't need decoding at once
+		const auto esc_ptr = (const char*)memchr(ptr, '\\', size_t(str_end - ptr));
+		if(esc_ptr == nullptr) {
+			dst.append(ptr, str_end);
+			break;
+		}
+		dst.append(ptr, esc_ptr);
+		ptr = esc_ptr + 1;
+		if(ptr == str_end) {
+			break;
+		}
+		switch(*ptr++) {
+			case '\"': dst += '\"'; break;
+			case '\\': dst += '\\'; break;
+			case '/': dst += '/'; break;
+			case 'b': dst += '\b'; break;
+			case 'f': dst += '\f'; break;
+			case 'n': dst += '\n'; break;
+			case 'r': dst += '\r'; break;
+			case 't': dst += '\t'; break;
+			case 'u': {
+				if(str_end - ptr < 4) {
+					ptr = str_end;
+					break;
+				}
+				uint32_t code_point = read_utf16_code_unit(ptr);
+				ptr += 4;
+				if(code_point >= 0xD800u && code_point <= 0xDBFFu) {
+					// high surrogate: must be followed by a \u low surrogate
+					if(str_end - ptr >= 6 && ptr[0] == '\\' && ptr[1] == 'u') {
+						const auto low = read_utf16_code_unit(ptr + 2);
+						if(low >= 0xDC00u && low <= 0xDFFFu) {
+							code_point = 0x10000u + ((code_point - 0xD800u) << 10u) + (low - 0xDC00u);
+							ptr += 6;
+						} else {
+							code_point = 0xFFFDu;
+						}
+					} else {
+						code_point = 0xFFFDu;
+					}
+				} else if(code_point >= 0xDC00u && code_point <= 0xDFFFu) {
+					// unpaired low surrogate
+					code_point = 0xFFFDu;
+				}
+				
+				// encode as utf-8
+				if(code_point < 0x80u) {
+					dst += char(code_point);
+				} else if(code_point < 0x800u) {
+					dst += char(0xC0u | (code_point >> 6u));
+					dst += char(0x80u | (code_point & 0x3Fu));
+				} else if(code_point < 0x10000u) {
+					dst += char(0xE0u | (code_point >> 12u));
+					dst += char(0x80u | ((code_point >> 6u) & 0x3Fu));
+					dst += char(0x80u | (code_point & 0x3Fu));
+				} else {
+					dst += char(0xF0u | (code_point >> 18u));
+					dst += char(0x80u | ((code_point >> 12u) & 0x3Fu));
+					dst += char(0x80u | ((code_point >> 6u) & 0x3Fu));
+					dst += char(0x80u | (code_point & 0x3Fu));
+				}
+				break;
+			}
+			default:
+				// invalid escape sequence (can't happen for validated strings) -> keep as-is
+				dst += '\\';
+				dst += *(ptr - 1);
+				break;
+		}
+	}
+}
+
 document create_document(const string& filename) {
+	// parse directly from a read-only mapping of the file (all values are copied into the document)
+	if(memory_mapped_file mapped_file(filename, memory_mapped_file::ACCESS_HINT::SEQUENTIAL); mapped_file.is_valid()) {
+		return create_document_from_string(mapped_file.get_string_view(), filename);
+	}
+	
 	string json_data;
 	if(!file_io::file_to_string(filename, json_data)) {
 		log_error("failed to read json file \"$\"!", filename);
@@ -904,7 +1097,7 @@ document create_document(const string& filename) {
 	return create_document_from_string(json_data, filename);
 }
 
-document create_document_from_string(const string& json_data, const string identifier) {
+document create_document_from_string_grammar(const string& json_data, const string identifier) {
 	const auto is_valid_utf8 = unicode::validate_utf8_string(json_data);
 	if(!is_valid_utf8.first) {
 		log_error("JSON data \"$\" is not UTF-8 encoded or contains invalid UTF-8 code points!",
@@ -935,7 +1128,7 @@ document create_document_from_string(const string& json_data, const string ident
 	return doc;
 }
 
-template <typename T> static pair<bool, T> extract_value(const document& doc, const string& path) {
+template <typename T> static pair<bool, T> extract_value(const document& doc, const json_path& path) {
 	// empty path -> return root value
 	if(path.empty()) {
 		const auto ret = doc.root.get<T>();
@@ -943,43 +1136,40 @@ template <typename T> static pair<bool, T> extract_value(const document& doc, co
 		return ret;
 	}
 	
+	if(!path.is_valid()) {
+		log_error("path \"$\" has too many segments (max: $)!", path.get_path(), json_path::max_segment_count);
+		return { false, T {} };
+	}
+	
 	// check if root is actually an object that we can traverse
 	if(doc.root.type != json_value::VALUE_TYPE::OBJECT) {
 		log_error("root value is not an object!");
 		return { false, T {} };
 	}
 	
-	// tokenize input path, then traverse
-	const auto path_stack = core::tokenize(path, '.');
+	// traverse
 	const json_value* cur_node = &doc.root;
-	for(size_t i = 0, count = path_stack.size(); i < count; ++i) {
-		const auto& key = path_stack[i];
-		bool found = false;
-		for(const auto& member : cur_node->object.members) {
-			if(member.first == key) {
-				// is leaf?
-				if(i == count - 1) {
-					const auto ret = member.second.get<T>();
-					if(!ret.first) {
-						log_error("type mismatch: value of \"$\" is not of the requested type!", path);
-					}
-					return ret;
-				}
-				// set to next child node
-				cur_node = &member.second;
-				found = true;
-				break;
-			}
-		}
+	for(uint32_t i = 0, count = path.size(); i < count; ++i) {
+		const auto& seg = path[i];
+		cur_node = cur_node->find_member(seg.name, seg.hash);
 		
 		// didn't find it -> abort
-		if(!found) {
+		if(cur_node == nullptr) {
 			return { false, T {} };
 		}
 		
+		// is leaf?
+		if(i == count - 1) {
+			const auto ret = cur_node->get<T>();
+			if(!ret.first) {
+				log_error("type mismatch: value of \"$\" is not of the requested type!", path.get_path());
+			}
+			return ret;
+		}
+		
 		// check if child node is actually a json object
 		if(cur_node->type != json_value::VALUE_TYPE::OBJECT) {
-			log_error("found child node ($) is not a json object (path: $)!", key, path);
+			log_error("found child node ($) is not a json object (path: $)!", seg.name, path.get_path());
 			return { false, T {} };
 		}
 	}
@@ -987,42 +1177,83 @@ template <typename T> static pair<bool, T> extract_value(const document& doc, co
 }
 
 template<> string document::get<string>(const string& path, const string default_value) const {
-	const auto ret = extract_value<string>(*this, path);
+	const auto ret = extract_value<string>(*this, json_path(path));
 	return (ret.first ? ret.second : default_value);
 }
 template<> float document::get<float>(const string& path, const float default_value) const {
-	const auto ret = extract_value<float>(*this, path);
+	const auto ret = extract_value<float>(*this, json_path(path));
 	return (ret.first ? ret.second : default_value);
 }
 template<> double document::get<double>(const string& path, const double default_value) const {
-	const auto ret = extract_value<double>(*this, path);
+	const auto ret = extract_value<double>(*this, json_path(path));
 	return (ret.first ? ret.second : default_value);
 }
 template<> uint64_t document::get<uint64_t>(const string& path, const uint64_t default_value) const {
-	const auto ret = extract_value<uint64_t>(*this, path);
+	const auto ret = extract_value<uint64_t>(*this, json_path(path));
 	return (ret.first ? ret.second : default_value);
 }
 template<> int64_t document::get<int64_t>(const string& path, const int64_t default_value) const {
-	const auto ret = extract_value<int64_t>(*this, path);
+	const auto ret = extract_value<int64_t>(*this, json_path(path));
 	return (ret.first ? ret.second : default_value);
 }
 template<> uint32_t document::get<uint32_t>(const string& path, const uint32_t default_value) const {
-	const auto ret = extract_value<uint32_t>(*this, path);
+	const auto ret = extract_value<uint32_t>(*this, json_path(path));
 	return (ret.first ? ret.second : default_value);
 }
 template<> int32_t document::get<int32_t>(const string& path, const int32_t default_value) const {
-	const auto ret = extract_value<int32_t>(*this, path);
+	const auto ret = extract_value<int32_t>(*this, json_path(path));
 	return (ret.first ? ret.second : default_value);
 }
 template<> bool document::get<bool>(const string& path, const bool default_value) const {
-	const auto ret = extract_value<bool>(*this, path);
+	const auto ret = extract_value<bool>(*this, json_path(path));
 	return (ret.first ? ret.second : default_value);
 }
 template<> json_object document::get<json_object>(const string& path, const json_object default_value) const {
-	const auto ret = extract_value<json_object>(*this, path);
+	const auto ret = extract_value<json_object>(*this, json_path(path));
 	return (ret.first ? ret.second : default_value);
 }
 template<> json_array document::get<vector<json_value>>(const string& path, const json_array default_value) const {
+	const auto ret = extract_value<json_array>(*this, json_path(path));
+	return (ret.first ? ret.second : default_value);
+}
+
+template<> string document::get<string>(const json_path& path, const string default_value) const {
+	const auto ret = extract_value<string>(*this, path);
+	return (ret.first ? ret.second : default_value);
+}
+template<> float document::get<float>(const json_path& path, const float default_value) const {
+	const auto ret = extract_value<float>(*this, path);
+	return (ret.first ? ret.second : default_value);
+}
+template<> double document::get<double>(const json_path& path, const double default_value) const {
+	const auto ret = extract_value<double>(*this, path);
+	return (ret.first ? ret.second : default_value);
+}
+template<> uint64_t document::get<uint64_t>(const json_path& path, const uint64_t default_value) const {
+	const auto ret = extract_value<uint64_t>(*this, path);
+	return (ret.first ? ret.second : default_value);
+}
+template<> int64_t document::get<int64_t>(const json_path& path, const int64_t default_value) const {
+	const auto ret = extract_value<int64_t>(*this, path);
+	return (ret.first ? ret.second : default_value);
+}
+template<> uint32_t document::get<uint32_t>(const json_path& path, const uint32_t default_value) const {
+	const auto ret = extract_value<uint32_t>(*this, path);
+	return (ret.first ? ret.second : default_value);
+}
+template<> int32_t document::get<int32_t>(const json_path& path, const int32_t default_value) const {
+	const auto ret = extract_value<int32_t>(*this, path);
+	return (ret.first ? ret.second : default_value);
+}
+template<> bool document::get<bool>(const json_path& path, const bool default_value) const {
+	const auto ret = extract_value<bool>(*this, path);
+	return (ret.first ? ret.second : default_value);
+}
+template<> json_object document::get<json_object>(const json_path& path, const json_object default_value) const {
+	const auto ret = extract_value<json_object>(*this, path);
+	return (ret.first ? ret.second : default_value);
+}
+template<> json_array document::get<vector<json_value>>(const json_path& path, const json_array default_value) const {
 	const auto ret = extract_value<json_array>(*this, path);
 	return (ret.first ? ret.second : default_value);
 }
@@ -27,6 +27,102 @@ namespace json {
 	typedef flat_map<string, json_value> json_object;
 	typedef vector<json_value> json_array;
 	
+	//! pre-parsed ("compiled") json value path "node.subnode.key" with pre-computed hashes of all path segments,
+	//! lookups using this neither need to tokenize the path nor allocate any memory
+	//! NOTE: path segments only reference the path string, i.e. the path string must outlive this
+	//! NOTE: when used with a string literal in a constexpr context, the path is parsed at compile-time, e.g.:
+	//!       static constexpr const json::json_path width_path { "screen.width" };
+	class json_path {
+	public:
+		//! max amount of segments a path may consist of
+		static constexpr const uint32_t max_segment_count { 32u };
+		
+		struct segment {
+			string_view name;
+			uint64_t hash { 0u };
+		};
+		
+		//! 64-bit FNV-1a hash of a path segment / object member name
+		static constexpr uint64_t hash(const string_view name) noexcept {
+			uint64_t ret = 0xCBF29CE484222325ull;
+			for (const auto& ch : name) {
+				ret ^= uint64_t(uint8_t(ch));
+				ret *= 0x100000001B3ull;
+			}
+			return ret;
+		}
+		
+		//! empty path: refers to the root value
+		constexpr json_path() noexcept = default;
+		
+		//! parses the specified path (segments are separated by '.', an empty path refers to the root value)
+		constexpr explicit json_path(const string_view path_) noexcept : path(path_) {
+			if (path.empty()) {
+				return;
+			}
+			size_t start = 0;
+			for (;;) {
+				if (segment_count == max_segment_count) {
+					valid = false;
+					return;
+				}
+				const auto end = path.find('.', start);
+				const auto name = path.substr(start, (end == string_view::npos ? string_view::npos : end - start));
+				segments[segment_count++] = { name, hash(name) };
+				if (end == string_view::npos) {
+					break;
+				}
+				start = end + 1;
+			}
+		}
+		
+		//! returns the full path string
+		constexpr const string_view& get_path() const noexcept {
+			return path;
+		}
+		
+		//! returns false if the path has too many segments (> max_segment_count)
+		constexpr bool is_valid() const noexcept {
+			return valid;
+		}
+		
+		//! returns true if this refers to the root value
+		constexpr bool empty() const noexcept {
+			return (segment_count == 0);
+		}
+		
+		//! returns the amount of path segments
+		constexpr uint32_t size() const noexcept {
+			return segment_count;
+		}
+		
+		constexpr const segment& operator[](const size_t idx) const noexcept {
+			return segments[idx];
+		}
+		constexpr const segment* begin() const noexcept {
+			return segments.data();
+		}
+		constexpr const segment* end() const noexcept {
+			return segments.data() + segment_count;
+		}
+	
+	protected:
+		string_view path;
+		array<segment, max_segment_count> segments {};
+		uint32_t segment_count { 0u };
+		bool valid { true };
+	
+	};
+	
+	//! optional hash index over the members of a json object (see json_value::build_member_index)
+	struct json_object_index {
+		//! open addressing hash table (power-of-two size, linear probing),
+		//! each slot contains the member index + 1 (0 signals an empty slot)
+		vector<uint32_t> slots;
+		//! json_path::hash of each member name (in member order)
+		vector<uint64_t> hashes;
+	};
+	
 	//! json value (keyword, object, array, number or string)
 	struct json_value {
 		enum class VALUE_TYPE : uint32_t {
@@ -44,6 +140,11 @@ namespace json {
 		union {
 			struct {
 				json_object members;
+				//! optional member hash index, nullptr if none has been built
+				//! NOTE: the index is trusted as long as the member count is unchanged, i.e. if members are added or removed
+				//!       after the index has been built, lookups fall back to a linear search until it is rebuilt,
+				//!       if members are renamed or reordered, the index must be rebuilt (or reset) before the next lookup
+				shared_ptr<const json_object_index> index;
 			} object;
 			struct {
 				json_array values;
@@ -152,8 +253,29 @@ namespace json {
 			return ret.second;
 		}
 		
+		//! if this is an object: returns the member with the specified name or nullptr if there is no such member,
+		//! returns nullptr if this is not an object
+		//! NOTE: "name_hash" must be json_path::hash(name), this uses the member hash index if one has been built
+		const json_value* find_member(const string_view name, const uint64_t name_hash) const;
+		const json_value* find_member(const string_view name) const {
+			return find_member(name, json_path::hash(name));
+		}
+		
+		//! returns the value at the specified path relative to this value (or this value if the path is empty),
+		//! returns nullptr if there is no value at the path
+		const json_value* find(const json_path& path) const;
+		
+		//! builds member hash indices for this object and all contained objects (also inside arrays)
+		//! that have at least "min_member_count" members, other objects use linear member lookup
+		//! NOTE: this is optional and only worthwhile for large objects that are queried repeatedly
+		void build_member_index(const size_t min_member_count = 16u);
+		
 		void print(const uint32_t depth = 0) const;
 		
+		//! serializes this value (and all its children) into a json string (compact or pretty-printed)
+		//! NOTE: use json_writer to directly write into a file or to write without building a json_value tree
+		string to_string(const bool pretty = false) const;
+		
 		constexpr json_value() noexcept : type(VALUE_TYPE::NULL_VALUE), int_number(0) {}
 		json_value(json_value&& val);
 		json_value& operator=(json_value&& val);
@@ -190,6 +312,22 @@ namespace json {
 		template<typename T> T get(const string& path,
 								   const T default_val = default_value<T>::def()) const;
 		
+		//! returns the value of the key specified by the pre-parsed "path",
+		//! or the root node if path is empty
+		//! NOTE: prefer this for repeated lookups (no path parsing, no allocations)
+		template<typename T> T get(const json_path& path,
+								   const T default_val = default_value<T>::def()) const;
+		
+		//! returns the value at the specified path or nullptr if there is no value at the path
+		const json_value* find(const json_path& path) const {
+			return root.find(path);
+		}
+		
+		//! builds member hash indices for all objects in this document that have at least "min_member_count" members
+		void build_member_index(const size_t min_member_count = 16u) {
+			root.build_member_index(min_member_count);
+		}
+		
 		//! dumps the document to cout
 		void print() const {
 			root.print();
@@ -201,7 +339,20 @@ namespace json {
 	
 	//! creates a json document from the in-memory json data
 	//! 'identifier' is used for error reporting/identification
-	document create_document_from_string(const string& json_data, const string identifier = "");
+	//! NOTE: this uses a single-pass parser that directly builds the document
+	document create_document_from_string(const string_view json_data, const string identifier = "");
+	
+	//! decodes all escape sequences of the json string literal content "str" (without the enclosing quotes)
+	//! and appends the resulting utf-8 string to "dst"
+	//! NOTE: "str" must only contain valid escape sequences (as validated by the parsers),
+	//!       unpaired utf-16 surrogates are decoded as U+FFFD
+	void unescape_string(const string_view str, string& dst);
+	
+	//! creates a json document from the in-memory json data using the generic lexer + grammar (lang) machinery,
+	//! 'identifier' is used for error reporting/identification
+	//! NOTE: this is a lot slower and uses a lot more memory than create_document_from_string, but produces
+	//!       the same document and is kept for diagnostic purposes (e.g. when debugging the parser)
+	document create_document_from_string_grammar(const string& json_data, const string identifier = "");
 
 } // json
 
@@ -249,4 +400,15 @@ template<> bool json::document::get<bool>(const string& path, const bool default
 template<> json::json_object json::document::get<json::json_object>(const string& path, const json::json_object default_value) const;
 template<> json::json_array json::document::get<json::json_array>(const string& path, const json::json_array default_value) const;
 
+template<> string json::document::get<string>(const json::json_path& path, const string default_value) const;
+template<> float json::document::get<float>(const json::json_path& path, const float default_value) const;
+template<> double json::document::get<double>(const json::json_path& path, const double default_value) const;
+template<> uint64_t json::document::get<uint64_t>(const json::json_path& path, const uint64_t default_value) const;
+template<> int64_t json::document::get<int64_t>(const json::json_path& path, const int64_t default_value) const;
+template<> uint32_t json::document::get<uint32_t>(const json::json_path& path, const uint32_t default_value) const;
+template<> int32_t json::document::get<int32_t>(const json::json_path& path, const int32_t default_value) const;
+template<> bool json::document::get<bool>(const json::json_path& path, const bool default_value) const;
+template<> json::json_object json::document::get<json::json_object>(const json::json_path& path, const json::json_object default_value) const;
+template<> json::json_array json::document::get<json::json_array>(const json::json_path& path, const json::json_array default_value) const;
+
 #endif
@@ -0,0 +1,747 @@
+/*
+ *  Flo's Open libRary (floor)
+ *  Copyright (C) 2004 - 2022 Florian Ziesche
+ *  
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; version 2 of the License only.
+ *  
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <floor/core/json.hpp>
+#include <floor/core/json_view.hpp>
+#include <floor/core/unicode.hpp>
+#include <floor/core/logger.hpp>
+#include <charconv>
+#include <bit>
+#include <unordered_set>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
+namespace json {
+
+//! single-pass recursive descent json parser that directly builds the json_value DOM (no tokens, no AST)
+//! or the arena-allocated json_view_value DOM of a view_document
+//! NOTE: this accepts the same json dialect as the lexer/grammar based parser (incl. '#', '//' and '/* */' comments)
+//!       and produces the same DOM: escape sequences in string values and member names are decoded (strings that
+//!       don't contain any escape sequences are referenced/copied as-is); for duplicate member names, the first one is kept
+template <typename value_type>
+class json_fast_parser {
+public:
+	static constexpr const bool is_view { is_same_v<value_type, json_view_value> };
+	
+	json_fast_parser(const string_view json_data, const string& identifier_) noexcept :
+	src_begin(json_data.data()), src_end(json_data.data() + json_data.size()), iter(src_begin), identifier(identifier_) {}
+	
+	//! builds a view document: all values are allocated from "arena_", strings and member names either reference
+	//! the json data or are copied into the arena
+	json_fast_parser(const string_view json_data, const string& identifier_, json_arena& arena_, const bool copy_strings_)
+	noexcept requires(is_view) : json_fast_parser(json_data, identifier_) {
+		arena = &arena_;
+		copy_strings = copy_strings_;
+	}
+	
+	template <typename doc_type>
+	bool parse(doc_type& doc, value_type& root) {
+		if (!skip_whitespace()) {
+			return report_error();
+		}
+		if (iter == src_end) {
+			// empty document (or only whitespace/comments) -> valid null document (same as the grammar based parser)
+			doc.valid = true;
+			return true;
+		}
+		if (!parse_value(root)) {
+			return report_error();
+		}
+		if (!skip_whitespace()) {
+			return report_error();
+		}
+		if (iter != src_end) {
+			set_error(iter, "unexpected data after the json value");
+			return report_error();
+		}
+		doc.valid = true;
+		return true;
+	}
+
+protected:
+	const char* const src_begin;
+	const char* const src_end;
+	const char* iter;
+	const string& identifier;
+	
+	//! position and message of the (first) error
+	const char* error_pos { nullptr };
+	const char* error_msg { nullptr };
+	
+	//! current object/array nesting depth
+	uint32_t depth { 0u };
+	//! max supported nesting depth (guards against stack overflows)
+	static constexpr const uint32_t max_depth { 1024u };
+	
+	//! max amount of object members for which duplicate member names are searched linearly
+	static constexpr const size_t max_linear_dedup_member_count { 16u };
+	
+	// only used when building a view document
+	json_arena* arena { nullptr };
+	bool copy_strings { false };
+	//! array values/object members are gathered here (all nesting levels share these) and are copied into the arena
+	//! once the array/object is complete
+	vector<json_view_value> value_stack;
+	vector<json_view_member> member_stack;
+	//! arena copies of all member names (when copying strings)
+	unordered_set<string_view> interned_names;
+	//! scratch buffer for decoding strings that contain escape sequences
+	string unescape_buffer;
+	
+	bool set_error(const char* pos, const char* msg) {
+		if (error_msg == nullptr) {
+			error_pos = pos;
+			error_msg = msg;
+		}
+		return false;
+	}
+	
+	//! logs the error (incl. line and column), always returns false
+	bool report_error() const {
+		const auto pos = (error_pos != nullptr ? error_pos : iter);
+		
+		// compute line and column (only done on error -> linear scan is fine)
+		uint32_t line = 1u;
+		const char* line_start = src_begin;
+		for (const char* ptr = src_begin; ptr < pos; ++ptr) {
+			if (*ptr == '\n' || (*ptr == '\r' && (ptr + 1 == src_end || *(ptr + 1) != '\n'))) {
+				++line;
+				line_start = ptr + 1;
+			}
+		}
+		const auto column = uint32_t(pos - line_start) + 1u;
+		log_error("$:$:$: error: $", identifier, line, column, (error_msg != nullptr ? error_msg : "parsing failed"));
+		
+		// print erroneous line and '^' at the erroneous character
+		const char* line_end = line_start;
+		while (line_end < src_end && *line_end != '\n' && *line_end != '\r') {
+			++line_end;
+		}
+		log_undecorated("$", string(line_start, line_end));
+		log_undecorated("$^", string(column - 1u, ' '));
+		return false;
+	}
+	
+	//! skips whitespace and comments, returns false on an unterminated comment
+	floor_inline_always bool skip_whitespace() {
+		while (iter != src_end) {
+			switch (*iter) {
+				case ' ': case '\t': case '\n': case '\r':
+					++iter;
+					break;
+				case '#': case '/':
+					if (!skip_comment()) {
+						return false;
+					}
+					break;
+				default:
+					return true;
+			}
+		}
+		return true;
+	}
+	
+	floor_noinline bool skip_comment() {
+		bool is_single_line = true;
+		if (*iter == '/') {
+			if (iter + 1 == src_end) {
+				return set_error(iter, "invalid '/' at EOF");
+			}
+			if (*(iter + 1) == '*') {
+				is_single_line = false;
+			} else if (*(iter + 1) != '/') {
+				return set_error(iter, "invalid '/' character - expected a comment?");
+			}
+			iter += 2;
+		} else {
+			// '#'
+			++iter;
+		}
+		
+		if (is_single_line) {
+			// newline or EOF signals the end of a single-line comment
+			while (iter != src_end && *iter != '\n' && *iter != '\r') {
+				if (!skip_char_in_comment()) {
+					return false;
+				}
+			}
+			return true;
+		}
+		
+		const auto comment_start = iter - 2;
+		while (iter != src_end) {
+			if (*iter == '*' && iter + 1 != src_end && *(iter + 1) == '/') {
+				iter += 2;
+				return true;
+			}
+			if (!skip_char_in_comment()) {
+				return false;
+			}
+		}
+		return set_error(comment_start, "unterminated /* comment (premature EOF)");
+	}
+	
+	//! skips a single (possibly utf-8 encoded) char inside a comment
+	floor_inline_always bool skip_char_in_comment() {
+		if (uint8_t(*iter) < 0x80u) {
+			++iter;
+			return true;
+		}
+		auto utf8_iter = iter;
+		if (!unicode::decode_utf8_char(utf8_iter, src_end).first) {
+			return set_error(iter, "invalid utf-8 code point inside comment");
+		}
+		iter = utf8_iter + 1;
+		return true;
+	}
+	
+	bool parse_value(value_type& val) {
+		switch (*iter) {
+			case '{':
+				return parse_object(val);
+			case '[':
+				return parse_array(val);
+			case '\"': {
+				string_view str;
+				bool has_escapes = false;
+				if (!parse_string(str, has_escapes)) {
+					return false;
+				}
+				if constexpr (is_view) {
+					return make_view_string(val, str, has_escapes);
+				} else {
+					val = json_value { json_value::VALUE_TYPE::STRING };
+					if (has_escapes) {
+						unescape_string(str, val.str);
+					} else {
+						val.str.assign(str);
+					}
+					return true;
+				}
+			}
+			case '-':
+			case '0': case '1': case '2': case '3': case '4':
+			case '5': case '6': case '7': case '8': case '9':
+				return parse_number(val);
+			case 'n':
+				return parse_keyword(val, "null", json_value::VALUE_TYPE::NULL_VALUE);
+			case 't':
+				return parse_keyword(val, "true", json_value::VALUE_TYPE::TRUE_VALUE);
+			case 'f':
+				return parse_keyword(val, "false", json_value::VALUE_TYPE::FALSE_VALUE);
+			default:
+				return set_error(iter, (uint8_t(*iter) < 0x80u ? "invalid character - expected a json value" :
+										"invalid non-ascii character outside of a string literal"));
+		}
+	}
+	
+	template <size_t len>
+	bool parse_keyword(value_type& val, const char (&keyword)[len], const json_value::VALUE_TYPE type) {
+		static constexpr const size_t keyword_len { len - 1u /* \0 */ };
+		if (size_t(src_end - iter) < keyword_len || memcmp(iter, keyword, keyword_len) != 0) {
+			return set_error(iter, type == json_value::VALUE_TYPE::NULL_VALUE ? "invalid keyword - expected 'null'!" :
+							 type == json_value::VALUE_TYPE::TRUE_VALUE ? "invalid keyword - expected 'true'!" :
+							 "invalid keyword - expected 'false'!");
+		}
+		iter += keyword_len;
+		val = value_type { type };
+		return true;
+	}
+	
+	//! advances "iter" over all digits, returns false if there was no digit
+	floor_inline_always bool parse_digits() {
+		const auto start = iter;
+		while (iter != src_end && *iter >= '0' && *iter <= '9') {
+			++iter;
+		}
+		if (iter == start) {
+			return set_error(iter, "expected a digit");
+		}
+		return true;
+	}
+	
+	bool parse_number(value_type& val) {
+		// ref: https://tools.ietf.org/rfc/rfc7159.txt
+		const auto start = iter;
+		bool is_fp = false;
+		if (*iter == '-') {
+			++iter;
+		}
+		// NOTE: leading zeros are not allowed ("0123" fails when parsing the next value/delimiter)
+		if (iter != src_end && *iter == '0') {
+			++iter;
+		} else if (!parse_digits()) {
+			return false;
+		}
+		// frac
+		if (iter != src_end && *iter == '.') {
+			++iter;
+			is_fp = true;
+			if (!parse_digits()) {
+				return false;
+			}
+		}
+		// exp
+		if (iter != src_end && (*iter == 'e' || *iter == 'E')) {
+			++iter;
+			is_fp = true;
+			if (iter != src_end && (*iter == '-' || *iter == '+')) {
+				++iter;
+			}
+			if (!parse_digits()) {
+				return false;
+			}
+		}
+		
+		if (!is_fp) {
+			int64_t int_number = 0;
+			const auto [ptr, ec] = from_chars(start, iter, int_number);
+			if (ec == errc {} && ptr == iter) {
+				val = value_type { json_value::VALUE_TYPE::INT_NUMBER };
+				val.int_number = int_number;
+				return true;
+			}
+			// else: out of range -> store as a floating point number
+		}
+		
+		// NOTE: the number must be \0-terminated for strtod
+		const auto num_len = size_t(iter - start);
+		char num_buffer[64];
+		string num_str;
+		const char* num_ptr = num_buffer;
+		if (num_len < size(num_buffer)) {
+			memcpy(num_buffer, start, num_len);
+			num_buffer[num_len] = '\0';
+		} else {
+			num_str.assign(start, num_len);
+			num_ptr = num_str.c_str();
+		}
+		val = value_type { json_value::VALUE_TYPE::FP_NUMBER };
+		val.fp_number = strtod(num_ptr, nullptr);
+		return true;
+	}
+	
+	//! returns a pointer to the first char in [ptr, src_end) that needs special handling inside a string literal:
+	//! '\"', '\\', control characters and non-ascii characters
+	floor_inline_always const char* find_string_special_char(const char* ptr) const {
+#if defined(__SSE2__)
+		const auto quote = _mm_set1_epi8('\"');
+		const auto backslash = _mm_set1_epi8('\\');
+		// NOTE: signed compare -> also true for all non-ascii chars (>= 0x80)
+		const auto ctrl_limit = _mm_set1_epi8(0x20);
+		for (; src_end - ptr >= 16; ptr += 16) {
+			const auto chunk = _mm_loadu_si128((const __m128i*)ptr);
+			const auto special = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(chunk, quote), _mm_cmpeq_epi8(chunk, backslash)),
+											  _mm_cmplt_epi8(chunk, ctrl_limit));
+			const auto mask = uint32_t(_mm_movemask_epi8(special));
+			if (mask != 0u) {
+				return ptr + countr_zero(mask);
+			}
+		}
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+		const auto quote = vdupq_n_u8('\"');
+		const auto backslash = vdupq_n_u8('\\');
+		const auto ctrl_limit = vdupq_n_u8(0x20u);
+		const auto non_ascii = vdupq_n_u8(0x80u);
+		for (; src_end - ptr >= 16; ptr += 16) {
+			const auto chunk = vld1q_u8((const uint8_t*)ptr);
+			const auto special = vorrq_u8(vorrq_u8(vceqq_u8(chunk, quote), vceqq_u8(chunk, backslash)),
+										  vorrq_u8(vcltq_u8(chunk, ctrl_limit), vcgeq_u8(chunk, non_ascii)));
+			if (vmaxvq_u8(special) != 0u) {
+				break;
+			}
+		}
+#endif
+		for (; ptr != src_end; ++ptr) {
+			const auto ch = uint8_t(*ptr);
+			if (ch == '\"' || ch == '\\' || ch < 0x20u || ch >= 0x80u) {
+				return ptr;
+			}
+		}
+		return ptr;
+	}
+	
+	//! parses a string literal and returns its (unmodified) content without the enclosing quotes,
+	//! "has_escapes" is set to true if the content contains any escape sequences (-> must be decoded)
+	bool parse_string(string_view& str, bool& has_escapes) {
+		const auto literal_start = iter;
+		const auto str_start = ++iter;
+		for (;;) {
+			iter = find_string_special_char(iter);
+			if (iter == src_end) {
+				return set_error(literal_start, "unterminated string literal (premature EOF)");
+			}
+			const auto ch = uint8_t(*iter);
+			if (ch == '\"') {
+				str = string_view(str_start, size_t(iter - str_start));
+				++iter;
+				return true;
+			} else if (ch == '\\') {
+				if (!validate_escape_sequence()) {
+					return false;
+				}
+				has_escapes = true;
+			} else if (ch < 0x20u) {
+				return set_error(iter, "invalid control character inside string literal");
+			} else {
+				auto utf8_iter = iter;
+				if (!unicode::decode_utf8_char(utf8_iter, src_end).first) {
+					return set_error(iter, "invalid utf-8 code point inside string literal");
+				}
+				iter = utf8_iter + 1;
+			}
+		}
+	}
+	
+	//! validates the escape sequence at "iter" ('\\') and advances past it
+	bool validate_escape_sequence() {
+		const auto es_start = iter++;
+		if (iter == src_end) {
+			return set_error(es_start, "unterminated string literal (premature EOF)");
+		}
+		switch (*iter) {
+			case '\"': case '\\': case '/':
+			case 'b': case 'f': case 'n': case 'r': case 't':
+				++iter;
+				return true;
+			case 'u': {
+				++iter;
+				for (uint32_t i = 0; i < 4u; ++i, ++iter) {
+					if (iter == src_end) {
+						return set_error(es_start, "premature EOF while parsing unicode escape sequence");
+					}
+					const auto ch = *iter;
+					if (!(ch >= '0' && ch <= '9') && !(ch >= 'A' && ch <= 'F') && !(ch >= 'a' && ch <= 'f')) {
+						return set_error(es_start, "invalid unicode escape sequence");
+					}
+				}
+				return true;
+			}
+			default:
+				return set_error(es_start, "invalid escape sequence in string literal");
+		}
+	}
+	
+	//! checks and increases the nesting depth
+	bool enter_nested() {
+		if (++depth > max_depth) {
+			return set_error(iter, "max json nesting depth exceeded");
+		}
+		return true;
+	}
+	
+	bool parse_array(value_type& val) {
+		if (!enter_nested()) {
+			return false;
+		}
+		++iter; // '['
+		
+		[[maybe_unused]] json_array values;
+		[[maybe_unused]] const auto stack_start = value_stack.size();
+		if (!skip_whitespace()) {
+			return false;
+		}
+		if (iter != src_end && *iter == ']') {
+			++iter;
+		} else {
+			for (;;) {
+				if (iter == src_end) {
+					return set_error(iter, "premature EOF inside array");
+				}
+				if constexpr (is_view) {
+					// NOTE: nested values may grow the stack -> parse into a local value first
+					json_view_value elem;
+					if (!parse_value(elem)) {
+						return false;
+					}
+					value_stack.emplace_back(elem);
+				} else {
+					values.emplace_back();
+					if (!parse_value(values.back())) {
+						return false;
+					}
+				}
+				if (!skip_whitespace()) {
+					return false;
+				}
+				if (iter == src_end) {
+					return set_error(iter, "premature EOF inside array");
+				}
+				if (*iter == ',') {
+					++iter;
+					if (!skip_whitespace()) {
+						return false;
+					}
+					continue;
+				}
+				if (*iter == ']') {
+					++iter;
+					break;
+				}
+				return set_error(iter, "expected ',' or ']' in array");
+			}
+		}
+		
+		if constexpr (is_view) {
+			if (!make_view_array(val, stack_start)) {
+				return false;
+			}
+		} else {
+			val = json_value { json_value::VALUE_TYPE::ARRAY };
+			val.array.values = move(values);
+		}
+		--depth;
+		return true;
+	}
+	
+	bool parse_object(value_type& val) {
+		if (!enter_nested()) {
+			return false;
+		}
+		++iter; // '{'
+		
+		[[maybe_unused]] vector<json_object::entry_type> members;
+		[[maybe_unused]] const auto stack_start = member_stack.size();
+		if (!skip_whitespace()) {
+			return false;
+		}
+		if (iter != src_end && *iter == '}') {
+			++iter;
+		} else {
+			for (;;) {
+				if (iter == src_end) {
+					return set_error(iter, "premature EOF inside object");
+				}
+				if (*iter != '\"') {
+					return set_error(iter, "expected a string literal (member name)");
+				}
+				string_view name;
+				bool name_has_escapes = false;
+				if (!parse_string(name, name_has_escapes)) {
+					return false;
+				}
+				if (!skip_whitespace()) {
+					return false;
+				}
+				if (iter == src_end || *iter != ':') {
+					return set_error(iter, "expected ':' after member name");
+				}
+				++iter;
+				if (!skip_whitespace()) {
+					return false;
+				}
+				if (iter == src_end) {
+					return set_error(iter, "premature EOF inside object");
+				}
+				if constexpr (is_view) {
+					json_view_member member { store_name(name, name_has_escapes), {} };
+					if (!parse_value(member.value)) {
+						return false;
+					}
+					member_stack.emplace_back(member);
+				} else {
+					members.emplace_back(string {}, json_value {});
+					if (name_has_escapes) {
+						unescape_string(name, members.back().first);
+					} else {
+						members.back().first.assign(name);
+					}
+					if (!parse_value(members.back().second)) {
+						return false;
+					}
+				}
+				if (!skip_whitespace()) {
+					return false;
+				}
+				if (iter == src_end) {
+					return set_error(iter, "premature EOF inside object");
+				}
+				if (*iter == ',') {
+					++iter;
+					if (!skip_whitespace()) {
+						return false;
+					}
+					continue;
+				}
+				if (*iter == '}') {
+					++iter;
+					break;
+				}
+				return set_error(iter, "expected ',' or '}' in object");
+			}
+		}
+		
+		if constexpr (is_view) {
+			if (!make_view_object(val, stack_start)) {
+				return false;
+			}
+		} else {
+			val = json_value { json_value::VALUE_TYPE::OBJECT };
+			if (members.size() <= max_linear_dedup_member_count) {
+				val.object.members.reserve(members.size());
+				for (auto& member : members) {
+					val.object.members.emplace(move(member.first), move(member.second));
+				}
+			} else {
+				// remove duplicates (keep the first one), then move all members at once
+				// NOTE: flag duplicates first, since moving members would invalidate the name views
+				unordered_set<string_view> names;
+				names.reserve(members.size());
+				vector<bool> is_duplicate(members.size(), false);
+				for (size_t i = 0, count = members.size(); i < count; ++i) {
+					is_duplicate[i] = !names.emplace(members[i].first).second;
+				}
+				names.clear();
+				vector<json_object::entry_type> unique_members;
+				unique_members.reserve(members.size());
+				for (size_t i = 0, count = members.size(); i < count; ++i) {
+					if (!is_duplicate[i]) {
+						unique_members.emplace_back(move(members[i]));
+					}
+				}
+				val.object.members = json_object(move(unique_members), json_object::unique_entries);
+			}
+		}
+		--depth;
+		return true;
+	}
+	
+	//! returns an arena copy of "str"
+	string_view copy_to_arena(const string_view str) {
+		auto data = arena->allocate_array<char>(str.size());
+		memcpy(data, str.data(), str.size());
+		return { data, str.size() };
+	}
+	
+	//! returns the decoded "str" (decoded into "unescape_buffer", i.e. only valid until the next call)
+	string_view unescape_to_buffer(const string_view str) {
+		unescape_buffer.clear();
+		unescape_string(str, unescape_buffer);
+		return unescape_buffer;
+	}
+	
+	//! returns the member name that is stored in the view document (interned when copying strings)
+	//! NOTE: names that contain escape sequences are always decoded into the arena
+	string_view store_name(const string_view name_, const bool has_escapes) {
+		const auto name = (has_escapes ? unescape_to_buffer(name_) : name_);
+		if (!copy_strings) {
+			return (has_escapes ? copy_to_arena(name) : name);
+		}
+		if (const auto iter = interned_names.find(name); iter != interned_names.end()) {
+			return *iter;
+		}
+		const auto interned_name = copy_to_arena(name);
+		interned_names.emplace(interned_name);
+		return interned_name;
+	}
+	
+	//! NOTE: strings that contain escape sequences are always decoded into the arena
+	bool make_view_string(json_view_value& val, const string_view str, const bool has_escapes) {
+		if (str.size() > size_t(UINT32_MAX)) {
+			return set_error(iter, "string literal is too long");
+		}
+		const auto stored_str = (has_escapes ? copy_to_arena(unescape_to_buffer(str)) :
+								 (copy_strings ? copy_to_arena(str) : str));
+		val = json_view_value { json_value::VALUE_TYPE::STRING };
+		val.str = stored_str.data();
+		val.size = uint32_t(stored_str.size());
+		return true;
+	}
+	
+	//! moves all array values on the value stack starting at "stack_start" into the arena
+	bool make_view_array(json_view_value& val, const size_t stack_start) {
+		const auto count = value_stack.size() - stack_start;
+		if (count > size_t(UINT32_MAX)) {
+			return set_error(iter, "too many array values");
+		}
+		auto values = arena->allocate_array<json_view_value>(count);
+		if (count > 0) {
+			memcpy((void*)values, &value_stack[stack_start], count * sizeof(json_view_value));
+		}
+		value_stack.resize(stack_start);
+		val = json_view_value { json_value::VALUE_TYPE::ARRAY };
+		val.values = values;
+		val.size = uint32_t(count);
+		return true;
+	}
+	
+	//! moves all object members on the member stack starting at "stack_start" into the arena,
+	//! for duplicate member names, the first member is kept
+	bool make_view_object(json_view_value& val, const size_t stack_start) {
+		auto count = member_stack.size() - stack_start;
+		if (count > size_t(UINT32_MAX)) {
+			return set_error(iter, "too many object members");
+		}
+		
+		// remove duplicates (in place, keeping the order)
+		const auto members_begin = member_stack.begin() + ptrdiff_t(stack_start);
+		if (count <= max_linear_dedup_member_count) {
+			auto unique_end = members_begin;
+			for (auto member_iter = members_begin; member_iter != member_stack.end(); ++member_iter) {
+				if (find_if(members_begin, unique_end, [&member_iter](const json_view_member& member) {
+					return (member.name == member_iter->name);
+				}) == unique_end) {
+					*unique_end++ = *member_iter;
+				}
+			}
+			count = size_t(unique_end - members_begin);
+		} else {
+			unordered_set<string_view> names;
+			names.reserve(count);
+			count = size_t(remove_if(members_begin, member_stack.end(), [&names](const json_view_member& member) {
+				return !names.emplace(member.name).second;
+			}) - members_begin);
+		}
+		
+		auto members = arena->allocate_array<json_view_member>(count);
+		if (count > 0) {
+			memcpy((void*)members, &member_stack[stack_start], count * sizeof(json_view_member));
+		}
+		member_stack.resize(stack_start);
+		val = json_view_value { json_value::VALUE_TYPE::OBJECT };
+		val.members = members;
+		val.size = uint32_t(count);
+		return true;
+	}
+
+};
+
+document create_document_from_string(const string_view json_data, const string identifier) {
+	document doc;
+	json_fast_parser<json_value> parser(json_data, identifier);
+	if (!parser.parse(doc, doc.root)) {
+		log_error("parsing of JSON data \"$\" failed!", identifier);
+		return {};
+	}
+	return doc;
+}
+
+view_document create_view_document_from_string(const string_view json_data, const string identifier, const bool copy_strings) {
+	view_document doc;
+	json_fast_parser<json_view_value> parser(json_data, identifier, doc.arena, copy_strings);
+	if (!parser.parse(doc, doc.root)) {
+		log_error("parsing of JSON data \"$\" failed!", identifier);
+		return {};
+	}
+	return doc;
+}
+
+} // json
@@ -0,0 +1,132 @@
+/*
+ *  Flo's Open libRary (floor)
+ *  Copyright (C) 2004 - 2022 Florian Ziesche
+ *  
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; version 2 of the License only.
+ *  
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <floor/core/json_view.hpp>
+#include <floor/core/logger.hpp>
+#include <floor/core/file_io.hpp>
+
+namespace json {
+
+uint8_t* json_arena::allocate_block(const size_t size) {
+	// keep all block sizes a multiple of the max alignment, so that aligning within a block never exceeds its end
+	static constexpr const size_t max_alignment { alignof(max_align_t) };
+	const auto align_size = [](const size_t sz) {
+		return (std::max(sz, size_t(1u)) + max_alignment - 1u) & ~(max_alignment - 1u);
+	};
+	
+	if (size > block_size) {
+		// oversized allocation: dedicated block, continue bump allocating from the current block
+		const auto alloc_size = align_size(size);
+		blocks.emplace_back(new uint8_t[alloc_size]);
+		allocated_size += alloc_size;
+		return blocks.back().get();
+	}
+	
+	const auto alloc_size = align_size(block_size);
+	blocks.emplace_back(new uint8_t[alloc_size]);
+	allocated_size += alloc_size;
+	auto block = blocks.back().get();
+	cur_ptr = block + size;
+	cur_end = block + alloc_size;
+	// grow the next block
+	block_size = std::min(block_size * 2u, std::max(max_block_size, block_size));
+	return block;
+}
+
+const json_view_value* json_view_value::find_member(const string_view name) const {
+	if (type != VALUE_TYPE::OBJECT) {
+		return nullptr;
+	}
+	for (uint32_t i = 0; i < size; ++i) {
+		if (members[i].name == name) {
+			return &members[i].value;
+		}
+	}
+	return nullptr;
+}
+
+const json_view_value* json_view_value::find(const json_path& path) const {
+	if (!path.is_valid()) {
+		return nullptr;
+	}
+	const json_view_value* cur_node = this;
+	for (const auto& seg : path) {
+		cur_node = cur_node->find_member(seg.name);
+		if (cur_node == nullptr) {
+			return nullptr;
+		}
+	}
+	return cur_node;
+}
+
+json_value json_view_value::to_value() const {
+	switch (type) {
+		case VALUE_TYPE::NULL_VALUE:
+		case VALUE_TYPE::TRUE_VALUE:
+		case VALUE_TYPE::FALSE_VALUE:
+			return json_value { type };
+		case VALUE_TYPE::INT_NUMBER:
+			return json_value { int_number };
+		case VALUE_TYPE::FP_NUMBER:
+			return json_value { fp_number };
+		case VALUE_TYPE::STRING:
+			return json_value { string(get_string()) };
+		case VALUE_TYPE::OBJECT: {
+			vector<json_object::entry_type> obj_members;
+			obj_members.reserve(size);
+			for (const auto& member : get_members()) {
+				obj_members.emplace_back(string(member.name), member.value.to_value());
+			}
+			json_value ret { VALUE_TYPE::OBJECT };
+			// NOTE: member names are already unique
+			ret.object.members = json_object(move(obj_members), json_object::unique_entries);
+			return ret;
+		}
+		case VALUE_TYPE::ARRAY: {
+			json_value ret { VALUE_TYPE::ARRAY };
+			ret.array.values.reserve(size);
+			for (const auto& value : get_values()) {
+				ret.array.values.emplace_back(value.to_value());
+			}
+			return ret;
+		}
+	}
+	floor_unreachable();
+}
+
+view_document create_view_document(const string& filename) {
+	// parse directly from a read-only mapping of the file, copying strings and member names into the arena,
+	// so that the document doesn't reference the mapping (which only lives for the duration of the parse)
+	if (memory_mapped_file mapped_file(filename, memory_mapped_file::ACCESS_HINT::SEQUENTIAL); mapped_file.is_valid()) {
+		return create_view_document_from_string(mapped_file.get_string_view(), filename, true);
+	}
+	
+	// non-regular file (pipe, ...) or mapping failed: read it and let the document own the data
+	auto json_data = make_unique<string>();
+	if (!file_io::file_to_string(filename, *json_data)) {
+		log_error("failed to read json file \"$\"!", filename);
+		return {};
+	}
+	auto doc = create_view_document_from_string(*json_data, filename);
+	if (doc.valid) {
+		doc.source = move(json_data);
+	}
+	return doc;
+}
+
+} // json
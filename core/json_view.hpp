@@ -0,0 +1,288 @@
+/*
+ *  Flo's Open libRary (floor)
+ *  Copyright (C) 2004 - 2022 Florian Ziesche
+ *  
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; version 2 of the License only.
+ *  
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef __FLOOR_JSON_VIEW_HPP__
+#define __FLOOR_JSON_VIEW_HPP__
+
+#include <floor/core/json.hpp>
+#include <string_view>
+#include <span>
+#include <memory>
+
+namespace json {
+	//! monotonic block allocator: memory is allocated from large blocks and only freed all at once on destruction
+	//! NOTE: objects allocated from the arena are never destructed, i.e. only use this for trivially destructible types
+	class json_arena {
+	public:
+		//! "block_size_" is the size of the first block, each following block doubles in size (up to max_block_size)
+		explicit json_arena(const size_t block_size_ = 64u * 1024u) noexcept : block_size(block_size_) {}
+		json_arena(json_arena&&) = default;
+		json_arena& operator=(json_arena&&) = default;
+		
+		//! allocates "size" bytes with the specified alignment (which must be a power-of-two <= 16)
+		void* allocate(const size_t size, const size_t alignment = alignof(max_align_t)) {
+			auto ptr = (uint8_t*)((size_t(cur_ptr) + alignment - 1u) & ~(alignment - 1u));
+			if (cur_ptr == nullptr || ptr > cur_end || size > size_t(cur_end - ptr)) {
+				return allocate_block(size);
+			}
+			cur_ptr = ptr + size;
+			return ptr;
+		}
+		
+		//! allocates an uninitialized array of "count" elements of type T
+		template <typename T> requires is_trivially_destructible_v<T>
+		T* allocate_array(const size_t count) {
+			return (T*)allocate(sizeof(T) * count, alignof(T));
+		}
+		
+		//! returns the total amount of allocated block memory in bytes
+		size_t get_allocated_size() const {
+			return allocated_size;
+		}
+	
+	protected:
+		vector<unique_ptr<uint8_t[]>> blocks;
+		uint8_t* cur_ptr { nullptr };
+		uint8_t* cur_end { nullptr };
+		size_t block_size;
+		size_t allocated_size { 0u };
+		
+		static constexpr const size_t max_block_size { 16u * 1024u * 1024u };
+		
+		//! allocates a new block for an allocation of "size" bytes that doesn't fit into the current block,
+		//! returns the allocation (max_align_t aligned)
+		//! NOTE: allocations larger than the block size get a dedicated block, i.e. the current block is kept
+		uint8_t* allocate_block(const size_t size);
+		
+		// prohibit copying
+		json_arena(const json_arena&) = delete;
+		json_arena& operator=(const json_arena&) = delete;
+	};
+	
+	struct json_view_member;
+	
+	//! immutable, trivially copyable and destructible json value of a view_document:
+	//! all child values, member names and strings are stored in the arena of the document or directly reference the
+	//! json source data, accessors only return views
+	//! NOTE: as with json_value, escape sequences in strings and member names are decoded (strings that contain escape
+	//!       sequences are always stored in the arena)
+	struct json_view_value {
+		using VALUE_TYPE = json_value::VALUE_TYPE;
+		VALUE_TYPE type { VALUE_TYPE::NULL_VALUE };
+		//! string: length, object: member count, array: value count
+		uint32_t size { 0u };
+		
+		union {
+			int64_t int_number { 0 };
+			double fp_number;
+			const char* str;
+			const json_view_member* members;
+			const json_view_value* values;
+		};
+		
+		constexpr json_view_value() noexcept = default;
+		constexpr explicit json_view_value(const VALUE_TYPE& value_type) noexcept : type(value_type) {}
+		
+		//! returns the value of this value if its type matches the specified type T,
+		//! returning it as <true, value>, or returning <false, 0> if the type doesn't match
+		//! NOTE: strings are returned as string_view, objects as span<const json_view_member> and arrays as
+		//!       span<const json_view_value>
+		template <typename T> requires is_same_v<T, nullptr_t>
+		pair<bool, nullptr_t> get() const {
+			return { type == VALUE_TYPE::NULL_VALUE, nullptr };
+		}
+		template <typename T> requires is_same_v<T, bool>
+		pair<bool, bool> get() const {
+			if (type != VALUE_TYPE::TRUE_VALUE &&
+				type != VALUE_TYPE::FALSE_VALUE) {
+				return { false, false };
+			}
+			return { true, (type == VALUE_TYPE::TRUE_VALUE) };
+		}
+		template <typename T> requires is_same_v<T, int64_t>
+		pair<bool, int64_t> get() const {
+			if (type != VALUE_TYPE::INT_NUMBER) {
+				return { false, 0 };
+			}
+			return { true, int_number };
+		}
+		template <typename T> requires is_same_v<T, uint64_t>
+		pair<bool, uint64_t> get() const {
+			if (type != VALUE_TYPE::INT_NUMBER) {
+				return { false, 0 };
+			}
+			return { true, uint64_t(int_number) };
+		}
+		template <typename T> requires is_same_v<T, int32_t>
+		pair<bool, int32_t> get() const {
+			if (type != VALUE_TYPE::INT_NUMBER) {
+				return { false, 0 };
+			}
+			return { true, int32_t(int_number < 0 ?
+								   std::max(int_number, int64_t(INT32_MIN)) :
+								   std::min(int_number, int64_t(INT32_MAX))) };
+		}
+		template <typename T> requires is_same_v<T, uint32_t>
+		pair<bool, uint32_t> get() const {
+			if (type != VALUE_TYPE::INT_NUMBER) {
+				return { false, 0 };
+			}
+			return { true, uint32_t(std::min(uint64_t(int_number), uint64_t(UINT32_MAX))) };
+		}
+		template <typename T> requires is_same_v<T, float>
+		pair<bool, float> get() const {
+			if (type != VALUE_TYPE::FP_NUMBER) {
+				return { false, 0.0f };
+			}
+			return { true, (float)fp_number };
+		}
+		template <typename T> requires is_same_v<T, double>
+		pair<bool, double> get() const {
+			if (type != VALUE_TYPE::FP_NUMBER) {
+				return { false, 0.0 };
+			}
+			return { true, fp_number };
+		}
+		template <typename T> requires is_same_v<T, string_view>
+		pair<bool, string_view> get() const {
+			if (type != VALUE_TYPE::STRING) {
+				return { false, {} };
+			}
+			return { true, get_string() };
+		}
+		template <typename T> requires is_same_v<T, span<const json_view_member>>
+		pair<bool, span<const json_view_member>> get() const {
+			if (type != VALUE_TYPE::OBJECT) {
+				return { false, {} };
+			}
+			return { true, get_members() };
+		}
+		template <typename T> requires is_same_v<T, span<const json_view_value>>
+		pair<bool, span<const json_view_value>> get() const {
+			if (type != VALUE_TYPE::ARRAY) {
+				return { false, {} };
+			}
+			return { true, get_values() };
+		}
+		
+		//! returns the string if this is a string, an empty string otherwise
+		string_view get_string() const {
+			return (type == VALUE_TYPE::STRING ? string_view(str, size) : string_view {});
+		}
+		//! returns all object members if this is an object, an empty span otherwise
+		span<const json_view_member> get_members() const;
+		//! returns all array values if this is an array, an empty span otherwise
+		span<const json_view_value> get_values() const {
+			return (type == VALUE_TYPE::ARRAY ? span<const json_view_value>(values, size) : span<const json_view_value> {});
+		}
+		
+		//! if this is an object: returns the member with the specified name or nullptr if there is no such member,
+		//! returns nullptr if this is not an object
+		const json_view_value* find_member(const string_view name) const;
+		
+		//! returns the value at the specified path relative to this value (or this value if the path is empty),
+		//! returns nullptr if there is no value at the path
+		const json_view_value* find(const json_path& path) const;
+		
+		//! creates an owning json_value (incl. all children) from this value
+		json_value to_value() const;
+	};
+	
+	//! object member of a json_view_value
+	struct json_view_member {
+		string_view name;
+		json_view_value value;
+	};
+	
+	inline span<const json_view_member> json_view_value::get_members() const {
+		return (type == VALUE_TYPE::OBJECT ? span<const json_view_member>(members, size) : span<const json_view_member> {});
+	}
+	
+	class view_document;
+	
+	//! reads the json file specified by 'filename' and creates a view document from it
+	//! NOTE: regular files are parsed directly from a (temporary) read-only mapping, with strings and member names
+	//!       being copied into the arena, other files are read once and owned by the document
+	view_document create_view_document(const string& filename);
+	
+	//! creates a view document from the in-memory json data, 'identifier' is used for error reporting/identification
+	//! NOTE: if "copy_strings" is false, strings and member names reference "json_data" directly, i.e. "json_data"
+	//!       must outlive the document, otherwise they are copied into the arena (with member names being interned)
+	view_document create_view_document_from_string(const string_view json_data, const string identifier = "",
+												   const bool copy_strings = false);
+	
+	//! read-only json document whose values are all allocated from a single arena (a few large blocks),
+	//! strings and member names directly reference the json source data, or, if they are copied, are stored in the arena
+	//! with member names being interned (i.e. each distinct member name is only stored once)
+	//! NOTE: compared to document, this uses a lot less memory, doesn't need any per-value allocations/deallocations
+	//!       and is torn down at once
+	class view_document {
+	public:
+		view_document() = default;
+		view_document(view_document&&) = default;
+		view_document& operator=(view_document&&) = default;
+		
+		bool valid { false };
+		
+		//! returns the root value
+		const json_view_value& get_root() const {
+			return root;
+		}
+		
+		//! returns the value at the specified path or nullptr if there is no value at the path
+		const json_view_value* find(const json_path& path) const {
+			return root.find(path);
+		}
+		
+		//! returns the value of the key specified by path "node.subnode.key" (or the root value if path is empty),
+		//! or "default_val" if the value doesn't exist or is not of type T (see json_view_value::get for possible types)
+		template <typename T> T get(const json_path& path, const T default_val = T {}) const {
+			if (const auto val = root.find(path); val != nullptr) {
+				if (const auto ret = val->get<T>(); ret.first) {
+					return ret.second;
+				}
+			}
+			return default_val;
+		}
+		template <typename T> T get(const string_view path, const T default_val = T {}) const {
+			return get<T>(json_path(path), default_val);
+		}
+		
+		//! returns the amount of memory used by values, member names and strings (excluding referenced source data)
+		size_t get_memory_usage() const {
+			return arena.get_allocated_size();
+		}
+	
+	protected:
+		friend view_document create_view_document_from_string(const string_view json_data, const string identifier,
+															  const bool copy_strings);
+		friend view_document create_view_document(const string& filename);
+		
+		json_view_value root;
+		json_arena arena;
+		//! owned json source data (if any), referenced by strings and member names
+		unique_ptr<string> source;
+		
+		// prohibit copying
+		view_document(const view_document&) = delete;
+		view_document& operator=(const view_document&) = delete;
+	};
+
+} // json
+
+#endif
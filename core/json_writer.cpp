@@ -0,0 +1,313 @@
+/*
+ *  Flo's Open libRary (floor)
+ *  Copyright (C) 2004 - 2022 Florian Ziesche
+ *  
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; version 2 of the License only.
+ *  
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <floor/core/json_writer.hpp>
+#include <floor/core/logger.hpp>
+#include <charconv>
+#include <cmath>
+
+namespace json {
+
+json_writer::json_writer(const bool pretty_, const uint32_t indent_width_) : pretty(pretty_), indent_width(indent_width_) {
+}
+
+json_writer::json_writer(const string& filename, const bool pretty_, const uint32_t indent_width_) :
+file(make_unique<file_io>(filename, file_io::OPEN_TYPE::WRITE_BINARY)), pretty(pretty_), indent_width(indent_width_) {
+	if (!file->is_open()) {
+		log_error("failed to open json output file \"$\"", filename);
+		valid = false;
+	}
+	buffer.reserve(file_flush_size + 4096u);
+}
+
+json_writer::~json_writer() {
+	if (!finished) {
+		finish();
+	}
+}
+
+bool json_writer::usage_error(const char* msg) {
+	log_error("json writer: $", msg);
+	valid = false;
+	return false;
+}
+
+void json_writer::write_newline_and_indent(const size_t depth) {
+	buffer += '\n';
+	buffer.append(depth * indent_width, ' ');
+}
+
+void json_writer::begin_value() {
+	if (scopes.empty()) {
+		if (has_root) {
+			usage_error("only a single top-level value can be written");
+		}
+		return;
+	}
+	auto& scope = scopes.back();
+	if (scope.is_object) {
+		if (!has_key) {
+			usage_error("missing key for a value inside an object");
+		}
+		// separators have already been written by key()
+		has_key = false;
+		return;
+	}
+	if (scope.has_elements) {
+		buffer += ',';
+	}
+	if (pretty) {
+		write_newline_and_indent(scopes.size());
+	}
+	scope.has_elements = true;
+}
+
+void json_writer::end_value() {
+	if (scopes.empty()) {
+		has_root = true;
+	}
+	if (file && buffer.size() >= file_flush_size) {
+		flush();
+	}
+}
+
+json_writer& json_writer::begin_object() {
+	begin_value();
+	buffer += '{';
+	scopes.emplace_back(scope_t { .is_object = true, .has_elements = false });
+	return *this;
+}
+
+json_writer& json_writer::end_object() {
+	if (scopes.empty() || !scopes.back().is_object || has_key) {
+		usage_error("end_object() without a matching begin_object() or with a dangling key");
+		return *this;
+	}
+	const auto had_elements = scopes.back().has_elements;
+	scopes.pop_back();
+	if (pretty && had_elements) {
+		write_newline_and_indent(scopes.size());
+	}
+	buffer += '}';
+	end_value();
+	return *this;
+}
+
+json_writer& json_writer::begin_array() {
+	begin_value();
+	buffer += '[';
+	scopes.emplace_back(scope_t { .is_object = false, .has_elements = false });
+	return *this;
+}
+
+json_writer& json_writer::end_array() {
+	if (scopes.empty() || scopes.back().is_object) {
+		usage_error("end_array() without a matching begin_array()");
+		return *this;
+	}
+	const auto had_elements = scopes.back().has_elements;
+	scopes.pop_back();
+	if (pretty && had_elements) {
+		write_newline_and_indent(scopes.size());
+	}
+	buffer += ']';
+	end_value();
+	return *this;
+}
+
+json_writer& json_writer::key(const string_view name) {
+	if (scopes.empty() || !scopes.back().is_object || has_key) {
+		usage_error("key() is only valid inside an object and must be followed by a value");
+		return *this;
+	}
+	auto& scope = scopes.back();
+	if (scope.has_elements) {
+		buffer += ',';
+	}
+	if (pretty) {
+		write_newline_and_indent(scopes.size());
+	}
+	scope.has_elements = true;
+	write_escaped_string(name);
+	buffer += (pretty ? ": " : ":");
+	has_key = true;
+	return *this;
+}
+
+json_writer& json_writer::null_value() {
+	begin_value();
+	buffer += "null";
+	end_value();
+	return *this;
+}
+
+json_writer& json_writer::value(const bool val) {
+	begin_value();
+	buffer += (val ? "true" : "false");
+	end_value();
+	return *this;
+}
+
+json_writer& json_writer::value(const int64_t val) {
+	begin_value();
+	char num_buffer[24];
+	const auto ret = to_chars(num_buffer, num_buffer + size(num_buffer), val);
+	buffer.append(num_buffer, ret.ptr);
+	end_value();
+	return *this;
+}
+
+json_writer& json_writer::value(const uint64_t val) {
+	begin_value();
+	char num_buffer[24];
+	const auto ret = to_chars(num_buffer, num_buffer + size(num_buffer), val);
+	buffer.append(num_buffer, ret.ptr);
+	end_value();
+	return *this;
+}
+
+json_writer& json_writer::value(const float val) {
+	return value(double(val));
+}
+
+json_writer& json_writer::value(const double val) {
+	// json has no representation for inf/nan
+	if (!isfinite(val)) {
+		return null_value();
+	}
+	begin_value();
+	// shortest representation that round-trips
+	char num_buffer[32];
+	const auto ret = to_chars(num_buffer, num_buffer + size(num_buffer), val);
+	const string_view num_str(num_buffer, size_t(ret.ptr - num_buffer));
+	buffer += num_str;
+	// ensure this is read back as a floating point number (and not as an integer)
+	if (num_str.find_first_of(".e") == string_view::npos) {
+		buffer += ".0";
+	}
+	end_value();
+	return *this;
+}
+
+json_writer& json_writer::value(const string_view str) {
+	begin_value();
+	write_escaped_string(str);
+	end_value();
+	return *this;
+}
+
+json_writer& json_writer::value(const json_value& val) {
+	switch (val.type) {
+		case json_value::VALUE_TYPE::NULL_VALUE:
+			return null_value();
+		case json_value::VALUE_TYPE::TRUE_VALUE:
+			return value(true);
+		case json_value::VALUE_TYPE::FALSE_VALUE:
+			return value(false);
+		case json_value::VALUE_TYPE::INT_NUMBER:
+			return value(val.int_number);
+		case json_value::VALUE_TYPE::FP_NUMBER:
+			return value(val.fp_number);
+		case json_value::VALUE_TYPE::STRING:
+			return value(string_view(val.str));
+		case json_value::VALUE_TYPE::OBJECT:
+			begin_object();
+			for (const auto& member : val.object.members) {
+				key(member.first);
+				value(member.second);
+			}
+			return end_object();
+		case json_value::VALUE_TYPE::ARRAY:
+			begin_array();
+			for (const auto& elem : val.array.values) {
+				value(elem);
+			}
+			return end_array();
+	}
+	floor_unreachable();
+}
+
+void json_writer::write_escaped_string(const string_view str) {
+	buffer += '\"';
+	// append runs of chars that don't need escaping at once
+	const char* run_start = str.data();
+	const char* const str_end = str.data() + str.size();
+	for (const char* ptr = run_start; ptr != str_end; ++ptr) {
+		const auto ch = uint8_t(*ptr);
+		if (ch >= 0x20u && ch != '\"' && ch != '\\') {
+			continue;
+		}
+		buffer.append(run_start, ptr);
+		run_start = ptr + 1;
+		switch (ch) {
+			case '\"': buffer += "\\\""; break;
+			case '\\': buffer += "\\\\"; break;
+			case '\b': buffer += "\\b"; break;
+			case '\f': buffer += "\\f"; break;
+			case '\n': buffer += "\\n"; break;
+			case '\r': buffer += "\\r"; break;
+			case '\t': buffer += "\\t"; break;
+			default: {
+				static constexpr const char hex_digits[] { "0123456789abcdef" };
+				const char escaped[] { '\\', 'u', '0', '0', hex_digits[(ch >> 4u) & 0xFu], hex_digits[ch & 0xFu] };
+				buffer.append(escaped, size(escaped));
+				break;
+			}
+		}
+	}
+	buffer.append(run_start, str_end);
+	buffer += '\"';
+}
+
+void json_writer::flush() {
+	if (!file || buffer.empty()) {
+		return;
+	}
+	if (valid) {
+		file->write_block(buffer.data(), buffer.size());
+		if (!file->good()) {
+			log_error("failed to write json output");
+			valid = false;
+		}
+	}
+	buffer.clear();
+}
+
+bool json_writer::finish() {
+	finished = true;
+	if (!scopes.empty() || has_key) {
+		usage_error("incomplete json output (unclosed object/array)");
+	}
+	if (file) {
+		if (pretty && has_root) {
+			buffer += '\n';
+		}
+		flush();
+		file->close();
+		file = nullptr;
+	}
+	return valid;
+}
+
+bool write_document(const document& doc, const string& filename, const bool pretty) {
+	json_writer writer(filename, pretty);
+	writer.value(doc.root);
+	return writer.finish();
+}
+
+} // json
@@ -0,0 +1,125 @@
+/*
+ *  Flo's Open libRary (floor)
+ *  Copyright (C) 2004 - 2022 Florian Ziesche
+ *  
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; version 2 of the License only.
+ *  
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef __FLOOR_JSON_WRITER_HPP__
+#define __FLOOR_JSON_WRITER_HPP__
+
+#include <floor/core/json.hpp>
+#include <floor/core/file_io.hpp>
+#include <string_view>
+
+namespace json {
+	//! streaming json writer (SAX-style emitter): values are written directly into a growable buffer or a file,
+	//! i.e. huge arrays/objects can be written without building a json_value tree first
+	//! usage: writer.begin_object().key("name").value("x").key("values").begin_array().value(1).value(2).end_array().end_object();
+	//! NOTE: string values and member names are escaped when written
+	//! NOTE: non-finite floating point values are written as null (json has no representation for inf/nan)
+	class json_writer {
+	public:
+		//! writes into an internal buffer, retrieve it via get_string() or take_string() when done
+		explicit json_writer(const bool pretty_ = false, const uint32_t indent_width_ = 4u);
+		//! writes into the file "filename" (created or truncated), the output is buffered and flushed in chunks
+		explicit json_writer(const string& filename, const bool pretty_ = false, const uint32_t indent_width_ = 4u);
+		//! NOTE: necessary, because a string literal would otherwise be converted to bool
+		explicit json_writer(const char* filename, const bool pretty_ = false, const uint32_t indent_width_ = 4u) :
+		json_writer(string(filename), pretty_, indent_width_) {}
+		//! finishes writing (see finish())
+		~json_writer();
+		
+		json_writer& begin_object();
+		json_writer& end_object();
+		json_writer& begin_array();
+		json_writer& end_array();
+		//! writes the member name of the next value (only valid inside an object)
+		json_writer& key(const string_view name);
+		
+		json_writer& null_value();
+		json_writer& value(const bool val);
+		json_writer& value(const int32_t val) { return value(int64_t(val)); }
+		json_writer& value(const uint32_t val) { return value(uint64_t(val)); }
+		json_writer& value(const int64_t val);
+		json_writer& value(const uint64_t val);
+		json_writer& value(const float val);
+		json_writer& value(const double val);
+		json_writer& value(const string_view str);
+		json_writer& value(const char* str) { return value(string_view(str)); }
+		json_writer& value(const string& str) { return value(string_view(str)); }
+		//! writes the specified json value and all its children
+		json_writer& value(const json_value& val);
+		
+		//! flushes all pending output to the file (if writing to a file),
+		//! returns true if the written json data is complete (all objects/arrays closed) and there was no error
+		bool finish();
+		
+		//! returns false if there was a usage error (e.g. unbalanced begin/end) or a write error
+		bool is_valid() const {
+			return valid;
+		}
+		
+		//! returns the written json data (only when writing into a buffer)
+		const string& get_string() const {
+			return buffer;
+		}
+		//! moves the written json data out of this writer (only when writing into a buffer)
+		string take_string() {
+			return move(buffer);
+		}
+	
+	protected:
+		string buffer;
+		unique_ptr<file_io> file;
+		const bool pretty { false };
+		const uint32_t indent_width { 4u };
+		bool valid { true };
+		bool finished { false };
+		
+		//! current object/array nesting
+		struct scope_t {
+			bool is_object;
+			bool has_elements;
+		};
+		vector<scope_t> scopes;
+		//! true if a key was written and its value is expected next
+		bool has_key { false };
+		//! true if a complete top-level value has been written
+		bool has_root { false };
+		
+		//! when writing to a file: the buffer is flushed once it exceeds this size
+		static constexpr const size_t file_flush_size { 256u * 1024u };
+		
+		//! writes separators/indentation that are necessary before the next value (or key)
+		void begin_value();
+		//! must be called after a value has been completely written
+		void end_value();
+		void write_newline_and_indent(const size_t depth);
+		void write_escaped_string(const string_view str);
+		void flush();
+		
+		bool usage_error(const char* msg);
+		
+		// prohibit copying
+		json_writer(const json_writer&) = delete;
+		json_writer& operator=(const json_writer&) = delete;
+	};
+	
+	//! writes the json document into the file "filename", returns true on success
+	bool write_document(const document& doc, const string& filename, const bool pretty = true);
+
+} // json
+
+#endif
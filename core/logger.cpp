@@ -18,11 +18,34 @@
 
 #if !defined(_MSC_VER)
 #include <sys/time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/uio.h>
+#include <sys/stat.h>
+#include <climits>
+#else
+#include <io.h>
+#include <fcntl.h>
+#include <sys/stat.h>
 #endif
 #include <floor/core/logger.hpp>
 #include <floor/threading/thread_base.hpp>
+#include <floor/threading/task.hpp>
+#include <floor/core/core.hpp>
+#include <floor/core/file_io.hpp>
 #include <floor/core/cpp_headers.hpp>
 #include <floor/constexpr/const_math.hpp>
+#include <condition_variable>
+#include <cerrno>
+
+#if !defined(_MSC_VER)
+//! max amount of buffers that can be written with a single writev call
+#if defined(IOV_MAX)
+static constexpr const size_t log_max_iov_count { IOV_MAX };
+#else
+static constexpr const size_t log_max_iov_count { 1024u };
+#endif
+#endif
 
 #include <SDL2/SDL.h>
 
@@ -30,31 +53,401 @@
 #include <floor/darwin/darwin_helper.hpp>
 #endif
 
+static safe_mutex log_rotation_lock;
+static logger::rotation_options log_rotation GUARDED_BY(log_rotation_lock);
+
+//! returns true if rotated log segments can be compressed (checked once, requires "gzip" to be installed),
+//! prints a warning if they can't (-> segments are then kept uncompressed)
+static bool log_compression_available() {
+	static const bool available = [] {
+#if !defined(__WINDOWS__)
+		string gzip_path;
+		core::system("command -v gzip 2>/dev/null", gzip_path);
+		if (!gzip_path.empty()) {
+			return true;
+		}
+		cerr << "LOG WARNING: gzip not found - rotated log segments will not be compressed!" << endl;
+#else
+		cerr << "LOG WARNING: log segment compression is not supported on Windows - rotated log segments will not be compressed!" << endl;
+#endif
+		return false;
+	}();
+	return available;
+}
+
+//! unbuffered log file that is kept open for the lifetime of the logger,
+//! all entries of one logger run are written with a single (vectored) write call
+struct log_file_t {
+	string filename;
+	int fd { -1 };
+	//! true if there were writes since the last sync
+	bool dirty { false };
+	//! current file size and the time at which the current segment was started (or last modified, if it was reopened)
+	uint64_t size { 0u };
+	chrono::system_clock::time_point open_time;
+	//! sequence numbers of all existing rotated segments (oldest first, compressed or not) and the next sequence number to use
+	deque<uint64_t> segments GUARDED_BY(segments_lock);
+	uint64_t next_segment { 0u };
+	safe_mutex segments_lock;
+	//! segment compression and pruning are serialized through this lock,
+	//! so that a segment is never deleted while it is being compressed
+	mutex compress_lock;
+	//! amount of in-flight background compression tasks (signaled through "compress_done_cv" once all are done)
+	uint32_t compress_task_count { 0u };
+	condition_variable compress_done_cv;
+	
+	~log_file_t() {
+		// background compression tasks reference this file -> wait until all are done
+		unique_lock<mutex> lock(compress_lock);
+		compress_done_cv.wait(lock, [this] { return (compress_task_count == 0u); });
+	}
+	
+	bool open(const string& filename_, const bool append) {
+		filename = filename_;
+#if !defined(_MSC_VER)
+		fd = ::open(filename.c_str(), O_WRONLY | O_CREAT | O_CLOEXEC | (append ? O_APPEND : O_TRUNC), 0644);
+#else
+		fd = _open(filename.c_str(), _O_WRONLY | _O_CREAT | _O_BINARY | (append ? _O_APPEND : _O_TRUNC), _S_IREAD | _S_IWRITE);
+#endif
+		if (!is_open()) {
+			return false;
+		}
+#if !defined(_MSC_VER)
+		const auto end_pos = ::lseek(fd, 0, SEEK_END);
+#else
+		const auto end_pos = _lseeki64(fd, 0, SEEK_END);
+#endif
+		size = (end_pos > 0 ? uint64_t(end_pos) : 0u);
+		open_time = chrono::system_clock::now();
+		if (append && size > 0u) {
+			// the current segment was started by an earlier run -> measure its age from the last modification time,
+			// so that reopening the log file doesn't restart the max_age interval
+#if !defined(_MSC_VER)
+			struct stat file_stat;
+			if (fstat(fd, &file_stat) == 0) {
+#else
+			struct _stat64 file_stat;
+			if (_fstat64(fd, &file_stat) == 0) {
+#endif
+				open_time = min(open_time, chrono::system_clock::from_time_t(file_stat.st_mtime));
+			}
+		}
+		return true;
+	}
+	
+	bool is_open() const {
+		return (fd >= 0);
+	}
+	
+	//! writes all "entries" with as few write calls as possible
+	void write(const vector<const string*>& entries) {
+		if (!is_open() || entries.empty()) {
+			return;
+		}
+#if !defined(_MSC_VER)
+		vector<iovec> iovs;
+		iovs.reserve(entries.size());
+		for (const auto& entry : entries) {
+			if (!entry->empty()) {
+				iovs.emplace_back(iovec { const_cast<char*>(entry->data()), entry->size() });
+			}
+		}
+		for (size_t iov_idx = 0, iov_count = iovs.size(); iov_idx < iov_count;) {
+			const auto count = min(iov_count - iov_idx, size_t(log_max_iov_count));
+			const auto written = ::writev(fd, &iovs[iov_idx], int(count));
+			if (written < 0 && errno == EINTR) {
+				continue;
+			}
+			if (written <= 0) {
+				break;
+			}
+			size += uint64_t(written);
+			// skip all fully written buffers, then advance into a partially written one
+			auto remaining = size_t(written);
+			while (iov_idx < iov_count && remaining >= iovs[iov_idx].iov_len) {
+				remaining -= iovs[iov_idx].iov_len;
+				++iov_idx;
+			}
+			if (remaining > 0) {
+				iovs[iov_idx].iov_base = (char*)iovs[iov_idx].iov_base + remaining;
+				iovs[iov_idx].iov_len -= remaining;
+			}
+		}
+#else
+		// no writev on Windows -> concat everything and write it at once
+		string data;
+		for (const auto& entry : entries) {
+			data += *entry;
+		}
+		for (size_t offset = 0, data_size = data.size(); offset < data_size;) {
+			const auto written = _write(fd, data.data() + offset, (unsigned int)(data_size - offset));
+			if (written <= 0) {
+				break;
+			}
+			offset += size_t(written);
+			size += uint64_t(written);
+		}
+#endif
+		dirty = true;
+	}
+	
+	void sync() {
+		if (!is_open() || !dirty) {
+			return;
+		}
+#if !defined(_MSC_VER)
+		fsync(fd);
+#else
+		_commit(fd);
+#endif
+		dirty = false;
+	}
+	
+	void close() {
+		if (!is_open()) {
+			return;
+		}
+		sync();
+#if !defined(_MSC_VER)
+		::close(fd);
+#else
+		_close(fd);
+#endif
+		fd = -1;
+	}
+	
+	//! returns the file name of the rotated segment with the specified sequence number
+	string segment_name(const uint64_t seq) const {
+		return filename + "." + to_string(seq);
+	}
+	
+	//! finds all already existing rotated segments of this log file ("<filename>.<seq>" or "<filename>.<seq>.gz")
+	void find_segments() REQUIRES(!segments_lock) {
+		GUARD(segments_lock);
+		segments.clear();
+		next_segment = 0u;
+		
+		const auto slash_pos = filename.find_last_of("/\\");
+		const auto dir = (slash_pos != string::npos ? filename.substr(0, slash_pos + 1) : "./"s);
+		const auto prefix = (slash_pos != string::npos ? filename.substr(slash_pos + 1) : filename) + ".";
+		
+		set<uint64_t> found_segments;
+		for (const auto& file : core::get_file_list(dir)) {
+			if (file.second == file_io::FILE_TYPE::DIR || file.first.size() <= prefix.size() ||
+				file.first.compare(0, prefix.size(), prefix) != 0) {
+				continue;
+			}
+			auto seq_str = file.first.substr(prefix.size());
+			if (seq_str.size() > 3 && seq_str.compare(seq_str.size() - 3, 3, ".gz") == 0) {
+				seq_str.erase(seq_str.size() - 3);
+			}
+			if (seq_str.empty() || seq_str.size() > 19 ||
+				seq_str.find_first_not_of("0123456789") != string::npos) {
+				continue;
+			}
+			found_segments.emplace(stoull(seq_str));
+		}
+		segments.assign(found_segments.begin(), found_segments.end());
+		if (!segments.empty()) {
+			next_segment = segments.back() + 1u;
+		}
+	}
+	
+	//! returns true if this file must be rotated before "write_size" more bytes can be written
+	bool needs_rotation(const logger::rotation_options& options, const uint64_t write_size) const {
+		if (!is_open() || size == 0u) {
+			return false;
+		}
+		if (options.max_file_size > 0u && size + write_size > options.max_file_size) {
+			return true;
+		}
+		if (options.max_age.count() > 0 && chrono::system_clock::now() - open_time >= options.max_age) {
+			return true;
+		}
+		return false;
+	}
+	
+	//! compresses the specified segment file, keeps the uncompressed segment if this fails
+	//! NOTE: must be called with "compress_lock" held
+	void compress_segment(const string& segment) {
+		core::system("gzip -f \"" + segment + "\"");
+		if (!file_io::is_file(segment + ".gz")) {
+			cerr << "LOG ERROR: failed to compress rotated log segment (" << segment << ")!" << endl;
+		}
+	}
+	
+	//! removes the oldest segments (compressed or not) until at most "max_segments" are left (0 = unlimited)
+	//! NOTE: must be called with "compress_lock" held
+	void prune_segments(const uint32_t max_segments) REQUIRES(!segments_lock) {
+		if (max_segments == 0u) {
+			return;
+		}
+		GUARD(segments_lock);
+		while (segments.size() > max_segments) {
+			const auto old_segment = segment_name(segments.front());
+			segments.pop_front();
+			// no compression is in flight -> segment is either uncompressed or compressed
+			// (or both, if an earlier compression was interrupted)
+			remove(old_segment.c_str());
+			remove((old_segment + ".gz").c_str());
+		}
+	}
+	
+	//! moves the current log file to a new segment, starts a new (empty) log file,
+	//! optionally compresses the segment in the background and removes all segments exceeding "max_segments"
+	void rotate(const logger::rotation_options& options) REQUIRES(!segments_lock) {
+		close();
+		
+		const auto seq = next_segment++;
+		const auto segment = segment_name(seq);
+		if (rename(filename.c_str(), segment.c_str()) != 0) {
+			cerr << "LOG ERROR: failed to rotate log file (" << filename << " -> " << segment << ")!" << endl;
+			if (!open(filename, true)) {
+				cerr << "LOG ERROR: couldn't reopen log file (" << filename << ")!" << endl;
+			}
+			return;
+		}
+		{
+			GUARD(segments_lock);
+			segments.emplace_back(seq);
+		}
+		
+		if (!open(filename, false)) {
+			cerr << "LOG ERROR: couldn't open log file (" << filename << ")!" << endl;
+		}
+		
+		if (options.compress && log_compression_available()) {
+			// compress + prune in the background (gzip is an external process -> blocking task)
+			{
+				lock_guard<mutex> lock(compress_lock);
+				++compress_task_count;
+			}
+			task::spawn_blocking([this, segment, max_segments = options.max_segments] {
+				{
+					lock_guard<mutex> lock(compress_lock);
+					compress_segment(segment);
+					prune_segments(max_segments);
+					--compress_task_count;
+					// notify while holding the lock, this may be destructed right after it is released
+					compress_done_cv.notify_all();
+				}
+			}, "log compress");
+		} else {
+			lock_guard<mutex> lock(compress_lock);
+			prune_segments(options.max_segments);
+		}
+	}
+};
+
 static string log_filename, msg_filename;
-static unique_ptr<ofstream> log_file { nullptr }, msg_file { nullptr };
+static unique_ptr<log_file_t> log_file { nullptr }, msg_file { nullptr };
 static atomic<uint32_t> log_err_counter { 0u };
 static atomic<logger::LOG_TYPE> log_verbosity { logger::LOG_TYPE::UNDECORATED };
-static bool log_append_mode { false };
+//! formatted log entry
+struct log_entry_t {
+	logger::LOG_TYPE type;
+	string str;
+	//! id of the binary log ring of the logging thread (0 if it has none) and the ring write position at the time the
+	//! entry was logged, i.e. this entry must be written after all binary records of that thread before this position
+	uint64_t ring_id { 0u };
+	uint64_t ring_pos { 0u };
+};
 static safe_mutex log_store_lock;
-static vector<pair<logger::LOG_TYPE, string>> log_store GUARDED_BY(log_store_lock), log_output_store;
+static vector<log_entry_t> log_store GUARDED_BY(log_store_lock), log_output_store;
 static bool log_use_time { true };
 static bool log_use_color { true };
 static bool log_use_unicode_color { false };
 static atomic<bool> log_initialized { false };
 static atomic<bool> log_destroying { false };
+static atomic<bool> log_binary_mode { false };
+
+//! logger thread wake-up handling:
+//! the logger thread runs in event-driven mode and sleeps until it is notified that there are pending log entries,
+//! it is woken up immediately when going from idle to non-idle, for errors and when a flush is requested,
+//! other entries are batched until either "log_batch_threshold" entries are pending or "log_batch_latency" has passed
+static constexpr const uint32_t log_batch_threshold { 256u };
+static constexpr const auto log_batch_latency { 5ms };
+//! interval in which written log files are synced to disk (also done on each flush)
+static constexpr const auto log_sync_interval { 1000ms };
+//! time of the last sync (only accessed by the logger thread)
+static chrono::steady_clock::time_point log_last_sync;
+static mutex log_wake_lock;
+static condition_variable log_run_done_cv;
+static atomic<uint32_t> log_pending { 0u };
+static atomic<bool> log_urgent { false };
+//! NOTE: these are protected by log_wake_lock
+static uint64_t log_run_started { 0u }, log_run_finished { 0u }, log_flush_requested { 0u };
+static bool log_thread_running { false };
+class logger_thread;
+//! NOTE: only valid while "log_thread_running" is true (-> only access it while holding log_wake_lock)
+static logger_thread* log_thread_ptr { nullptr };
+
+//! per-thread single-producer/single-consumer ring buffer of binary log records
+//! NOTE: the producer is the owning thread, the consumer is the logger thread
+struct binary_log_ring {
+	//! ring buffer size in bytes (must be a power-of-two)
+	static constexpr const size_t capacity { 64u * 1024u };
+	unique_ptr<uint8_t[]> data { make_unique<uint8_t[]>(capacity) };
+	//! monotonically increasing write position (only modified by the producer)
+	alignas(64) atomic<uint64_t> write_pos { 0u };
+	//! monotonically increasing read position (only modified by the consumer)
+	alignas(64) atomic<uint64_t> read_pos { 0u };
+	//! producer-only: position and size of the currently reserved record (incl. wrap-around padding)
+	uint64_t reserved_pos { 0u };
+	uint64_t reserved_size { 0u };
+	//! false once the owning thread has exited
+	atomic<bool> owner_alive { true };
+	//! unique id of this ring (never reused, unlike the ring address)
+	const uint64_t id { next_id++ };
+	static inline atomic<uint64_t> next_id { 1u };
+};
+static safe_mutex binary_rings_lock;
+static vector<shared_ptr<binary_log_ring>> binary_rings GUARDED_BY(binary_rings_lock);
+
+//! thread-local ring buffer handle, this registers the ring buffer on first use and marks it as orphaned on thread exit,
+//! the logger thread will then remove it once it has been drained
+struct binary_log_ring_handle {
+	shared_ptr<binary_log_ring> ring;
+	
+	binary_log_ring* get() {
+		if (!ring) {
+			ring = make_shared<binary_log_ring>();
+			GUARD(binary_rings_lock);
+			binary_rings.emplace_back(ring);
+		}
+		return ring.get();
+	}
+	~binary_log_ring_handle() {
+		if (ring) {
+			ring->owner_alive = false;
+		}
+	}
+};
+static thread_local binary_log_ring_handle binary_ring_handle;
 
 class logger_thread final : thread_base {
 public:
-	atomic<uint32_t> run_num { 0 };
-	
 	logger_thread() : thread_base("logger") {
-		this->set_thread_delay(20); // lower to 20ms
+		// only wake up when notified, or periodically to sync written log files to disk
+		this->set_event_driven(true);
+		this->set_thread_delay(size_t(chrono::duration_cast<chrono::milliseconds>(log_sync_interval).count()));
+		{
+			lock_guard<mutex> lock(log_wake_lock);
+			log_thread_ptr = this;
+			log_thread_running = true;
+		}
 		this->start();
 	}
 	~logger_thread() override {
 		// finish (kill the logger thread) and run once more to make sure everything has been saved/printed
+		{
+			lock_guard<mutex> lock(log_wake_lock);
+			log_thread_running = false;
+			log_thread_ptr = nullptr;
+		}
+		log_run_done_cv.notify_all();
 		finish();
-		run();
+		write_logs();
 		
 		if(log_file != nullptr) {
 			log_file->close();
@@ -67,10 +460,161 @@ public:
 	}
 	
 	void run() override REQUIRES(!log_store_lock);
+	
+	//! wakes up the logger thread
+	using thread_base::notify;
+	
+	//! writes all currently stored log entries
+	static void write_logs() REQUIRES(!log_store_lock);
+	
+	//! syncs all written log files to disk
+	static void sync_logs();
+	
+	//! formats all pending binary log records of all threads and merges them into the log output store
+	//! NOTE: must be called after the log store has been swapped into the log output store, so that all binary records
+	//!       that were logged before any entry in the output store are drained as well
+	static void drain_binary_rings() REQUIRES(!binary_rings_lock);
+	
+	//! formatted binary log records of a single ring (in ring order)
+	struct drained_ring_t {
+		uint64_t ring_id;
+		vector<log_entry_t> entries;
+		size_t merged_count;
+	};
 };
 static unique_ptr<logger_thread> log_thread;
 
+//! notifies the logger thread that a new log entry is pending
+static void notify_logger(const bool urgent) {
+	const auto prev_pending = log_pending++;
+	if (urgent) {
+		log_urgent = true;
+	}
+	if (prev_pending == 0 || prev_pending + 1 == log_batch_threshold || urgent) {
+		lock_guard<mutex> lock(log_wake_lock);
+		if (log_thread_running) {
+			log_thread_ptr->notify();
+		}
+	}
+}
+
+void logger_thread::drain_binary_rings() {
+	vector<shared_ptr<binary_log_ring>> rings;
+	{
+		GUARD(binary_rings_lock);
+		// remove all rings of exited threads that have already been drained
+		erase_if(binary_rings, [](const shared_ptr<binary_log_ring>& ring) {
+			return (!ring->owner_alive && ring->read_pos.load() == ring->write_pos.load());
+		});
+		rings = binary_rings;
+	}
+	
+	static vector<drained_ring_t> drained_rings;
+	size_t drained_count = 0;
+	for (auto& ring : rings) {
+		vector<log_entry_t> entries;
+		auto read_pos = ring->read_pos.load(memory_order_relaxed);
+		const auto write_pos = ring->write_pos.load(memory_order_acquire);
+		while (read_pos < write_pos) {
+			const auto record_ptr = &ring->data[read_pos & (binary_log_ring::capacity - 1u)];
+			logger::binary_log_record record;
+			memcpy(&record, record_ptr, sizeof(uint32_t) * 2u); // size + type
+			if ((uint32_t)record.type != 0u) {
+				memcpy(&record, record_ptr, sizeof(record));
+				stringstream buffer;
+				if (logger::prepare_log(buffer, record.type, record.file, record.func,
+										chrono::system_clock::time_point(chrono::system_clock::duration(record.time)))) {
+					record.format(buffer, record.str, record_ptr + sizeof(record));
+					entries.emplace_back(log_entry_t { record.type, buffer.str(), ring->id, read_pos });
+				}
+			}
+			// else: padding record
+			read_pos += record.size;
+		}
+		ring->read_pos.store(read_pos, memory_order_release);
+		if (!entries.empty()) {
+			drained_count += entries.size();
+			drained_rings.emplace_back(drained_ring_t { ring->id, move(entries), 0u });
+		}
+	}
+	if (drained_rings.empty()) {
+		return;
+	}
+	
+	// merge: default path entries of a thread must be written after all binary records that thread logged before them
+	// NOTE: order between different threads is not guaranteed (binary records of other threads are simply appended)
+	vector<log_entry_t> merged;
+	merged.reserve(log_output_store.size() + drained_count);
+	for (auto& entry : log_output_store) {
+		if (entry.ring_id != 0u) {
+			for (auto& drained : drained_rings) {
+				if (drained.ring_id != entry.ring_id) {
+					continue;
+				}
+				while (drained.merged_count < drained.entries.size() &&
+					   drained.entries[drained.merged_count].ring_pos < entry.ring_pos) {
+					merged.emplace_back(move(drained.entries[drained.merged_count++]));
+				}
+				break;
+			}
+		}
+		merged.emplace_back(move(entry));
+	}
+	for (auto& drained : drained_rings) {
+		for (auto iter = drained.entries.begin() + ptrdiff_t(drained.merged_count); iter != drained.entries.end(); ++iter) {
+			merged.emplace_back(move(*iter));
+		}
+	}
+	drained_rings.clear();
+	log_output_store.swap(merged);
+}
+
 void logger_thread::run() {
+	bool flush_requested = false;
+	{
+		lock_guard<mutex> lock(log_wake_lock);
+		flush_requested = (log_flush_requested > log_run_finished);
+	}
+	if (log_pending == 0 && !flush_requested) {
+		// woken up by the sync interval timeout: sync written log files to disk
+		sync_logs();
+		return;
+	}
+	
+	// batch non-urgent entries (notified once the batch threshold has been reached, on errors and on flush requests)
+	if (!log_urgent && !flush_requested && log_pending < log_batch_threshold) {
+		wait_for_notify(chrono::duration_cast<chrono::milliseconds>(log_batch_latency));
+	}
+	{
+		lock_guard<mutex> lock(log_wake_lock);
+		++log_run_started;
+	}
+	
+	write_logs();
+	
+	// under sustained logging we never hit the idle path above -> also sync here once the interval has passed,
+	// and always sync when flushing, so that a flush() also makes everything durable
+	if (flush_requested || chrono::steady_clock::now() - log_last_sync >= log_sync_interval) {
+		sync_logs();
+	}
+	
+	{
+		lock_guard<mutex> lock(log_wake_lock);
+		log_run_finished = log_run_started;
+	}
+	log_run_done_cv.notify_all();
+}
+
+void logger_thread::sync_logs() {
+	if (log_file) log_file->sync();
+	if (msg_file) msg_file->sync();
+	log_last_sync = chrono::steady_clock::now();
+}
+
+void logger_thread::write_logs() {
+	log_pending = 0;
+	log_urgent = false;
+	
 	// swap the (empty) log output store/queue with the (probably non-empty) log output store
 	// note that this is a constant complexity operation, which makes log writing+output almost non-interrupting
 	while(!log_store_lock.try_lock()) {
@@ -79,71 +623,63 @@ void logger_thread::run() {
 	log_output_store.swap(log_store);
 	log_store_lock.unlock();
 	
+	// format all pending binary log records and merge them with the swapped entries (-> keeps per-thread order)
+	drain_binary_rings();
+	
 	if(log_output_store.empty()) {
-		++run_num;
 		return;
 	}
 	
-	// in append mode, close the file and reopen it in append mode
-	if(log_append_mode) {
-		if(log_file->is_open()) {
-			log_file->close();
-			log_file->clear();
-		}
-		log_file->open(log_filename, ofstream::app | ofstream::out);
-		
-		if(msg_file != nullptr) {
-			if(msg_file->is_open()) {
-				msg_file->close();
-				msg_file->clear();
-			}
-			msg_file->open(msg_filename, ofstream::app | ofstream::out);
-		}
-	}
-	
 	// write all log store entries
+	vector<const string*> log_file_entries, msg_file_entries;
+	uint64_t log_file_size = 0u, msg_file_size = 0u;
 	for(auto& entry : log_output_store) {
 		// finally: output
-		if(entry.first != logger::LOG_TYPE::ERROR_MSG) {
-			cout << entry.second;
+		if(entry.type != logger::LOG_TYPE::ERROR_MSG) {
+			cout << entry.str;
 		}
-		else cerr << entry.second;
+		else cerr << entry.str;
 		
-		if(entry.second[0] == 0x1B) {
+		if(entry.str[0] == 0x1B) {
 			// strip the color information when writing to the log file
-			entry.second.erase(0, 5);
-			entry.second.erase(5, 3);
+			entry.str.erase(0, 5);
+			entry.str.erase(5, 3);
 		}
 		
 		// if "separate msg file logging" is enabled and the log type is "msg", log to the msg file
-		if(entry.first == logger::LOG_TYPE::SIMPLE_MSG && msg_file != nullptr) {
-			*msg_file << entry.second;
+		if(entry.type == logger::LOG_TYPE::SIMPLE_MSG && msg_file != nullptr) {
+			msg_file_entries.emplace_back(&entry.str);
+			msg_file_size += entry.str.size();
 		}
 		// else: just output to the standard log file
-		else *log_file << entry.second;
+		else {
+			log_file_entries.emplace_back(&entry.str);
+			log_file_size += entry.str.size();
+		}
 	}
 	cout.flush();
 	cerr.flush();
-	log_file->flush();
-	if(msg_file != nullptr) {
-		msg_file->flush();
-	}
 	
-	// in append mode, always close the file after writing to it
-	if(log_append_mode) {
-		log_file->close();
-		log_file->clear();
-		if(msg_file != nullptr) {
-			msg_file->close();
-			msg_file->clear();
+	logger::rotation_options rotation;
+	{
+		GUARD(log_rotation_lock);
+		rotation = log_rotation;
+	}
+	if(log_file != nullptr && !log_file_entries.empty()) {
+		if(log_file->needs_rotation(rotation, log_file_size)) {
+			log_file->rotate(rotation);
+		}
+		log_file->write(log_file_entries);
+	}
+	if(msg_file != nullptr && !msg_file_entries.empty()) {
+		if(msg_file->needs_rotation(rotation, msg_file_size)) {
+			msg_file->rotate(rotation);
 		}
+		msg_file->write(msg_file_entries);
 	}
 	
 	// now that everything has been written, clear the output store
 	log_output_store.clear();
-	
-	// update #runs counter
-	++run_num;
 }
 
 void logger::init(const size_t verbosity,
@@ -185,20 +721,21 @@ void logger::init(const size_t verbosity,
 		msg_filename = msg_filename_;
 	}
 	
-	log_file = make_unique<ofstream>(log_filename, (append_mode ? ofstream::app | ofstream::out : ofstream::out));
-	if(!log_file->is_open()) {
+	log_file = make_unique<log_file_t>();
+	if(!log_file->open(log_filename, append_mode)) {
 		cerr << "LOG ERROR: couldn't open log file (" << log_filename << ")!" << endl;
 	}
+	log_file->find_segments();
 	
 	if(separate_msg_file && verbosity >= (size_t)logger::LOG_TYPE::SIMPLE_MSG) {
-		msg_file = make_unique<ofstream>(msg_filename, (append_mode ? ofstream::app | ofstream::out : ofstream::out));
-		if(!msg_file->is_open()) {
+		msg_file = make_unique<log_file_t>();
+		if(!msg_file->open(msg_filename, append_mode)) {
 			cerr << "LOG ERROR: couldn't open msg log file (" << msg_filename << ")!" << endl;
 		}
+		msg_file->find_segments();
 	}
 	
 	log_verbosity = (logger::LOG_TYPE)verbosity;
-	log_append_mode = append_mode;
 	log_use_time = use_time;
 	log_use_color = use_color;
 #if defined(__WINDOWS__)
@@ -236,13 +773,19 @@ void logger::destroy() {
 
 void logger::flush() {
 	if(!log_thread) return;
-	const uint32_t cur_run = log_thread->run_num;
-	while(cur_run == log_thread->run_num) {
-		this_thread::yield();
-	}
+	// request a new logger run that starts after this point and block until it has finished
+	unique_lock<mutex> lock(log_wake_lock);
+	if (!log_thread_running) return;
+	const auto flush_run = log_run_started + 1u;
+	log_flush_requested = max(log_flush_requested, flush_run);
+	log_thread_ptr->notify();
+	log_run_done_cv.wait(lock, [flush_run] {
+		return (log_run_finished >= flush_run || !log_thread_running);
+	});
 }
 
-bool logger::prepare_log(stringstream& buffer, const LOG_TYPE& type, const char* file, const char* func) {
+bool logger::prepare_log(stringstream& buffer, const LOG_TYPE& type, const char* file, const char* func,
+						 const chrono::system_clock::time_point& log_time) {
 	// check verbosity level and leave or continue accordingly
 	if(log_verbosity < type) {
 		return false;
@@ -289,8 +832,7 @@ bool logger::prepare_log(stringstream& buffer, const LOG_TYPE& type, const char*
 		if(log_use_time) {
 			buffer << "[";
 			char time_str[64];
-			const auto system_now = chrono::system_clock::now();
-			const auto cur_time = chrono::system_clock::to_time_t(system_now);
+			const auto cur_time = chrono::system_clock::to_time_t(log_time);
 #if !defined(_MSC_VER)
 			struct tm* local_time = localtime(&cur_time);
 			strftime(time_str, sizeof(time_str), "%H:%M:%S", local_time);
@@ -302,7 +844,7 @@ bool logger::prepare_log(stringstream& buffer, const LOG_TYPE& type, const char*
 			buffer << time_str;
 			buffer << ".";
 			buffer << setw(const_math::int_width(chrono::system_clock::period::den));
-			buffer << system_now.time_since_epoch().count() % chrono::system_clock::period::den << setw(0);
+			buffer << log_time.time_since_epoch().count() % chrono::system_clock::period::den << setw(0);
 			buffer << "] ";
 		}
 		else buffer << " ";
@@ -324,21 +866,32 @@ bool logger::prepare_log(stringstream& buffer, const LOG_TYPE& type, const char*
 	return true;
 }
 
-void logger::log_internal(stringstream& buffer, const LOG_TYPE& type, const char* str) REQUIRES(!log_store_lock) {
-	// this is the final log function
+void logger::format_internal(stringstream& buffer, const char* str) {
+	// this is the final format function
 	if (str != nullptr) {
 		while (*str) {
 			buffer << *str++;
 		}
 	}
 	buffer << endl;
+}
+
+void logger::store_log(const LOG_TYPE& type, stringstream& buffer) REQUIRES(!log_store_lock) {
+	// if this thread has logged binary records, remember the current ring position (-> ordering, see drain_binary_rings)
+	log_entry_t entry { type, buffer.str() };
+	if (const auto& ring = binary_ring_handle.ring; ring) {
+		entry.ring_id = ring->id;
+		entry.ring_pos = ring->write_pos.load(memory_order_relaxed);
+	}
 	
 	// add string to log store/queue
 	while(!log_store_lock.try_lock()) {
 		this_thread::yield();
 	}
-	log_store.emplace_back(type, buffer.str());
+	log_store.emplace_back(move(entry));
 	log_store_lock.unlock();
+	
+	notify_logger(type == LOG_TYPE::ERROR_MSG);
 }
 
 void logger::set_verbosity(const LOG_TYPE& verbosity) {
@@ -352,3 +905,45 @@ logger::LOG_TYPE logger::get_verbosity() {
 bool logger::is_initialized() {
 	return log_initialized;
 }
+
+void logger::set_binary_logging(const bool enable) {
+	log_binary_mode = enable;
+}
+
+bool logger::is_binary_logging() {
+	return log_binary_mode;
+}
+
+void logger::set_rotation(const rotation_options& options) {
+	GUARD(log_rotation_lock);
+	log_rotation = options;
+}
+
+uint8_t* logger::binary_log_reserve(const size_t size) {
+	if (size > binary_log_ring::capacity / 4u) {
+		return nullptr;
+	}
+	auto ring = binary_ring_handle.get();
+	const auto write_pos = ring->write_pos.load(memory_order_relaxed);
+	const auto offset = size_t(write_pos & (binary_log_ring::capacity - 1u));
+	// records are always contiguous -> if the record doesn't fit at the end, pad the remainder and wrap around
+	const auto padding = (binary_log_ring::capacity - offset < size ? binary_log_ring::capacity - offset : 0u);
+	const auto used = write_pos - ring->read_pos.load(memory_order_acquire);
+	if (used + padding + size > binary_log_ring::capacity) {
+		// full -> caller falls back to the default path
+		return nullptr;
+	}
+	if (padding > 0) {
+		const uint32_t padding_header[2] { uint32_t(padding), 0u /* no type -> padding */ };
+		memcpy(&ring->data[offset], padding_header, sizeof(padding_header));
+	}
+	ring->reserved_pos = write_pos;
+	ring->reserved_size = padding + size;
+	return &ring->data[padding > 0 ? 0u : offset];
+}
+
+void logger::binary_log_commit(const LOG_TYPE& type) {
+	auto ring = binary_ring_handle.get();
+	ring->write_pos.store(ring->reserved_pos + ring->reserved_size, memory_order_release);
+	notify_logger(type == LOG_TYPE::ERROR_MSG);
+}
@@ -25,6 +25,9 @@
 #include <type_traits>
 #include <iostream>
 #include <iomanip>
+#include <string_view>
+#include <tuple>
+#include <chrono>
 using namespace std;
 
 //! floor logging functions, use appropriately
@@ -78,17 +81,24 @@ public:
 	//! destroys the logger (also makes sure everything has been written to the console and log file)
 	static void destroy();
 	
-	//! flushes the currently stored log messages (blocks until logger thread has run once)
+	//! flushes the currently stored log messages (blocks until logger thread has run once and synced the log files to disk)
 	static void flush();
 	
 	//! log entry function, this will create a buffer and insert the log msgs start info (type, file name, ...) and
 	//! finally call the internal log function (that does the actual logging)
+	//! NOTE: in binary logging mode, this only records the raw arguments (if possible) and defers all formatting to the logger thread
 	template<size_t computed_arg_count, typename... Args>
 	static void log(const LOG_TYPE type, const char* file, const char* func, const char* str,
 					Args&&... args) __attribute__((enable_if(computed_arg_count == sizeof...(Args), "valid"))) {
+		if constexpr ((is_binary_loggable<Args>() && ...)) {
+			if (log_binary(type, file, func, str, args...)) {
+				return;
+			}
+		}
 		stringstream buffer;
-		if(!prepare_log(buffer, type, file, func)) return;
-		log_internal(buffer, type, str, std::forward<Args>(args)...);
+		if(!prepare_log(buffer, type, file, func, chrono::system_clock::now())) return;
+		format_internal(buffer, str, std::forward<Args>(args)...);
+		store_log(type, buffer);
 	}
 	
 	//! fail function when the argument count is incorrect
@@ -106,14 +116,173 @@ public:
 	//! returns true if the logger was initialized
 	static bool is_initialized();
 	
+	//! log file rotation options
+	struct rotation_options {
+		//! rotate a log file once writing to it would exceed this size in bytes (0 = disabled)
+		uint64_t max_file_size { 0u };
+		//! rotate a log file once it has been written to for this long (0 = disabled)
+		chrono::seconds max_age { 0 };
+		//! max amount of retained rotated segments per log file, older segments are deleted (0 = unlimited)
+		uint32_t max_segments { 0u };
+		//! if enabled, rotated segments are gzip-compressed in the background
+		//! NOTE: requires "gzip" to be installed (not supported on Windows), a warning is printed if it isn't available
+		//!       and segments are then kept uncompressed
+		bool compress { false };
+	};
+	//! sets the log file rotation options:
+	//! rotated log files are renamed to "<log file>.<sequence number>" (or "<...>.gz" if compressed),
+	//! with the sequence number continuing from already existing segments
+	static void set_rotation(const rotation_options& options);
+	
+	//! enables or disables binary logging:
+	//! when enabled, log calls only record the format string pointer and their raw arguments into a per-thread
+	//! lock-free ring buffer, the actual formatting is deferred to the logger thread
+	//! NOTE: log calls with non-trivially-copyable argument types (other than strings) or that don't fit into the
+	//!       calling thread's ring buffer fall back to the default path, message order is only kept per thread
+	static void set_binary_logging(const bool enable);
+	//! returns true if binary logging is enabled
+	static bool is_binary_logging();
+	
+	//! internal: binary log record header, the encoded arguments directly follow this header
+	struct binary_log_record {
+		//! decodes the arguments following the header and formats them into "buffer" according to "str"
+		using format_func_type = void (*)(stringstream& buffer, const char* str, const uint8_t* args);
+		
+		//! total size of this record (including this header), always a multiple of 8
+		uint32_t size;
+		//! log type, or 0 if this is a padding record
+		LOG_TYPE type;
+		format_func_type format;
+		const char* str;
+		const char* file;
+		const char* func;
+		//! system_clock time (since epoch) at which the log call was made
+		chrono::system_clock::rep time;
+	};
+	
 protected:
+	friend class logger_thread;
+	
 	// static class
 	logger(const logger&) = delete;
 	~logger() = delete;
 	logger& operator=(const logger&) = delete;
 	
 	//! handles the formatting of log messages
-	static bool prepare_log(stringstream& buffer, const LOG_TYPE& type, const char* file, const char* func);
+	static bool prepare_log(stringstream& buffer, const LOG_TYPE& type, const char* file, const char* func,
+							const chrono::system_clock::time_point& log_time);
+	
+	//! adds a fully formatted log message to the log store
+	static void store_log(const LOG_TYPE& type, stringstream& buffer);
+	
+	//! reserves "size" bytes in the calling thread's binary log ring buffer,
+	//! returns nullptr if binary logging is disabled or the ring buffer is full
+	static uint8_t* binary_log_reserve(const size_t size);
+	//! commits the previously reserved record of the calling thread and notifies the logger thread
+	static void binary_log_commit(const LOG_TYPE& type);
+	
+	//! returns true if the specified type (and its value) can be stored in a binary log record
+	template <typename T> static constexpr bool is_binary_string() {
+		using decayed_type = decay_t<T>;
+		return (is_same_v<decayed_type, string> ||
+				is_same_v<decayed_type, string_view> ||
+				is_same_v<decayed_type, char*> ||
+				is_same_v<decayed_type, const char*> ||
+				is_same_v<decayed_type, unsigned char*> ||
+				is_same_v<decayed_type, const unsigned char*>);
+	}
+	template <typename T> static constexpr bool is_binary_loggable() {
+		return (is_binary_string<T>() || (is_trivially_copyable_v<decay_t<T>> && is_default_constructible_v<decay_t<T>>));
+	}
+	//! decoded binary log argument type (strings are decoded as views into the record)
+	template <typename T>
+	using binary_decoded_type = conditional_t<is_binary_string<T>(), string_view, decay_t<T>>;
+	
+	//! returns the encoded size of the specified binary log argument
+	template <typename T> static size_t binary_arg_size(const T& value) {
+		if constexpr (is_binary_string<T>()) {
+			return sizeof(uint32_t) + binary_string_view(value).size();
+		} else {
+			return sizeof(decay_t<T>);
+		}
+	}
+	template <typename T> static string_view binary_string_view(const T& value) {
+		if constexpr (is_same_v<decay_t<T>, string> || is_same_v<decay_t<T>, string_view>) {
+			return value;
+		} else {
+			return (value != nullptr ? string_view((const char*)value) : string_view("(null)"));
+		}
+	}
+	
+	//! encodes the specified binary log argument at "ptr" and advances "ptr"
+	template <typename T> static void binary_encode(uint8_t*& ptr, const T& value) {
+		if constexpr (is_binary_string<T>()) {
+			const auto view = binary_string_view(value);
+			const auto len = uint32_t(view.size());
+			memcpy(ptr, &len, sizeof(len));
+			memcpy(ptr + sizeof(len), view.data(), len);
+			ptr += sizeof(len) + len;
+		} else {
+			memcpy((void*)ptr, (const void*)&value, sizeof(decay_t<T>));
+			ptr += sizeof(decay_t<T>);
+		}
+	}
+	
+	//! decodes a binary log argument of type T at "ptr" and advances "ptr"
+	template <typename T> static binary_decoded_type<T> binary_decode(const uint8_t*& ptr) {
+		if constexpr (is_binary_string<T>()) {
+			uint32_t len = 0;
+			memcpy(&len, ptr, sizeof(len));
+			string_view ret((const char*)ptr + sizeof(len), len);
+			ptr += sizeof(len) + len;
+			return ret;
+		} else {
+			binary_decoded_type<T> ret;
+			memcpy((void*)&ret, (const void*)ptr, sizeof(ret));
+			ptr += sizeof(ret);
+			return ret;
+		}
+	}
+	
+	//! decodes all arguments of a binary log record and formats them (called by the logger thread)
+	template <typename... Args> static void format_binary(stringstream& buffer, const char* str, const uint8_t* args) {
+		// NOTE: evaluation order inside braced init lists is guaranteed to be left-to-right
+		tuple<binary_decoded_type<Args>...> decoded_args { binary_decode<Args>(args)... };
+		apply([&buffer, &str](auto&&... decoded) {
+			format_internal(buffer, str, decoded...);
+		}, decoded_args);
+	}
+	
+	//! tries to record the log call in the calling thread's binary log ring buffer,
+	//! returns true if the log call has been handled (recorded or filtered)
+	template <typename... Args>
+	static bool log_binary(const LOG_TYPE& type, const char* file, const char* func, const char* str, const Args&... args) {
+		if (!is_binary_logging()) {
+			return false;
+		}
+		if (get_verbosity() < type) {
+			return true;
+		}
+		const auto record_size = ((sizeof(binary_log_record) + (size_t(0) + ... + binary_arg_size(args)) + 7u) & ~size_t(7u));
+		auto data = binary_log_reserve(record_size);
+		if (data == nullptr) {
+			return false;
+		}
+		binary_log_record record {
+			.size = uint32_t(record_size),
+			.type = type,
+			.format = &format_binary<Args...>,
+			.str = str,
+			.file = file,
+			.func = func,
+			.time = chrono::system_clock::now().time_since_epoch().count(),
+		};
+		memcpy(data, &record, sizeof(record));
+		[[maybe_unused]] auto args_ptr = data + sizeof(record);
+		(binary_encode(args_ptr, args), ...);
+		binary_log_commit(type);
+		return true;
+	}
 	
 	//
 	template <bool is_enum_flag, typename U> struct enum_helper_type {
@@ -196,26 +365,26 @@ protected:
 		}
 	}
 	
-	//! internal logging function (will be called in the end when there are no more args)
-	static void log_internal(stringstream& buffer, const LOG_TYPE& type, const char* str);
-	//! internal logging function (entry point and arg iteration)
-	template <typename T, typename... Args> static void log_internal(stringstream& buffer, const LOG_TYPE& type,
-																	 const char* str, T&& value, Args&&... args) {
+	//! internal formatting function (will be called in the end when there are no more args)
+	static void format_internal(stringstream& buffer, const char* str);
+	//! internal formatting function (entry point and arg iteration)
+	template <typename T, typename... Args> static void format_internal(stringstream& buffer, const char* str,
+																		T&& value, Args&&... args) {
 		for (size_t i = 0, len = __builtin_strlen(str); i < len; ++i) {
 			const auto& ch = str[i];
 			if (ch == '$') {
 				if (i + 1 == len) {
 					// end of string with no format
 					handle_format(buffer, '\0', value);
-					log_internal(buffer, type, nullptr);
+					format_internal(buffer, nullptr);
 					return;
 				} else if (i + 1 < len && str[i + 1] != '$') {
 					handle_format(buffer, str[i + 1], value);
 					const auto next_char_offset = size_t(is_format_char(str[i + 1]) ? 2 : 1);
 					if (i + next_char_offset < len) {
-						log_internal(buffer, type, &str[i + next_char_offset], std::forward<Args>(args)...);
+						format_internal(buffer, &str[i + next_char_offset], std::forward<Args>(args)...);
 					} else {
-						log_internal(buffer, type, nullptr);
+						format_internal(buffer, nullptr);
 					}
 					return;
 				}
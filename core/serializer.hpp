@@ -20,6 +20,9 @@
 #define __FLOOR_SERIALIZER_HPP__
 
 #include <floor/core/cpp_headers.hpp>
+#include <floor/core/logger.hpp>
+#include <string_view>
+#include <span>
 #include <floor/constexpr/ext_traits.hpp>
 #include <floor/math/vector_lib.hpp>
 
@@ -61,19 +64,214 @@ static constexpr size_t static_serialization_size() { \
 size_t serialization_size() const { \
 	if constexpr(is_serialization_size_static()) { return static_serialization_size(); } \
 	return serializer<>::serialization_size(__VA_ARGS__); \
+} \
+static constexpr bool is_serialization_bulk_copyable() { \
+	typedef decltype(serializer<>::make_tuple_type_list(__VA_ARGS__)) tupled_arg_types; \
+	constexpr const bool ret = (is_trivially_copyable_v<class_type> && \
+								static_serialization_size() == sizeof(class_type) && \
+								serializer<>::is_serialization_bulk_copyable<tupled_arg_types>( \
+									make_index_sequence<tuple_size<tupled_arg_types>::value>())); \
+	return ret; \
+} \
+bool is_serialization_layout_packed() const { \
+	return serializer<>::is_packed_layout(this, sizeof(*this), __VA_ARGS__); \
 }
 
+//! set this in-class with member variables that should be serializable in a tagged and versioned format,
+//! which allows reading data that was written by older or newer versions of the class:
+//!  * each member is stored with its field id (1-based position in the member list) and its serialized size
+//!  * members that are missing in the serialized data keep their default value
+//!  * members with an unknown field id (written by a newer version) are skipped
+//! if the class has a "void serialization_upgrade(const uint32_t from_version)" member function,
+//! it is called after deserializing data that was written with an older "version"
+//! NOTE: the class must be default constructible, new members must only be appended to the member list,
+//!       and the type of an existing member must not be changed (retired members must be kept in the list)
+//! NOTE: this is slower and larger than the positional SERIALIZATION format, so only use it for persisted data
+//! NOTE: truncated or corrupt tagged data is detected and reported via serializer::has_tagged_decode_error()
+#define SERIALIZATION_VERSIONED(class_type, version, ...) \
+template <typename storage_type> \
+void serialize(serializer<storage_type>& s) { \
+	s.serialize_tagged(serialization_version(), __VA_ARGS__); \
+} \
+template <typename storage_type> \
+static class_type deserialize(serializer<storage_type>& s) { \
+	class_type obj {}; \
+	obj.deserialize_inplace(s); \
+	return obj; \
+} \
+template <typename storage_type> \
+void deserialize_inplace(serializer<storage_type>& s) { \
+	const auto from_version = s.deserialize_tagged_inplace(__VA_ARGS__); \
+	if (!s.has_tagged_decode_error()) { \
+		serializer<storage_type>::upgrade_tagged(*this, from_version); \
+	} \
+} \
+template <typename storage_type> \
+static unique_ptr<class_type> deserialize_dynamic(serializer<storage_type>& s) { \
+	auto obj = make_unique<class_type>(); \
+	obj->deserialize_inplace(s); \
+	return obj; \
+} \
+static constexpr uint32_t serialization_version() { return (version); } \
+static constexpr bool is_serializable() { return true; } \
+static constexpr bool is_serialization_size_static() { return false; } \
+static constexpr size_t static_serialization_size() { return 0; } \
+size_t serialization_size() const { \
+	return serializer<>::tagged_serialization_size(serialization_version(), __VA_ARGS__); \
+} \
+static constexpr bool is_serialization_bulk_copyable() { return false; } \
+bool is_serialization_layout_packed() const { return false; }
+
 //! serialization and deserialization of classes (class members)
 //! "storage_type" must implement byte-wise .data(), .begin(), .end(), .insert(point, first, last), .erase(first, last)
+//! NOTE: write-only storage types only need .end() and .insert(end(), first, last) (e.g. serializer_span_storage
+//!       writing into caller-supplied memory or serializer_iovec_storage producing a scatter/gather list)
+//! NOTE: deserialization advances a read offset and only erases the consumed data from the storage once
+//!       the outermost deserialize/deserialize_inplace call has finished (-> linear instead of quadratic complexity)
+//! NOTE: if "storage_type" is a zero-copy storage (has "static constexpr bool is_zero_copy = true", e.g. serializer_read_cursor),
+//!       string_view and span<const uint8_t> members are deserialized as views into the input data
 template <typename storage_type = vector<uint8_t>>
 class serializer {
 protected:
 	storage_type storage;
+	//! current read offset into "storage" (everything before it has already been deserialized)
+	size_t read_offset { 0u };
+	//! current deserialization nesting depth
+	uint32_t read_depth { 0u };
+	//! set if decoding tagged data failed (truncated or corrupt data)
+	bool tagged_decode_error { false };
+	//! absolute read offset that may not be exceeded (end of the tagged field that is currently being decoded),
+	//! reads beyond it are rejected and flag "read_overrun"
+	size_t read_limit { ~size_t(0u) };
+	//! set if a read was rejected, because it would have exceeded "read_limit"
+	bool read_overrun { false };
+	
+	//! returns the current read position
+	floor_inline_always const uint8_t* read_ptr() const {
+		return (const uint8_t*)storage.data() + read_offset;
+	}
+	
+	//! returns true if "size" bytes can be read at the current read position without exceeding the read limit,
+	//! flags a read overrun otherwise
+	floor_inline_always bool can_read(const size_t size) {
+		if (size <= read_limit && read_offset <= read_limit - size) {
+			return true;
+		}
+		read_overrun = true;
+		return false;
+	}
+	
+	//! marks "size" bytes at the current read position as consumed
+	floor_inline_always void consume(const size_t size) {
+		read_offset += size;
+	}
+	
+	//! erases all consumed data from the storage
+	void compact() {
+		if (read_offset > 0u) {
+			storage.erase(storage.begin(), storage.begin() + ptrdiff_t(read_offset));
+			read_offset = 0u;
+		}
+	}
+	
+	//! tracks the outermost deserialization call, compacts the storage once it has finished
+	struct read_scope {
+		serializer& ser;
+		explicit read_scope(serializer& ser_) : ser(ser_) {
+			++ser.read_depth;
+		}
+		~read_scope() {
+			if (--ser.read_depth == 0u) {
+				ser.compact();
+			}
+		}
+	};
+	
+	//! writes "value" as an unsigned LEB128 varint
+	void write_varint(uint64_t value) {
+		uint8_t bytes[10];
+		uint32_t count = 0;
+		do {
+			bytes[count++] = uint8_t((value & 0x7Fu) | (value >= 0x80u ? 0x80u : 0u));
+			value >>= 7u;
+		} while (value != 0u);
+		storage.insert(storage.end(), bytes, bytes + count);
+	}
+	
+	//! returns the amount of bytes in the storage that have not been deserialized yet
+	size_t remaining_size() const {
+		return size_t(storage.end() - storage.begin()) - read_offset;
+	}
+	
+	//! returns the amount of bytes that may still be read (remaining data, bounded by the read limit)
+	size_t readable_size() const {
+		return (read_offset <= read_limit ? std::min(remaining_size(), read_limit - read_offset) : 0u);
+	}
+	
+	//! reads an unsigned LEB128 varint into "value",
+	//! returns false if the varint is truncated (end of storage) or longer than 10 bytes
+	bool read_varint(uint64_t& value) {
+		const auto data = read_ptr();
+		const auto max_count = std::min(readable_size(), size_t(10u));
+		value = 0u;
+		for (uint32_t count = 0, shift = 0; count < max_count; ++count, shift += 7u) {
+			const auto byte = data[count];
+			value |= uint64_t(byte & 0x7Fu) << shift;
+			if ((byte & 0x80u) == 0u) {
+				consume(count + 1u);
+				return true;
+			}
+		}
+		return false;
+	}
+	
+	//! flags the tagged data as invalid, skips all remaining data and returns "ret"
+	template <typename ret_type>
+	ret_type fail_tagged_decode(const char* msg, const ret_type ret) {
+		log_error("failed to deserialize tagged data: $", msg);
+		tagged_decode_error = true;
+		read_offset = size_t(storage.end() - storage.begin());
+		return ret;
+	}
+	
+	//! returns the amount of bytes needed to store "value" as a varint
+	static constexpr size_t varint_size(uint64_t value) {
+		size_t ret = 1u;
+		while (value >= 0x80u) {
+			value >>= 7u;
+			++ret;
+		}
+		return ret;
+	}
+	
+	template <typename type>
+	void serialize_tagged_field(const uint64_t field_id, const type& member) {
+		write_varint(field_id);
+		write_varint(serialization<type>::size(member));
+		serialization<type>::serialize(*this, storage, member);
+	}
+	
+	//! deserializes the member with index "field_idx" (unrolled at compile-time)
+	template <size_t... indices, typename... types>
+	void deserialize_tagged_field(const uint64_t field_idx, index_sequence<indices...>, types&... members) {
+		((field_idx == indices ?
+		  (serialization<remove_const_t<types>>::deserialize_inplace(*this, storage, const_cast<remove_const_t<types>&>(members)),
+		   true) : false) || ...);
+	}
+	
+	//! returns true if deserialized views may point into the storage
+	static constexpr bool is_zero_copy_storage() {
+		if constexpr (requires { storage_type::is_zero_copy; }) {
+			return storage_type::is_zero_copy;
+		}
+		return false;
+	}
 	
 public:
 	explicit serializer(storage_type&& storage_) : storage(forward<storage_type&&>(storage_)) {}
 	
 	//! returns the raw data storage of this serializer
+	//! NOTE: data that is consumed by an in-progress deserialization is still part of the storage
 	storage_type& get_storage() { return storage; }
 	const storage_type& get_storage() const { return storage; }
 	
@@ -86,6 +284,112 @@ public:
 		}
 	}
 	
+	//! serializes the specified parameters into this serializer data container,
+	//! computing the exact required size up front and reserving it at once (if the storage type supports this)
+	template <typename type, typename... types>
+	void serialize_presized(const type& arg, const types&... args) {
+		if constexpr (requires(storage_type& stor) { stor.reserve(size_t(0)); stor.size(); }) {
+			storage.reserve(storage.size() + serialization_size(arg, args...));
+		}
+		serialize(arg, args...);
+	}
+	
+	//! serializes the specified parameters in the tagged format (see SERIALIZATION_VERSIONED):
+	//! version, then for each member: field id, size and data, terminated by field id 0
+	template <typename... types>
+	void serialize_tagged(const uint32_t version, const types&... members) {
+		write_varint(version);
+		uint64_t field_id = 1u;
+		(serialize_tagged_field(field_id++, members), ...);
+		write_varint(0u);
+	}
+	
+	//! in-place deserializes the specified parameters from the tagged format (see SERIALIZATION_VERSIONED),
+	//! returns the version the data was written with
+	//! NOTE: each member is decoded within the bounds of its stored field, i.e. corrupt member data can't read beyond it
+	//! NOTE: if the data is truncated or corrupt, all remaining data is skipped, has_tagged_decode_error() returns true
+	//!       and 0 is returned as the version, members may be partially deserialized
+	template <typename... types>
+	uint32_t deserialize_tagged_inplace(types&... members) {
+		read_scope scope(*this);
+		uint64_t version = 0u;
+		if (!read_varint(version)) {
+			return fail_tagged_decode("truncated version", 0u);
+		}
+		for (;;) {
+			uint64_t field_id = 0u;
+			if (!read_varint(field_id)) {
+				return fail_tagged_decode("truncated field id (missing end marker?)", 0u);
+			}
+			if (field_id == 0u) {
+				break;
+			}
+			uint64_t field_size = 0u;
+			if (!read_varint(field_size)) {
+				return fail_tagged_decode("truncated field size", 0u);
+			}
+			if (field_size > readable_size()) {
+				return fail_tagged_decode("field size exceeds the remaining data", 0u);
+			}
+			const auto field_end = read_offset + field_size;
+			if (field_id <= sizeof...(members)) {
+				// decode the member within [field start, field end) only
+				const auto prev_read_limit = exchange(read_limit, field_end);
+				read_overrun = false;
+				deserialize_tagged_field(field_id - 1u, make_index_sequence<sizeof...(members)>(), members...);
+				read_limit = prev_read_limit;
+				if (tagged_decode_error) {
+					// nested tagged data failed to decode
+					return 0u;
+				}
+				if (read_overrun) {
+					read_overrun = false;
+					return fail_tagged_decode("field data exceeds the stored field size", 0u);
+				}
+				if (read_offset != field_end) {
+					log_error("tagged field #$: deserialized $ bytes, but the stored size is $ bytes (changed member type?)",
+							  field_id, read_offset + field_size - field_end, field_size);
+					read_offset = field_end;
+				}
+			} else {
+				// unknown field (written by a newer version) -> skip
+				read_offset = field_end;
+			}
+		}
+		return uint32_t(version);
+	}
+	
+	//! returns true if decoding tagged data failed (truncated or corrupt data), reset via clear_tagged_decode_error()
+	bool has_tagged_decode_error() const {
+		return tagged_decode_error;
+	}
+	void clear_tagged_decode_error() {
+		tagged_decode_error = false;
+	}
+	
+	//! calls obj.serialization_upgrade(from_version) if "obj" was deserialized from data of an older version
+	//! and the class implements this
+	template <typename obj_type>
+	static void upgrade_tagged(obj_type& obj, const uint32_t from_version) {
+		if constexpr (requires { obj.serialization_upgrade(from_version); }) {
+			if (from_version < obj_type::serialization_version()) {
+				obj.serialization_upgrade(from_version);
+			}
+		}
+	}
+	
+	//! returns the size in bytes required to serialize the specified args in the tagged format
+	template <typename... types>
+	static size_t tagged_serialization_size(const uint32_t version, const types&... members) {
+		size_t ret = varint_size(version) + 1u /* end marker */;
+		uint64_t field_id = 1u;
+		([&ret, &field_id](const auto& member) {
+			const auto member_size = serialization<decay_t<decltype(member)>>::size(member);
+			ret += varint_size(field_id++) + varint_size(member_size) + member_size;
+		}(members), ...);
+		return ret;
+	}
+	
 	//! since "is_constructible" is pretty much useless for this purpose, figure out ourselves if we can directly construct
 	//! a type from its serialized members or if we also need to init/construct an empty base class
 	template <typename obj_type = void>
@@ -110,6 +414,7 @@ public:
 		static_assert(is_direct || is_empty_base,
 					  "obj_type must be directly constructible or directly constructible with an empty base");
 		
+		read_scope scope(*this);
 		if constexpr(is_direct) {
 			return { serialization<tuple_element_t<indices, tupled_arg_types>>::deserialize(*this, storage)... };
 		}
@@ -122,6 +427,7 @@ public:
 	//! in-place deserializes a "obj_type" class object from this serializer data container
 	template <typename type, typename... types>
 	void deserialize_inplace(type& arg, types&... args) {
+		read_scope scope(*this);
 		serialization<type>::deserialize_inplace(*this, storage, const_cast<remove_const_t<type>&>(arg));
 		if constexpr(sizeof...(args) > 0) {
 			deserialize_inplace(args...);
@@ -155,6 +461,33 @@ public:
 		return ret;
 	}
 	
+	//! returns true if all specified types are serialized as their exact in-memory representation
+	template <typename tupled_arg_types, size_t... indices>
+	static constexpr bool is_serialization_bulk_copyable(index_sequence<indices...>) {
+		return (serialization<tuple_element_t<indices, tupled_arg_types>>::is_bulk_copyable() && ...);
+	}
+	
+	//! returns true if the specified members of "obj" are laid out contiguously and in the specified order (no padding),
+	//! i.e. if the serialized representation of "obj" is identical to its in-memory representation
+	template <typename... types>
+	static bool is_packed_layout(const void* obj, const size_t obj_size, const types&... members) {
+		const auto obj_ptr = (const uint8_t*)obj;
+		size_t offset = 0u;
+		const auto is_next_member = [obj_ptr, &offset]<typename member_type>(const member_type& member) {
+			if constexpr (!serialization<member_type>::is_bulk_copyable()) {
+				return false;
+			} else {
+				if ((const uint8_t*)&member != obj_ptr + offset ||
+					!serialization<member_type>::has_bulk_layout(member)) {
+					return false;
+				}
+				offset += sizeof(member_type);
+				return true;
+			}
+		};
+		return ((is_next_member(members) && ...) && offset == obj_size);
+	}
+	
 	//! returns the size in bytes required to serialize the specified args / class
 	template <typename type, typename... types>
 	static size_t serialization_size(const type& arg, const types&... args) {
@@ -186,6 +519,7 @@ protected:
 		}
 		static constexpr bool is_size_static() { return false; }
 		static constexpr size_t static_size() { return 0; }
+		static constexpr bool is_bulk_copyable() { return false; }
 	};
 	
 	//! user-friendly error if serialization has not been implemented for a type
@@ -224,19 +558,25 @@ protected:
 			memcpy(bytes, &value, sizeof(arith_type));
 			storage.insert(storage.end(), begin(bytes), end(bytes));
 		}
-		static arith_type deserialize(serializer&, storage_type& storage) {
-			arith_type ret;
-			memcpy(&ret, storage.data(), sizeof(arith_type));
-			storage.erase(storage.begin(), storage.begin() + sizeof(arith_type));
+		static arith_type deserialize(serializer& ser, storage_type&) {
+			arith_type ret {};
+			if (ser.can_read(sizeof(arith_type))) {
+				memcpy(&ret, ser.read_ptr(), sizeof(arith_type));
+				ser.consume(sizeof(arith_type));
+			}
 			return ret;
 		}
-		static void deserialize_inplace(serializer&, storage_type& storage, arith_type& val) {
-			memcpy(&val, storage.data(), sizeof(arith_type));
-			storage.erase(storage.begin(), storage.begin() + sizeof(arith_type));
+		static void deserialize_inplace(serializer& ser, storage_type&, arith_type& val) {
+			if (ser.can_read(sizeof(arith_type))) {
+				memcpy(&val, ser.read_ptr(), sizeof(arith_type));
+				ser.consume(sizeof(arith_type));
+			}
 		}
 		static constexpr bool is_size_static() { return true; }
 		static constexpr size_t static_size() { return sizeof(arith_type); }
 		static constexpr size_t size(const arith_type&) { return static_size(); }
+		static constexpr bool is_bulk_copyable() { return true; }
+		static constexpr bool has_bulk_layout(const arith_type&) { return true; }
 	};
 	
 	// enums
@@ -247,19 +587,25 @@ protected:
 			memcpy(bytes, &value, sizeof(enum_type));
 			storage.insert(storage.end(), begin(bytes), end(bytes));
 		}
-		static enum_type deserialize(serializer&, storage_type& storage) {
-			enum_type ret;
-			memcpy(&ret, storage.data(), sizeof(enum_type));
-			storage.erase(storage.begin(), storage.begin() + sizeof(enum_type));
+		static enum_type deserialize(serializer& ser, storage_type&) {
+			enum_type ret {};
+			if (ser.can_read(sizeof(enum_type))) {
+				memcpy(&ret, ser.read_ptr(), sizeof(enum_type));
+				ser.consume(sizeof(enum_type));
+			}
 			return ret;
 		}
-		static void deserialize_inplace(serializer&, storage_type& storage, enum_type& val) {
-			memcpy(&val, storage.data(), sizeof(enum_type));
-			storage.erase(storage.begin(), storage.begin() + sizeof(enum_type));
+		static void deserialize_inplace(serializer& ser, storage_type&, enum_type& val) {
+			if (ser.can_read(sizeof(enum_type))) {
+				memcpy(&val, ser.read_ptr(), sizeof(enum_type));
+				ser.consume(sizeof(enum_type));
+			}
 		}
 		static constexpr bool is_size_static() { return true; }
 		static constexpr size_t static_size() { return sizeof(enum_type); }
 		static constexpr size_t size(const enum_type&) { return static_size(); }
+		static constexpr bool is_bulk_copyable() { return true; }
+		static constexpr bool has_bulk_layout(const enum_type&) { return true; }
 	};
 	
 	// floor vector types
@@ -277,25 +623,38 @@ protected:
 			}
 			storage.insert(storage.end(), begin(bytes), end(bytes));
 		}
-		static vec_type deserialize(serializer&, storage_type& storage) {
+		static vec_type deserialize(serializer& ser, storage_type&) {
 			vec_type ret;
+			if (!ser.can_read(static_size())) {
+				return ret;
+			}
+			const auto data = ser.read_ptr();
 #pragma unroll
 			for(uint32_t i = 0; i < vec_type::dim(); ++i) {
-				memcpy(&ret[i], storage.data() + i * sizeof(scalar_type), sizeof(scalar_type));
+				memcpy(&ret[i], data + i * sizeof(scalar_type), sizeof(scalar_type));
 			}
-			storage.erase(storage.begin(), storage.begin() + sizeof(scalar_type) * vec_type::dim());
+			ser.consume(sizeof(scalar_type) * vec_type::dim());
 			return ret;
 		}
-		static void deserialize_inplace(serializer&, storage_type& storage, vec_type& val) {
+		static void deserialize_inplace(serializer& ser, storage_type&, vec_type& val) {
+			if (!ser.can_read(static_size())) {
+				return;
+			}
+			const auto data = ser.read_ptr();
 #pragma unroll
 			for(uint32_t i = 0; i < vec_type::dim(); ++i) {
-				memcpy(&val[i], storage.data() + i * sizeof(scalar_type), sizeof(scalar_type));
+				memcpy(&val[i], data + i * sizeof(scalar_type), sizeof(scalar_type));
 			}
-			storage.erase(storage.begin(), storage.begin() + sizeof(scalar_type) * vec_type::dim());
+			ser.consume(sizeof(scalar_type) * vec_type::dim());
 		}
 		static constexpr bool is_size_static() { return true; }
 		static constexpr size_t static_size() { return sizeof(scalar_type) * vec_type::dim(); }
 		static constexpr size_t size(const vec_type&) { return static_size(); }
+		static constexpr bool is_bulk_copyable() {
+			return (is_trivially_copyable_v<vec_type> && sizeof(vec_type) == static_size() &&
+					serializer::serialization<scalar_type>::is_bulk_copyable());
+		}
+		static constexpr bool has_bulk_layout(const vec_type&) { return true; }
 	};
 	
 	// string
@@ -307,52 +666,158 @@ protected:
 			storage.insert(storage.end(), begin(size.bytes), end(size.bytes));
 			storage.insert(storage.end(), begin(str), end(str));
 		}
-		static string_type deserialize(serializer&, storage_type& storage) {
-			uint64_t size = 0;
-			memcpy(&size, storage.data(), sizeof(size));
-			
+		static string_type deserialize(serializer& ser, storage_type& storage) {
 			string_type ret;
-			ret.resize(size / sizeof(char_type));
-			memcpy(&ret[0], storage.data() + sizeof(size), size);
-			
-			storage.erase(storage.begin(), storage.begin() + sizeof(size) + typename string_type::difference_type(size));
-			
+			deserialize_inplace(ser, storage, ret);
 			return ret;
 		}
-		static void deserialize_inplace(serializer&, storage_type& storage, string_type& val) {
+		static void deserialize_inplace(serializer& ser, storage_type&, string_type& val) {
 			uint64_t size = 0;
-			memcpy(&size, storage.data(), sizeof(size));
+			if (!ser.can_read(sizeof(size))) {
+				return;
+			}
+			memcpy(&size, ser.read_ptr(), sizeof(size));
+			if (size > ~size_t(0u) - sizeof(size) || !ser.can_read(sizeof(size) + size_t(size))) {
+				return;
+			}
 			
 			val.resize(size / sizeof(char_type));
-			memcpy(&val[0], storage.data() + sizeof(size), size);
+			memcpy(val.data(), ser.read_ptr() + sizeof(size), size);
 			
-			storage.erase(storage.begin(), storage.begin() + sizeof(size) + typename string_type::difference_type(size));
+			ser.consume(sizeof(size) + size);
 		}
 		static constexpr bool is_size_static() { return false; }
 		static constexpr size_t static_size() { return 0; }
 		static size_t size(const basic_string<char_type>& arg) {
 			return sizeof(uint64_t) /* size */ + arg.size() * sizeof(char_type) /* data */;
 		}
+		static constexpr bool is_bulk_copyable() { return false; }
+	};
+	
+	// string_view (serialized like a string, zero-copy deserialization)
+	template <typename char_type> requires (sizeof(char_type) == 1u)
+	struct serialization<basic_string_view<char_type>> {
+		typedef basic_string_view<char_type> string_view_type;
+		static void serialize(serializer&, storage_type& storage, const string_view_type& str) {
+			const uint64_as_bytes size { .ui64 = str.size() };
+			storage.insert(storage.end(), begin(size.bytes), end(size.bytes));
+			storage.insert(storage.end(), (const uint8_t*)str.data(), (const uint8_t*)str.data() + str.size());
+		}
+		static string_view_type deserialize(serializer& ser, storage_type&) {
+			static_assert(is_zero_copy_storage(), "string_view deserialization requires a zero-copy storage");
+			uint64_t size = 0;
+			if (!ser.can_read(sizeof(size))) {
+				return {};
+			}
+			memcpy(&size, ser.read_ptr(), sizeof(size));
+			if (size > ~size_t(0u) - sizeof(size) || !ser.can_read(sizeof(size) + size_t(size))) {
+				return {};
+			}
+			const string_view_type ret { (const char_type*)(ser.read_ptr() + sizeof(size)), size };
+			ser.consume(sizeof(size) + size);
+			return ret;
+		}
+		static void deserialize_inplace(serializer& ser, storage_type& storage, string_view_type& val) {
+			val = deserialize(ser, storage);
+		}
+		static constexpr bool is_size_static() { return false; }
+		static constexpr size_t static_size() { return 0; }
+		static size_t size(const string_view_type& arg) {
+			return sizeof(uint64_t) /* size */ + arg.size() /* data */;
+		}
+		static constexpr bool is_bulk_copyable() { return false; }
+	};
+	
+	// byte span (serialized like a vector<uint8_t>, zero-copy deserialization)
+	template <typename byte_type> requires (sizeof(byte_type) == 1u && (ext::is_arithmetic_v<byte_type> || is_same_v<byte_type, std::byte>))
+	struct serialization<span<const byte_type>> {
+		typedef span<const byte_type> span_type;
+		static void serialize(serializer&, storage_type& storage, const span_type& data) {
+			const uint64_as_bytes size { .ui64 = data.size() };
+			storage.insert(storage.end(), begin(size.bytes), end(size.bytes));
+			storage.insert(storage.end(), (const uint8_t*)data.data(), (const uint8_t*)data.data() + data.size());
+		}
+		static span_type deserialize(serializer& ser, storage_type&) {
+			static_assert(is_zero_copy_storage(), "span deserialization requires a zero-copy storage");
+			uint64_t size = 0;
+			if (!ser.can_read(sizeof(size))) {
+				return {};
+			}
+			memcpy(&size, ser.read_ptr(), sizeof(size));
+			if (size > ~size_t(0u) - sizeof(size) || !ser.can_read(sizeof(size) + size_t(size))) {
+				return {};
+			}
+			const span_type ret { (const byte_type*)(ser.read_ptr() + sizeof(size)), size };
+			ser.consume(sizeof(size) + size);
+			return ret;
+		}
+		static void deserialize_inplace(serializer& ser, storage_type& storage, span_type& val) {
+			val = deserialize(ser, storage);
+		}
+		static constexpr bool is_size_static() { return false; }
+		static constexpr size_t static_size() { return 0; }
+		static size_t size(const span_type& arg) {
+			return sizeof(uint64_t) /* size */ + arg.size() /* data */;
+		}
+		static constexpr bool is_bulk_copyable() { return false; }
 	};
 	
 	// vector
 	template <typename data_type>
 	struct serialization<vector<data_type>> {
+		typedef serializer::serialization<data_type> elem_serialization;
+		//! trivially copyable elements whose serialized and in-memory representations are identical are copied in bulk
+		//! NOTE: vector<bool> is a packed bit container (no contiguous bool storage) -> always serialized per element
+		static constexpr const bool bulk_copy { !is_same_v<data_type, bool> && elem_serialization::is_bulk_copyable() };
+		
+		//! reads the element count and checks that this many elements can be read (-> rejects corrupt counts before
+		//! allocating anything), returns false on failure
+		//! NOTE: elements with a dynamic size are at least 1 byte large (they always store a size or tagged header)
+		static bool read_count(serializer& ser, uint64_t& count) {
+			if (!ser.can_read(sizeof(count))) {
+				return false;
+			}
+			memcpy(&count, ser.read_ptr(), sizeof(count));
+			ser.consume(sizeof(count));
+			constexpr const size_t min_elem_size { elem_serialization::is_size_static() ? elem_serialization::static_size() : 1u };
+			if constexpr (min_elem_size > 0u) {
+				if (count > ~size_t(0u) / min_elem_size || !ser.can_read(size_t(count) * min_elem_size)) {
+					return false;
+				}
+			}
+			return true;
+		}
+		
 		static void serialize(serializer& ser, storage_type& storage, const vector<data_type>& vec) {
 			const uint64_as_bytes size { .ui64 = vec.size() };
 			storage.insert(storage.end(), begin(size.bytes), end(size.bytes));
+			if constexpr (bulk_copy) {
+				// single copy of the whole contiguous range
+				if (vec.empty() || elem_serialization::has_bulk_layout(vec[0])) {
+					storage.insert(storage.end(), (const uint8_t*)vec.data(), (const uint8_t*)(vec.data() + vec.size()));
+					return;
+				}
+			}
 			for(const auto& elem : vec) {
 				serializer::serialization<data_type>::serialize(ser, storage, elem);
 			}
 		}
 		static vector<data_type> deserialize(serializer& ser, storage_type& storage) {
 			uint64_t size = 0;
-			memcpy(&size, storage.data(), sizeof(size));
-			storage.erase(storage.begin(), storage.begin() + sizeof(size));
+			if (!read_count(ser, size)) {
+				return {};
+			}
 			
 			vector<data_type> ret;
 			ret.resize(size);
-			for(uint64_t i = 0; i < size; ++i) {
+			if constexpr (bulk_copy) {
+				if (size > 0u && elem_serialization::has_bulk_layout(ret[0])) {
+					memcpy((void*)ret.data(), ser.read_ptr(), size * sizeof(data_type));
+					ser.consume(size * sizeof(data_type));
+					return ret;
+				}
+			}
+			for(uint64_t i = 0; i < size && !ser.read_overrun; ++i) {
 				ret[i] = serializer::serialization<data_type>::deserialize(ser, storage);
 			}
 			
@@ -360,12 +825,25 @@ protected:
 		}
 		static void deserialize_inplace(serializer& ser, storage_type& storage, vector<data_type>& val) {
 			uint64_t size = 0;
-			memcpy(&size, storage.data(), sizeof(size));
-			storage.erase(storage.begin(), storage.begin() + sizeof(size));
+			if (!read_count(ser, size)) {
+				return;
+			}
 			
 			val.resize(size);
-			for(uint64_t i = 0; i < size; ++i) {
-				serializer::serialization<data_type>::deserialize_inplace(ser, storage, val[i]);
+			if constexpr (bulk_copy) {
+				if (size > 0u && elem_serialization::has_bulk_layout(val[0])) {
+					memcpy((void*)val.data(), ser.read_ptr(), size * sizeof(data_type));
+					ser.consume(size * sizeof(data_type));
+					return;
+				}
+			}
+			for(uint64_t i = 0; i < size && !ser.read_overrun; ++i) {
+				if constexpr (is_same_v<data_type, bool>) {
+					// vector<bool> elements can't be referenced
+					val[i] = serializer::serialization<data_type>::deserialize(ser, storage);
+				} else {
+					serializer::serialization<data_type>::deserialize_inplace(ser, storage, val[i]);
+				}
 			}
 		}
 		static constexpr bool is_size_static() { return false; }
@@ -383,24 +861,55 @@ protected:
 				return sizeof(uint64_t) /* size */ + ret /* data */;
 			}
 		}
+		static constexpr bool is_bulk_copyable() { return false; }
 	};
 	
 	// array
 	template <typename data_type, size_t count>
 	struct serialization<array<data_type, count>> {
+		typedef serializer::serialization<data_type> elem_serialization;
+		//! see vector
+		static constexpr const bool bulk_copy { elem_serialization::is_bulk_copyable() };
+		
 		static void serialize(serializer& ser, storage_type& storage, const array<data_type, count>& arr) {
+			if constexpr (bulk_copy) {
+				if (count == 0u || has_bulk_layout(arr)) {
+					storage.insert(storage.end(), (const uint8_t*)arr.data(), (const uint8_t*)(arr.data() + count));
+					return;
+				}
+			}
 			for(const auto& elem : arr) {
 				serializer::serialization<data_type>::serialize(ser, storage, elem);
 			}
 		}
 		static array<data_type, count> deserialize(serializer& ser, storage_type& storage) {
 			array<data_type, count> ret;
+			if constexpr (bulk_copy) {
+				if (count == 0u || has_bulk_layout(ret)) {
+					if (!ser.can_read(count * sizeof(data_type))) {
+						return ret;
+					}
+					memcpy((void*)ret.data(), ser.read_ptr(), count * sizeof(data_type));
+					ser.consume(count * sizeof(data_type));
+					return ret;
+				}
+			}
 			for(uint32_t i = 0; i < count; ++i) {
 				ret[i] = serializer::serialization<data_type>::deserialize(ser, storage);
 			}
 			return ret;
 		}
 		static void deserialize_inplace(serializer& ser, storage_type& storage, array<data_type, count>& val) {
+			if constexpr (bulk_copy) {
+				if (count == 0u || has_bulk_layout(val)) {
+					if (!ser.can_read(count * sizeof(data_type))) {
+						return;
+					}
+					memcpy((void*)val.data(), ser.read_ptr(), count * sizeof(data_type));
+					ser.consume(count * sizeof(data_type));
+					return;
+				}
+			}
 			for(uint32_t i = 0; i < count; ++i) {
 				serializer::serialization<data_type>::deserialize_inplace(ser, storage, val[i]);
 			}
@@ -419,6 +928,15 @@ protected:
 				return ret;
 			}
 		}
+		static constexpr bool is_bulk_copyable() {
+			return (bulk_copy && sizeof(array<data_type, count>) == count * sizeof(data_type));
+		}
+		static bool has_bulk_layout(const array<data_type, count>& arr) {
+			if constexpr (count > 0u) {
+				return elem_serialization::has_bulk_layout(arr[0]);
+			}
+			return true;
+		}
 	};
 	
 	// serializable class
@@ -442,6 +960,9 @@ protected:
 				return obj.serialization_size();
 			}
 		}
+		static constexpr bool is_bulk_copyable() { return ser_class_type::is_serialization_bulk_copyable(); }
+		//! NOTE: the member order/offsets can only be checked on an actual object
+		static bool has_bulk_layout(const ser_class_type& obj) { return obj.is_serialization_layout_packed(); }
 	};
 	
 };
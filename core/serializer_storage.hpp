@@ -21,6 +21,11 @@
 
 #include <floor/core/cpp_headers.hpp>
 #include <floor/core/logger.hpp>
+#include <span>
+#include <cstring>
+#if !defined(_MSC_VER)
+#include <sys/uio.h>
+#endif
 
 //! this can be used as an alternate storage to vector<uint8_t> within the serializer,
 //! i.e. it is possible to have either read-only or write-only storage,
@@ -29,6 +34,9 @@ template <bool can_read, bool can_write>
 struct serializer_storage_wrapper {
 	static_assert(can_read || can_write, "quite pointless");
 	
+	//! read-only storage never moves its data -> deserialized views stay valid
+	static constexpr const bool is_zero_copy { !can_write };
+	
 	// const& if read-only, & if writable
 	typedef conditional_t<can_write, vector<uint8_t>&, const vector<uint8_t>&> backing_storage_type;
 	backing_storage_type backing_storage;
@@ -124,4 +132,200 @@ struct serializer_storage_wrapper {
 typedef serializer_storage_wrapper<true, false> read_only_serializer_storage;
 typedef serializer_storage_wrapper<false, true> write_only_serializer_storage;
 
+//! non-owning read-only storage over an existing range of bytes: consuming data only advances a read cursor,
+//! and string_view/span<const uint8_t> members are deserialized as views into the input (zero-copy)
+//! NOTE: the input data must outlive the serializer and all deserialized views
+struct serializer_read_cursor {
+	static constexpr const bool is_zero_copy { true };
+	
+	const uint8_t* begin_ptr { nullptr };
+	const uint8_t* end_ptr { nullptr };
+	
+	constexpr serializer_read_cursor() noexcept = default;
+	constexpr serializer_read_cursor(const uint8_t* begin_ptr_, const uint8_t* end_ptr_) noexcept :
+	begin_ptr(begin_ptr_), end_ptr(end_ptr_) {}
+	explicit serializer_read_cursor(const span<const uint8_t> data_) noexcept :
+	begin_ptr(data_.data()), end_ptr(data_.data() + data_.size()) {}
+	explicit serializer_read_cursor(const vector<uint8_t>& data_) noexcept :
+	begin_ptr(data_.data()), end_ptr(data_.data() + data_.size()) {}
+	
+	const uint8_t* data() const { return begin_ptr; }
+	const uint8_t* begin() const { return begin_ptr; }
+	const uint8_t* end() const { return end_ptr; }
+	
+	//! returns the amount of remaining (not yet consumed) bytes
+	size_t size() const { return size_t(end_ptr - begin_ptr); }
+	bool empty() const { return (begin_ptr == end_ptr); }
+	
+	//! "erases" (consumes) data from the start
+	const uint8_t* erase(const uint8_t* begin, const uint8_t* end) {
+		if (begin != begin_ptr || end < begin || end > end_ptr) {
+			log_error("invalid erase range (can only erase from the start and within bounds)");
+			return begin_ptr;
+		}
+		begin_ptr = end;
+		return begin_ptr;
+	}
+
+};
+
+//! non-owning write-only storage over caller-supplied memory (e.g. memory allocated from an arena):
+//! serialized data is written directly into the specified range, which must be large enough to hold all of it
+//! (-> use serializer<>::serialization_size(...) to determine the exact size up front)
+//! NOTE: writing past the end of the range fails (logs an error and sets the overflow flag), the range is never grown
+struct serializer_span_storage {
+	uint8_t* begin_ptr { nullptr };
+	uint8_t* end_ptr { nullptr };
+	uint8_t* capacity_end_ptr { nullptr };
+	bool overflow { false };
+	
+	constexpr serializer_span_storage() noexcept = default;
+	explicit serializer_span_storage(const span<uint8_t> memory_) noexcept :
+	begin_ptr(memory_.data()), end_ptr(memory_.data()), capacity_end_ptr(memory_.data() + memory_.size()) {}
+	
+	const uint8_t* data() const { return begin_ptr; }
+	const uint8_t* begin() const { return begin_ptr; }
+	const uint8_t* end() const { return end_ptr; }
+	
+	//! returns the amount of written bytes
+	size_t size() const { return size_t(end_ptr - begin_ptr); }
+	//! returns the total amount of bytes that can be written
+	size_t capacity() const { return size_t(capacity_end_ptr - begin_ptr); }
+	//! returns true if any write did not fit into the memory range
+	bool has_overflowed() const { return overflow; }
+	
+	//! returns the written data
+	span<const uint8_t> get_written() const { return { begin_ptr, size() }; }
+	
+	template <typename iterator_type> requires (!is_same_v<iterator_type, const uint8_t*>)
+	const uint8_t* insert(const uint8_t* insert_point, iterator_type begin, iterator_type end) {
+		return insert(insert_point, (const uint8_t*)&*begin, (const uint8_t*)&*end);
+	}
+	
+	const uint8_t* insert(const uint8_t* insert_point, const uint8_t* begin, const uint8_t* end) {
+		if (begin == end) return end_ptr;
+		if (insert_point != end_ptr || begin > end) {
+			log_error("invalid insert (can only insert at the end)");
+			return nullptr;
+		}
+		const auto size = size_t(end - begin);
+		if (size > size_t(capacity_end_ptr - end_ptr)) {
+			log_error("serializer span storage overflow: $ bytes don't fit into the remaining $ bytes",
+					  size, size_t(capacity_end_ptr - end_ptr));
+			overflow = true;
+			return nullptr;
+		}
+		const auto ret_ptr = end_ptr;
+		memcpy(end_ptr, begin, size);
+		end_ptr += size;
+		return ret_ptr;
+	}
+
+};
+
+//! write-only storage that produces a scatter/gather list instead of one contiguous buffer:
+//! inserted ranges of at least "reference_threshold" bytes (e.g. large strings, blobs and bulk copied containers)
+//! are referenced instead of copied, everything else is copied into a single internal buffer
+//! NOTE: referenced data points into the serialized objects, i.e. these must be kept alive and unmodified
+//!       for as long as the segments are in use (e.g. until the writev/gather send has finished)
+//! NOTE: the serializer itself inserts scalars, vectors, size prefixes and varints from temporary stack buffers,
+//!       which are all smaller than "min_reference_threshold" and are thus always copied -> only the contents of
+//!       strings, string_views, spans and bulk copied vectors/arrays can be referenced,
+//!       custom serialization specializations must not insert temporaries of min_reference_threshold bytes or more
+struct serializer_iovec_storage {
+	//! lower bound of the reference threshold: larger than any temporary that is inserted by the serializer
+	static constexpr const size_t min_reference_threshold { 256u };
+	
+	//! inserted ranges of at least this size are referenced instead of copied
+	//! NOTE: always >= min_reference_threshold
+	const size_t reference_threshold { 4096u };
+	
+	//! all copied data
+	vector<uint8_t> inline_data;
+	
+	//! single segment: either a range in "inline_data" (offset) or referenced external data (ptr)
+	struct segment {
+		const uint8_t* ptr { nullptr };
+		size_t offset { 0u };
+		size_t size { 0u };
+	};
+	vector<segment> segments;
+	//! total amount of bytes in all segments
+	size_t total_size { 0u };
+	
+	//! NOTE: "reference_threshold_" is clamped to min_reference_threshold,
+	//!       "inline_capacity" is the amount of bytes that are reserved for copied data up front
+	explicit serializer_iovec_storage(const size_t reference_threshold_ = 4096u, const size_t inline_capacity = 0u) :
+	reference_threshold(std::max(reference_threshold_, min_reference_threshold)) {
+		if (inline_capacity > 0u) {
+			inline_data.reserve(inline_capacity);
+		}
+	}
+	
+	//! only used as the insert point
+	const uint8_t* end() const { return nullptr; }
+	
+	//! returns the total amount of serialized bytes
+	size_t size() const { return total_size; }
+	
+	template <typename iterator_type> requires (!is_same_v<iterator_type, const uint8_t*>)
+	const uint8_t* insert(const uint8_t* insert_point, iterator_type begin, iterator_type end) {
+		return insert(insert_point, (const uint8_t*)&*begin, (const uint8_t*)&*end);
+	}
+	
+	const uint8_t* insert(const uint8_t*, const uint8_t* begin, const uint8_t* end) {
+		if (begin >= end) return nullptr;
+		const auto size = size_t(end - begin);
+		total_size += size;
+		if (size >= reference_threshold) {
+			segments.emplace_back(segment { .ptr = begin, .size = size });
+			return begin;
+		}
+		// copy, extending the previous segment if it is an inline one as well
+		const auto offset = inline_data.size();
+		inline_data.insert(inline_data.end(), begin, end);
+		if (!segments.empty() && segments.back().ptr == nullptr) {
+			segments.back().size += size;
+		} else {
+			segments.emplace_back(segment { .offset = offset, .size = size });
+		}
+		return inline_data.data() + offset;
+	}
+	
+	//! returns all segments in order
+	//! NOTE: these are invalidated by any further serialization into this storage
+	vector<span<const uint8_t>> get_segments() const {
+		vector<span<const uint8_t>> ret;
+		ret.reserve(segments.size());
+		for (const auto& seg : segments) {
+			ret.emplace_back(seg.ptr != nullptr ? seg.ptr : inline_data.data() + seg.offset, seg.size);
+		}
+		return ret;
+	}
+
+#if !defined(_MSC_VER)
+	//! returns all segments as an iovec list that can directly be used with writev/sendmsg
+	//! NOTE: these are invalidated by any further serialization into this storage
+	vector<iovec> get_iovecs() const {
+		vector<iovec> ret;
+		ret.reserve(segments.size());
+		for (const auto& seg : segments) {
+			ret.emplace_back(iovec {
+				const_cast<uint8_t*>(seg.ptr != nullptr ? seg.ptr : inline_data.data() + seg.offset),
+				seg.size
+			});
+		}
+		return ret;
+	}
+#endif
+
+	//! clears all segments and copied data (keeps the allocated memory for reuse)
+	void clear() {
+		inline_data.clear();
+		segments.clear();
+		total_size = 0u;
+	}
+
+};
+
 #endif
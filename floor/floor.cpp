@@ -346,6 +346,11 @@ bool floor::init(const init_state& state) {
 		config.log_use_color = config_doc.get<bool>("logging.use_color", true);
 		config.log_filename = config_doc.get<string>("logging.log_filename", "");
 		config.msg_filename = config_doc.get<string>("logging.msg_filename", "");
+		config.log_binary = config_doc.get<bool>("logging.binary", false);
+		config.log_rotation_max_size = config_doc.get<uint64_t>("logging.rotation.max_size", 0);
+		config.log_rotation_max_age = config_doc.get<uint64_t>("logging.rotation.max_age", 0);
+		config.log_rotation_max_segments = config_doc.get<uint32_t>("logging.rotation.max_segments", 0);
+		config.log_rotation_compress = config_doc.get<bool>("logging.rotation.compress", false);
 		
 		config.fov = config_doc.get<float>("projection.fov", 72.0f);
 		config.near_far_plane.x = config_doc.get<float>("projection.near", 1.0f);
@@ -650,9 +655,16 @@ bool floor::init(const init_state& state) {
 	}
 	
 	// init logger and print out floor info
+	logger::set_rotation({
+		.max_file_size = config.log_rotation_max_size,
+		.max_age = chrono::seconds(config.log_rotation_max_age),
+		.max_segments = config.log_rotation_max_segments,
+		.compress = config.log_rotation_compress,
+	});
 	logger::init((uint32_t)config.verbosity, config.separate_msg_file, config.append_mode,
 				 config.log_use_time, config.log_use_color,
 				 config.log_filename, config.msg_filename);
+	logger::set_binary_logging(config.log_binary);
 	log_debug("$", (FLOOR_VERSION_STRING).c_str());
 	
 	// choose the renderer
@@ -1320,8 +1332,8 @@ void floor::set_fullscreen(const bool& state) {
 				  (state ? "enable" : "disable"), SDL_GetError());
 	}
 	evt->add_event(EVENT_TYPE::WINDOW_RESIZE,
-				   make_shared<window_resize_event>(SDL_GetTicks(),
-													uint2(config.width, config.height)));
+				   make_event<window_resize_event>(SDL_GetTicks(),
+												   uint2(config.width, config.height)));
 	// TODO: border?
 }
 
@@ -1657,7 +1669,7 @@ void floor::set_fov(const float& fov) {
 	if(const_math::is_equal(config.fov, fov)) return;
 	config.fov = fov;
 	evt->add_event(EVENT_TYPE::WINDOW_RESIZE,
-				   make_shared<window_resize_event>(SDL_GetTicks(), uint2(config.width, config.height)));
+				   make_event<window_resize_event>(SDL_GetTicks(), uint2(config.width, config.height)));
 }
 
 const float2& floor::get_near_far_plane() {
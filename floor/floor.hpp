@@ -364,6 +364,12 @@ protected:
 		bool log_use_color = true;
 		string log_filename;
 		string msg_filename;
+		bool log_binary = false;
+		//! log file rotation: max file size in bytes, max age in seconds, max retained segments, segment compression
+		uint64_t log_rotation_max_size = 0;
+		uint64_t log_rotation_max_age = 0;
+		uint32_t log_rotation_max_segments = 0;
+		bool log_rotation_compress = false;
 		
 		// projection
 		float fov = 72.0f;
@@ -62,6 +62,9 @@
 // if defined, this disables network support
 //#define FLOOR_NO_NET 1
 
+// if defined, this enables lock contention statistics (see atomic_spin_lock::enable_stats)
+//#define FLOOR_LOCK_STATS 1
+
 // if defined, this will use extern templates for specific template classes (vector*, matrix, etc.)
 // and instantiate them for various basic types (float, int, ...)
 // NOTE: don't enable this for compute (these won't compile the necessary .cpp files)
@@ -93,6 +93,8 @@ protected:
 };
 
 template <class protocol_policy, class reception_policy> net<protocol_policy, reception_policy>::net() : thread_base("net"), protocol() {
+	// sending is triggered immediately through notify(), received data is checked for at least every thread delay ms
+	this->set_event_driven(true);
 	this->start(); // start thread
 }
 
@@ -115,6 +117,7 @@ bool net<protocol_policy, reception_policy>::connect_to_server(const string& ser
 	
 	unlock();
 	if(!connected) set_thread_should_finish(); // quit on failure
+	else notify(); // start receiving/sending right away
 	return true;
 }
 
@@ -134,6 +137,7 @@ bool net<protocol_policy, reception_policy>::listen_as_server(const string& serv
 	
 	unlock();
 	if(!connected) set_thread_should_finish(); // quit on failure
+	else notify(); // start receiving/sending right away
 	return connected;
 }
 
@@ -252,24 +256,28 @@ template <class protocol_policy, class reception_policy> void net<protocol_polic
 	this->lock();
 	send_store.insert(end(send_store), cbegin(packets_data), cend(packets_data));
 	this->unlock();
+	this->notify();
 }
 
 template <class protocol_policy, class reception_policy> void net<protocol_policy, reception_policy>::send_data(const vector<char>& packet_data) {
 	this->lock();
 	send_store.emplace_back(cbegin(packet_data), cend(packet_data));
 	this->unlock();
+	this->notify();
 }
 
 template <class protocol_policy, class reception_policy> void net<protocol_policy, reception_policy>::send_data(const string& packet_data) {
 	this->lock();
 	send_store.emplace_back(cbegin(packet_data), cend(packet_data));
 	this->unlock();
+	this->notify();
 }
 
 template <class protocol_policy, class reception_policy> void net<protocol_policy, reception_policy>::send_data(const char* packet_data, const size_t length) {
 	this->lock();
 	send_store.emplace_back(packet_data, packet_data + length);
 	this->unlock();
+	this->notify();
 }
 
 template <class protocol_policy, class reception_policy> asio::ip::address net<protocol_policy, reception_policy>::get_local_address() const {
@@ -26,6 +26,7 @@
 #include <floor/net/net_protocol.hpp>
 #include <floor/net/asio_error_handler.hpp>
 #include <floor/core/platform.hpp>
+#include <span>
 
 // non-ssl and ssl specific implementation
 namespace floor_net {
@@ -273,28 +274,21 @@ public:
 	bool send(const char* send_data, const size_t len) {
 		asio::error_code ec;
 		const auto data_sent = asio::write(data.socket, asio::buffer(send_data, len), ec);
-		if(ec == asio::error::eof) {
-			valid = false;
-			closed = true;
-			return false;
-		}
-		if(ec) {
-			log_error("error while sending data (sent $): $", data_sent, ec.message());
-			valid = false;
-			return false;
-		}
-		if(asio_error_handler::is_error()) {
-			log_error("error while sending data (sent $): $", data_sent, asio_error_handler::handle_all());
-			valid = false;
-			return false;
-		}
-		if(data_sent != (size_t)len) {
-			log_error("error while sending data: sent data length ($) != requested data length ($)!",
-					  data_sent, len);
-			valid = false;
-			return false;
+		return handle_send_result(ec, data_sent, len);
+	}
+	
+	//! gather send: sends all "buffers" in order (with as few write calls as possible)
+	bool send(const vector<span<const uint8_t>>& buffers) {
+		vector<asio::const_buffer> asio_buffers;
+		asio_buffers.reserve(buffers.size());
+		size_t len = 0;
+		for(const auto& buffer : buffers) {
+			asio_buffers.emplace_back(asio::buffer(buffer.data(), buffer.size()));
+			len += buffer.size();
 		}
-		return true;
+		asio::error_code ec;
+		const auto data_sent = asio::write(data.socket, asio_buffers, ec);
+		return handle_send_result(ec, data_sent, len);
 	}
 	
 	asio::ip::address get_local_address() const {
@@ -336,6 +330,32 @@ protected:
 	
 	floor_net::protocol_details<use_ssl> data;
 	
+	//! checks the result of a send/write call, returns true if all "len" bytes were sent
+	bool handle_send_result(const asio::error_code& ec, const size_t data_sent, const size_t len) {
+		if(ec == asio::error::eof) {
+			valid = false;
+			closed = true;
+			return false;
+		}
+		if(ec) {
+			log_error("error while sending data (sent $): $", data_sent, ec.message());
+			valid = false;
+			return false;
+		}
+		if(asio_error_handler::is_error()) {
+			log_error("error while sending data (sent $): $", data_sent, asio_error_handler::handle_all());
+			valid = false;
+			return false;
+		}
+		if(data_sent != (size_t)len) {
+			log_error("error while sending data: sent data length ($) != requested data length ($)!",
+					  data_sent, len);
+			valid = false;
+			return false;
+		}
+		return true;
+	}
+
 };
 
 typedef std_protocol<tcp::socket, false> TCP_protocol;
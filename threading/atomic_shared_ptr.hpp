@@ -19,38 +19,136 @@
 #ifndef __FLOOR_ATOMIC_SHARED_PTR_HPP__
 #define __FLOOR_ATOMIC_SHARED_PTR_HPP__
 
-#include <floor/threading/atomic_spin_lock.hpp>
-#include <floor/threading/thread_safety.hpp>
 #include <floor/core/essentials.hpp>
+#include <atomic>
+#include <memory>
+#include <cstdint>
+#include <stdexcept>
+using namespace std;
 
 // interface partially based on std shared_ptr and N4162/N4260 proposals, with additional functionality:
 //  * this is a completely thread-safe shared_ptr, not just a wrapper around atomic_* functions like N4162/N4260
-//  * locked/thread-safe function calls / access via get/*/->
+//  * thread-safe access via get/*/-> (pinning the current object for the lifetime of the returned proxy)
 // ref shared_ptr: https://github.com/cplusplus/draft/blob/master/source/utilities.tex#L5568
 // ref thread-safety of shared_ptr: http://www.boost.org/doc/libs/1_53_0/libs/smart_ptr/shared_ptr.htm#ThreadSafety
 // ref atomic_shared_ptr: http://isocpp.org/files/papers/N4162.pdf
 //                        http://isocpp.org/files/papers/N4260.pdf
+//
+// implementation: lock-free, using split reference counting:
+// the stored shared_ptr is kept inside a "node", the atomic 64-bit state contains the compressed node pointer and an
+// "external" count of in-flight readers, while the node contains the "internal" count of released readers.
+//  * readers (load/get/...) increment the external count (single fetch_add), copy the shared_ptr of the node and then
+//    decrement the internal count (single fetch_sub) -> load() is wait-free
+//  * writers (store/exchange/...) swap in a new node and transfer the external count of the old node to its internal
+//    count, the node is destroyed once all readers are done with it
+//  * while a node is installed, its internal count contains an additional large bias, so that it can never drop to 0
+//  * to prevent the external count from overflowing, readers that observe a large external count try once to transfer
+//    it to the internal count (this is not required for correctness, as long as less than 2^22 readers are in-flight)
 template <class T> class atomic_shared_ptr {
 protected:
-	shared_ptr<T> ptr GUARDED_BY(mtx);
-	mutable atomic_spin_lock mtx;
+	struct alignas(64) node {
+		shared_ptr<T> value;
+		//! internal count (see above)
+		atomic<int64_t> internal_count;
+		
+		explicit node(shared_ptr<T>&& value_) noexcept : value(std::move(value_)), internal_count(installed_bias) {}
+	};
+	
+	static_assert(sizeof(void*) == 8, "atomic_shared_ptr requires 64-bit pointers");
+	//! nodes are 64-byte aligned, user-space pointers use at most 48 bits
+	//! -> the compressed node pointer uses 42 bits, leaving 22 bits for the external count
+	//! NOTE: this is verified for every allocated node (see make_node()), as it doesn't hold for 57-bit address spaces
+	//!       (5-level paging with high mmap hints) or tagged pointers (e.g. ARM TBI/MTE heap tagging)
+	static constexpr const uint32_t node_align_shift { 6u };
+	static constexpr const uint32_t count_shift { 42u };
+	static constexpr const uint64_t ptr_mask { (1ull << count_shift) - 1ull };
+	static constexpr const uint64_t count_one { 1ull << count_shift };
+	static constexpr const uint64_t count_rebase_threshold { 1ull << 21u };
+	static constexpr const int64_t installed_bias { 1ll << 62 };
+	
+	mutable atomic<uint64_t> state { 0u };
+	
+	static floor_inline_always node* state_node(const uint64_t state_val) noexcept {
+		return (node*)((state_val & ptr_mask) << node_align_shift);
+	}
+	static floor_inline_always uint64_t state_count(const uint64_t state_val) noexcept {
+		return (state_val >> count_shift);
+	}
+	static floor_inline_always uint64_t make_state(node* nd) noexcept {
+		return (uint64_t(uintptr_t(nd)) >> node_align_shift);
+	}
+	
+	//! creates a new node for "sptr" (or nullptr if "sptr" is empty)
+	static node* make_node(shared_ptr<T>&& sptr) {
+		if (!sptr && sptr.use_count() == 0) {
+			return nullptr;
+		}
+		auto nd = new node(std::move(sptr));
+		// the node pointer must be representable in the compressed form, otherwise state_node() would be wrong
+		if ((uintptr_t(nd) >> (count_shift + node_align_shift)) != 0u) {
+			delete nd;
+			throw runtime_error("atomic_shared_ptr node address exceeds the supported 48-bit address range");
+		}
+		return nd;
+	}
+	
+	//! adds "delta" to the internal count of "nd", destroying it if this drops to 0
+	static floor_inline_always void update_internal_count(node* nd, const int64_t delta) noexcept {
+		if (nd->internal_count.fetch_add(delta, memory_order_acq_rel) + delta == 0) {
+			delete nd;
+		}
+	}
+	
+	//! acquires a reference to the currently installed node (wait-free), returns the observed state
+	uint64_t acquire() const noexcept {
+		const auto cur_state = state.fetch_add(count_one, memory_order_acquire) + count_one;
+		auto nd = state_node(cur_state);
+		const auto count = state_count(cur_state);
+		if (nd != nullptr && count >= count_rebase_threshold) {
+			// try to transfer the external count to the internal count (credit first, undo on failure)
+			nd->internal_count.fetch_add(int64_t(count), memory_order_acq_rel);
+			auto expected = cur_state;
+			if (!state.compare_exchange_strong(expected, make_state(nd), memory_order_acq_rel, memory_order_relaxed)) {
+				// NOTE: can't drop to 0, since we're still holding a reference
+				nd->internal_count.fetch_sub(int64_t(count), memory_order_acq_rel);
+			}
+		} else if (nd == nullptr && count >= count_rebase_threshold) {
+			auto expected = cur_state;
+			state.compare_exchange_strong(expected, 0u, memory_order_acq_rel, memory_order_relaxed);
+		}
+		return cur_state;
+	}
+	
+	//! releases a reference that has been acquired via acquire()
+	static floor_inline_always void release(const uint64_t acquired_state) noexcept {
+		if (auto nd = state_node(acquired_state); nd != nullptr) {
+			update_internal_count(nd, -1);
+		}
+	}
+	
+	//! retires a node that has been swapped out of "state" with the specified state value
+	static floor_inline_always void retire(const uint64_t old_state) noexcept {
+		if (auto nd = state_node(old_state); nd != nullptr) {
+			update_internal_count(nd, int64_t(state_count(old_state)) - installed_bias);
+		}
+	}
+	
+	//! returns true if both shared_ptrs share the same control block (are the same)
+	template <typename U, typename V>
+	static floor_inline_always bool is_same_owner(const shared_ptr<U>& a, const shared_ptr<V>& b) noexcept {
+		return (!a.owner_before(b) && !b.owner_before(a));
+	}
 	
 public:
-	// aka locking proxy
+	//! proxy object that keeps the object it was created for alive (even if the atomic_shared_ptr is modified)
 	template <typename U>
-	class locked_ptr {
+	class pinned_ptr {
 	protected:
-		atomic_spin_lock& mtx_ref;
-		shared_ptr<U>& ptr;
+		shared_ptr<U> ptr;
 		
 	public:
-		explicit locked_ptr(atomic_spin_lock& mtx_, shared_ptr<U>& ptr_) noexcept : mtx_ref(mtx_), ptr(ptr_) {
-			mtx_ref.lock();
-		}
-		~locked_ptr() {
-			mtx_ref.unlock();
-		}
-		locked_ptr& operator=(const locked_ptr&) = delete;
+		explicit pinned_ptr(shared_ptr<U>&& ptr_) noexcept : ptr(std::move(ptr_)) {}
+		pinned_ptr& operator=(const pinned_ptr&) = delete;
 		floor_inline_always U* get() const noexcept {
 			return ptr.get();
 		}
@@ -65,116 +163,133 @@ public:
 	// constructors:
 	constexpr atomic_shared_ptr() noexcept = default;
 	constexpr atomic_shared_ptr(nullptr_t) noexcept {}
-	constexpr atomic_shared_ptr(shared_ptr<T> sptr) noexcept : ptr(sptr) {}
+	atomic_shared_ptr(shared_ptr<T> sptr) : state(make_state(make_node(std::move(sptr)))) {}
 	atomic_shared_ptr(const atomic_shared_ptr&) = delete;
 	
 	// destructor:
 	~atomic_shared_ptr() {
-		mtx.lock();
-		// note: shared_ptr is cleaned up / destructed automatically
-		ptr.reset();
-		mtx.unlock();
+		// NOTE: there must not be any concurrent accesses at this point
+		retire(state.exchange(0u));
 	}
 	
 	// assignment:
 	floor_inline_always atomic_shared_ptr& operator=(shared_ptr<T> sptr) {
-		safe_guard<atomic_spin_lock> guard(mtx);
-		ptr.swap(sptr);
+		store(std::move(sptr));
 		return *this;
 	}
 	atomic_shared_ptr& operator=(const atomic_shared_ptr&) = delete;
 	
-	floor_inline_always void store(shared_ptr<T> sptr) noexcept {
-		safe_guard<atomic_spin_lock> guard(mtx);
-		ptr.swap(sptr);
+	floor_inline_always void store(shared_ptr<T> sptr) {
+		retire(state.exchange(make_state(make_node(std::move(sptr))), memory_order_acq_rel));
 	}
 	
-	floor_inline_always shared_ptr<T> exchange(shared_ptr<T> sptr) noexcept {
-		safe_guard<atomic_spin_lock> guard(mtx);
-		ptr.swap(sptr);
-		return sptr;
+	floor_inline_always shared_ptr<T> exchange(shared_ptr<T> sptr) {
+		const auto old_state = state.exchange(make_state(make_node(std::move(sptr))), memory_order_acq_rel);
+		shared_ptr<T> ret;
+		if (auto nd = state_node(old_state); nd != nullptr) {
+			// we still own the installed bias of the old node at this point -> safe to copy
+			ret = nd->value;
+		}
+		retire(old_state);
+		return ret;
 	}
 	
-	floor_inline_always bool compare_exchange_strong(shared_ptr<T>& expected, const shared_ptr<T>& desired) noexcept {
-		safe_guard<atomic_spin_lock> guard(mtx);
-		// check if ptr and expected share the same control block (are the same)
-		if(!ptr.owner_before(expected) && !expected.owner_before(ptr)) {
-			ptr = desired;
-			return true;
-		}
-		expected = ptr;
-		return false;
-	}
-	floor_inline_always bool compare_exchange_strong(shared_ptr<T>& expected, shared_ptr<T>&& desired) noexcept {
-		safe_guard<atomic_spin_lock> guard(mtx);
-		// check if ptr and expected share the same control block (are the same)
-		if(!ptr.owner_before(expected) && !expected.owner_before(ptr)) {
-			ptr = desired;
-			return true;
+	bool compare_exchange_strong(shared_ptr<T>& expected, shared_ptr<T> desired) {
+		auto cur_state = acquire();
+		for (;;) {
+			auto nd = state_node(cur_state);
+			const bool is_expected = (nd != nullptr ? is_same_owner(nd->value, expected) : (!expected && expected.use_count() == 0));
+			if (!is_expected) {
+				expected = (nd != nullptr ? nd->value : shared_ptr<T> {});
+				release(cur_state);
+				return false;
+			}
+			
+			// try to install the new node, retry as long as only the external count of the same node has changed
+			auto new_nd = make_node(std::move(desired));
+			auto observed_state = state.load(memory_order_acquire);
+			while (state_node(observed_state) == nd) {
+				if (state.compare_exchange_weak(observed_state, make_state(new_nd), memory_order_acq_rel, memory_order_acquire)) {
+					retire(observed_state);
+					release(cur_state);
+					return true;
+				}
+			}
+			
+			// node has been replaced in the mean time -> recheck with the new node
+			if (new_nd != nullptr) {
+				desired = std::move(new_nd->value);
+				delete new_nd;
+			}
+			release(cur_state);
+			cur_state = acquire();
 		}
-		expected = ptr;
-		return false;
 	}
-	floor_inline_always bool compare_exchange_weak(shared_ptr<T>& expected, const shared_ptr<T>& desired) noexcept {
-		return compare_exchange_strong(expected, desired);
-	}
-	floor_inline_always bool compare_exchange_weak(shared_ptr<T>& expected, shared_ptr<T>&& desired) noexcept {
-		return compare_exchange_strong(expected, forward(desired));
+	floor_inline_always bool compare_exchange_weak(shared_ptr<T>& expected, shared_ptr<T> desired) {
+		return compare_exchange_strong(expected, std::move(desired));
 	}
 	
 	// modifiers:
 	floor_inline_always void reset() noexcept {
-		safe_guard<atomic_spin_lock> guard(mtx);
-		ptr.reset();
+		retire(state.exchange(0u, memory_order_acq_rel));
 	}
 	template<class Y> floor_inline_always void reset(Y* p) {
-		safe_guard<atomic_spin_lock> guard(mtx);
-		ptr.reset(p);
+		store(shared_ptr<T>(p));
 	}
 	template<class Y, class D> floor_inline_always void reset(Y* p, D d) {
-		safe_guard<atomic_spin_lock> guard(mtx);
-		ptr.reset(p, d);
+		store(shared_ptr<T>(p, d));
 	}
 	template<class Y, class D, class A> floor_inline_always void reset(Y* p, D d, A a) {
-		safe_guard<atomic_spin_lock> guard(mtx);
-		ptr.reset(p, d, a);
+		store(shared_ptr<T>(p, d, a));
 	}
 	
 	// observers:
-	floor_inline_always locked_ptr<T> get() const noexcept {
-		return locked_ptr<T> { mtx, ptr };
+	floor_inline_always pinned_ptr<T> get() const noexcept {
+		return pinned_ptr<T> { load() };
 	}
+	//! NOTE: the returned pointer is only valid as long as the object isn't replaced
 	floor_inline_always T* unsafe_get() const noexcept {
-		return ptr.get();
+		const auto cur_state = acquire();
+		auto nd = state_node(cur_state);
+		auto ret = (nd != nullptr ? nd->value.get() : nullptr);
+		release(cur_state);
+		return ret;
 	}
-	floor_inline_always locked_ptr<T> operator*() const noexcept {
-		return locked_ptr<T> { mtx, ptr };
+	floor_inline_always pinned_ptr<T> operator*() const noexcept {
+		return pinned_ptr<T> { load() };
 	}
-	floor_inline_always locked_ptr<T> operator->() const noexcept {
-		return locked_ptr<T> { mtx, ptr };
+	floor_inline_always pinned_ptr<T> operator->() const noexcept {
+		return pinned_ptr<T> { load() };
 	}
+	//! returns the amount of shared_ptrs that own the stored object or 0 if it is empty (null)
+	//! NOTE: this is only approximate if other threads concurrently modify/copy this or other owners
 	floor_inline_always long use_count() const noexcept {
-		safe_guard<atomic_spin_lock> guard(mtx);
-		return ptr.use_count();
+		const auto sptr = load();
+		if (!sptr) {
+			return 0;
+		}
+		// NOTE: this does not include the copy that is made here
+		return sptr.use_count() - 1;
 	}
 	floor_inline_always bool unique() const noexcept {
-		safe_guard<atomic_spin_lock> guard(mtx);
-		return ptr.unique();
+		return (use_count() == 1);
 	}
 	floor_inline_always explicit operator bool() const noexcept {
-		safe_guard<atomic_spin_lock> guard(mtx);
-		return ptr();
+		return (unsafe_get() != nullptr);
 	}
 	template<class U> floor_inline_always bool owner_before(shared_ptr<U> const& b) const {
-		safe_guard<atomic_spin_lock> guard(mtx);
-		return ptr.owner_before(b);
+		return load().owner_before(b);
 	}
 	
-	constexpr bool is_lock_free() const noexcept { return false; }
+	constexpr bool is_lock_free() const noexcept { return true; }
 	
 	floor_inline_always shared_ptr<T> load() const noexcept {
-		safe_guard<atomic_spin_lock> guard(mtx);
-		shared_ptr<T> ret = ptr;
+		const auto cur_state = acquire();
+		shared_ptr<T> ret;
+		if (auto nd = state_node(cur_state); nd != nullptr) {
+			ret = nd->value;
+		}
+		release(cur_state);
 		return ret;
 	}
 	
@@ -0,0 +1,126 @@
+/*
+ *  Flo's Open libRary (floor)
+ *  Copyright (C) 2004 - 2022 Florian Ziesche
+ *  
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; version 2 of the License only.
+ *  
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <floor/threading/atomic_spin_lock.hpp>
+#include <floor/core/logger.hpp>
+#include <vector>
+#include <mutex>
+
+#if defined(FLOOR_LOCK_STATS)
+//! all lock statistics that have been enabled so far
+static mutex lock_stats_registry_lock;
+static vector<shared_ptr<atomic_spin_lock::lock_stats>> lock_stats_registry;
+#endif
+
+static floor_inline_always void cpu_pause() {
+	// AMD recommendation: "pause" when lock could not be acquired (b/c SMT)
+#if defined(__x86_64__)
+	asm volatile("pause" : : : "memory");
+#elif defined(__aarch64__)
+	asm volatile("yield" : : : "memory");
+#else
+#error "unknown arch"
+#endif
+}
+
+void atomic_spin_lock::lock_contended() {
+	// spin phase: Malte recommendation: to improve latency, only try this 16 times ...
+	static constexpr const uint32_t max_spin_count { 16u };
+	uint64_t spins = 0u, parks = 0u;
+	const auto try_acquire = [this] {
+		uint32_t expected = 0u;
+		return (mtx.load(memory_order_relaxed) == 0u &&
+				mtx.compare_exchange_strong(expected, 1u, memory_order_acquire, memory_order_relaxed));
+	};
+	
+	bool acquired = false;
+	for (uint32_t trial = 0; trial < max_spin_count; ++trial) {
+		cpu_pause();
+		++spins;
+		if (try_acquire()) {
+			acquired = true;
+			break;
+		}
+	}
+	
+	if (!acquired) {
+		if (mode == MODE::SPIN) {
+			// ... and after the 16th attempt: actually yield the thread (then start again)
+#pragma nounroll
+			for (uint32_t trial = 0; !try_acquire(); ++trial, ++spins) {
+				if (trial < max_spin_count) {
+					cpu_pause();
+				} else {
+					this_thread::yield();
+					trial = 0;
+				}
+			}
+		} else {
+			// ... or park the thread: mark the lock as contended and sleep until it is released,
+			// if the lock was released in the mean time, we now own it (in the contended state)
+			while (mtx.exchange(2u, memory_order_acquire) != 0u) {
+				++parks;
+				mtx.wait(2u, memory_order_relaxed);
+			}
+		}
+	}
+	
+#if defined(FLOOR_LOCK_STATS)
+	if (stats) {
+		++stats->acquisitions;
+		++stats->contended;
+		stats->spins += spins;
+		stats->parks += parks;
+	}
+#else
+	(void)spins;
+	(void)parks;
+#endif
+}
+
+void atomic_spin_lock::enable_stats(const string& name) {
+#if defined(FLOOR_LOCK_STATS)
+	if (stats) {
+		stats->name = name;
+		return;
+	}
+	stats = make_shared<lock_stats>();
+	stats->name = name;
+	
+	lock_guard<mutex> guard(lock_stats_registry_lock);
+	lock_stats_registry.emplace_back(stats);
+#else
+	(void)name;
+#endif
+}
+
+void atomic_spin_lock::dump_stats() {
+#if defined(FLOOR_LOCK_STATS)
+	lock_guard<mutex> guard(lock_stats_registry_lock);
+	for (const auto& lock_stat : lock_stats_registry) {
+		const uint64_t acquisitions = lock_stat->acquisitions;
+		const uint64_t contended = lock_stat->contended;
+		log_msg("lock \"$\": $ acquisitions, $ contended ($%), $ spins, $ parks",
+				lock_stat->name, acquisitions, contended,
+				(acquisitions > 0u ? double(contended) * 100.0 / double(acquisitions) : 0.0),
+				uint64_t(lock_stat->spins), uint64_t(lock_stat->parks));
+	}
+#else
+	log_msg("lock statistics are disabled (build with FLOOR_LOCK_STATS)");
+#endif
+}
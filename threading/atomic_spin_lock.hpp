@@ -21,6 +21,8 @@
 
 #include <atomic>
 #include <thread>
+#include <string>
+#include <memory>
 #include <floor/threading/thread_safety.hpp>
 #include <floor/core/essentials.hpp>
 using namespace std;
@@ -29,57 +31,123 @@ using namespace std;
 // https://probablydance.com/2019/12/30/measuring-mutexes-spinlocks-and-how-bad-the-linux-scheduler-really-is/
 // https://gpuopen.com/gdc-presentations/2019/gdc-2019-s2-amd-ryzen-processor-software-optimization.pdf
 // https://github.com/skarupke/mutex_benchmarks/blob/master/BenchmarkMutex.cpp
+// adaptive mode: spins briefly, then parks the thread on the lock state (C++20 atomic wait -> futex on Linux),
+// lock state: 0 = unlocked, 1 = locked, 2 = locked and there may be parked threads (-> unlock must wake one up)
 class CAPABILITY("mutex") atomic_spin_lock {
 public:
+	//! lock waiting behavior
+	enum class MODE : uint32_t {
+		//! spin briefly, then park the thread until the lock is released (default)
+		ADAPTIVE,
+		//! spin and periodically yield the thread (never parks)
+		SPIN,
+	};
+	
+	//! contention statistics of a single lock (only collected if built with FLOOR_LOCK_STATS and enabled via enable_stats())
+	struct lock_stats {
+		string name;
+		//! total amount of lock acquisitions
+		atomic<uint64_t> acquisitions { 0u };
+		//! amount of acquisitions that could not immediately acquire the lock
+		atomic<uint64_t> contended { 0u };
+		//! total amount of spin iterations
+		atomic<uint64_t> spins { 0u };
+		//! amount of times a thread was parked
+		atomic<uint64_t> parks { 0u };
+	};
+	
 	constexpr floor_inline_always atomic_spin_lock() noexcept = default;
+	constexpr floor_inline_always explicit atomic_spin_lock(const MODE mode_) noexcept : mode(mode_) {}
 
-	floor_inline_always atomic_spin_lock(atomic_spin_lock&& spin_lock) noexcept {
+	floor_inline_always atomic_spin_lock(atomic_spin_lock&& spin_lock) noexcept : mode(spin_lock.mode)
+#if defined(FLOOR_LOCK_STATS)
+	, stats(std::move(spin_lock.stats))
+#endif
+	{
 		mtx = spin_lock.mtx.load();
-		spin_lock.mtx = false;
+		spin_lock.mtx = 0u;
 	}
 	
 	floor_inline_always atomic_spin_lock& operator=(atomic_spin_lock&& spin_lock) noexcept {
 		mtx = spin_lock.mtx.load();
-		spin_lock.mtx = false;
+		spin_lock.mtx = 0u;
+		mode = spin_lock.mode;
+#if defined(FLOOR_LOCK_STATS)
+		stats = std::move(spin_lock.stats);
+#endif
 		return *this;
 	}
 
 	floor_inline_always void lock() ACQUIRE() {
-#pragma nounroll
-		for (uint32_t trial = 0; !try_lock(); ++trial) {
-			if (trial < 16) {
-				// AMD recommendation: "pause" when lock could not be acquired (b/c SMT)
-				// Malte recommendation: to improve latency, only try this 16 times ...
-#if defined(__x86_64__)
-				asm volatile("pause" : : : "memory");
-#elif defined(__aarch64__)
-				asm volatile("yield" : : : "memory");
-#else
-#error "unknown arch"
-#endif
-			} else {
-				// ... and after the 16th attempt: actually yield the thread (then start again)
-				this_thread::yield();
-				trial = 0;
-			}
+		uint32_t expected = 0u;
+		if (!mtx.compare_exchange_strong(expected, 1u, memory_order_acquire, memory_order_relaxed)) {
+			lock_contended();
+		}
+#if defined(FLOOR_LOCK_STATS)
+		else if (stats) {
+			++stats->acquisitions;
 		}
+#endif
 	}
 	floor_inline_always bool try_lock() TRY_ACQUIRE(true) {
 		// AMD recommendation to prevent unnecessary cache line invalidation (due to write):
 		// load/read first (and fail if lock is taken), only then try to exchange/write memory
 		// when we know that the lock is potentially not taken right now
-		return (!mtx.load(memory_order_relaxed) && !mtx.exchange(true, memory_order_acquire));
+		uint32_t expected = 0u;
+#if defined(FLOOR_LOCK_STATS)
+		if (mtx.load(memory_order_relaxed) == 0u &&
+			mtx.compare_exchange_strong(expected, 1u, memory_order_acquire, memory_order_relaxed)) {
+			if (stats) {
+				++stats->acquisitions;
+			}
+			return true;
+		}
+		return false;
+#else
+		return (mtx.load(memory_order_relaxed) == 0u &&
+				mtx.compare_exchange_strong(expected, 1u, memory_order_acquire, memory_order_relaxed));
+#endif
 	}
 	floor_inline_always void unlock() RELEASE() {
-		// resets flag to false
-		mtx.store(false, memory_order_release);
+		// resets state to unlocked, wakes up a parked thread if there may be any
+		if (mtx.exchange(0u, memory_order_release) == 2u) {
+			mtx.notify_one();
+		}
 	}
 	
 	// for negative capabilities
 	floor_inline_always const atomic_spin_lock& operator!() const { return *this; }
 	
+	//! sets the waiting behavior of this lock
+	//! NOTE: must not be called while the lock is in use
+	void set_mode(const MODE mode_) {
+		mode = mode_;
+	}
+	
+	//! enables contention statistics for this lock, identified by "name" (registered globally, see dump_stats())
+	//! NOTE: must not be called while the lock is in use
+	void enable_stats(const string& name);
+	//! returns the contention statistics of this lock or nullptr if disabled
+	const lock_stats* get_stats() const {
+#if defined(FLOOR_LOCK_STATS)
+		return stats.get();
+#else
+		return nullptr;
+#endif
+	}
+	//! logs the contention statistics of all locks that have statistics enabled (including already destroyed ones)
+	static void dump_stats();
+
 protected:
-	alignas(64) atomic<bool> mtx { false };
+	//! lock state (see above)
+	alignas(64) atomic<uint32_t> mtx { 0u };
+	MODE mode { MODE::ADAPTIVE };
+#if defined(FLOOR_LOCK_STATS)
+	shared_ptr<lock_stats> stats;
+#endif
+	
+	//! contended lock path: spins and then either parks or yields depending on the mode
+	floor_noinline void lock_contended();
 	
 };
 
@@ -20,82 +20,108 @@
 #define __FLOOR_THREADING_SAFE_RESOURCE_CONTAINER_HPP__
 
 #include <floor/core/essentials.hpp>
-#include <floor/threading/thread_safety.hpp>
-#if defined(FLOOR_DEBUG)
-#include <floor/core/logger.hpp>
-#include <floor/core/core.hpp>
-#endif
-#include <bitset>
-#include <thread>
+#include <atomic>
 #include <array>
+#include <bit>
 #include <cassert>
 using namespace std;
 
 //! a thread-safe container of multiple resources of the same type, allowing thread-safe resource allocation/usage/release
+//! NOTE: resource acquisition is lock-free (atomic bitmask: find-first-zero + CAS), acquire() blocks (futex-based
+//!       atomic wait) until a resource is released if all resources are currently in use
 template <typename resource_type, uint32_t resource_count>
 class safe_resource_container {
 public:
 	explicit safe_resource_container(array<resource_type, resource_count>&& resources_) : resources(resources_) {}
 	
-	//! tries to acquire a resource,
+	//! tries to acquire a resource (non-blocking),
 	//! returns { resource, index } on success,
 	//! returns { {}, ~0u } on failure
-	pair<resource_type, uint32_t> try_acquire() REQUIRES(!resource_lock) {
-		for (uint32_t trial = 0, limiter = 10; trial < limiter; ++trial) {
-			{
-				GUARD(resource_lock);
-				if (!resources_in_use.all()) {
-					for (uint32_t i = 0; i < resource_count; ++i) {
-						if (!resources_in_use[i]) {
-							resources_in_use.set(i);
-							return { resources[i], i };
-						}
-					}
-					floor_unreachable();
-				}
-			}
-			this_thread::yield();
+	pair<resource_type, uint32_t> try_acquire() {
+		if (const auto idx = try_acquire_index(); idx != ~0u) {
+			return { resources[idx], idx };
 		}
 		return { {}, ~0u };
 	}
 	
 	//! acquires a resource, returns { resource, index }
-	pair<resource_type, uint32_t> acquire() REQUIRES(!resource_lock) {
-		for (uint32_t counter = 0;; ++counter) {
-			{
-				GUARD(resource_lock);
-				if (!resources_in_use.all()) {
-					for (uint32_t i = 0; i < resource_count; ++i) {
-						if (!resources_in_use[i]) {
-							resources_in_use.set(i);
-							return { resources[i], i };
-						}
-					}
-					floor_unreachable();
-				}
+	//! NOTE: if all resources are currently in use, this blocks until one is released
+	pair<resource_type, uint32_t> acquire() {
+		for (;;) {
+			if (const auto idx = try_acquire_index(); idx != ~0u) {
+				return { resources[idx], idx };
 			}
-			this_thread::yield();
-#if defined(FLOOR_DEBUG)
-			if (counter == 1000) {
-				log_warn("resource acquisition is probably stuck ($: $)", core::get_current_thread_name(), typeid(*this).name());
+			
+			// slow path: wait until a resource has been released
+			// NOTE: the waiter count must be incremented before retrying, while release() clears the bit before
+			//       checking for waiters -> either we see the released resource or release() sees us waiting
+			const auto epoch = release_epoch.load();
+			++waiters;
+			if (const auto idx = try_acquire_index(); idx != ~0u) {
+				--waiters;
+				return { resources[idx], idx };
 			}
-#endif
+			release_epoch.wait(epoch);
+			--waiters;
 		}
 	}
 	
 	//! release a resource again
-	void release(const pair<resource_type, uint32_t>& resource) REQUIRES(!resource_lock) {
-		GUARD(resource_lock);
-		resources_in_use.reset(resource.second);
+	void release(const pair<resource_type, uint32_t>& resource) {
+		release(resource.second);
+	}
+	
+	//! release the resource with the specified index again
+	void release(const uint32_t index) {
+		assert(index < resource_count && "invalid resource index");
+		const auto mask_idx = index / 64u;
+		const auto bit = 1ull << (index % 64u);
+		[[maybe_unused]] const auto prev = resources_in_use[mask_idx].fetch_and(~bit, memory_order_release);
+		assert((prev & bit) != 0 && "resource was not in use");
+		
+		++release_epoch;
+		if (waiters > 0) {
+			release_epoch.notify_one();
+		}
+	}
+	
+	//! returns the resource with the specified index (regardless of its usage state)
+	const resource_type& get_resource(const uint32_t index) const {
+		return resources[index];
 	}
 
 protected:
-	//! lock for "resources"
-	safe_mutex resource_lock;
-	//! contained resources
-	array<resource_type, resource_count> resources GUARDED_BY(resource_lock) {};
-	//! bitset of which resources are currently in use
-	bitset<resource_count> resources_in_use GUARDED_BY(resource_lock) {};
+	static constexpr const uint32_t mask_count { (resource_count + 63u) / 64u };
+	//! returns the bitmask of valid resource bits in the specified mask
+	static constexpr uint64_t valid_mask(const uint32_t mask_idx) {
+		const auto bits = resource_count - mask_idx * 64u;
+		return (bits >= 64u ? ~0ull : ((1ull << bits) - 1ull));
+	}
+	
+	//! contained resources (constant after construction)
+	const array<resource_type, resource_count> resources {};
+	//! bitmasks of which resources are currently in use
+	array<atomic<uint64_t>, mask_count> resources_in_use {};
+	//! incremented on each release, used to wait for releases
+	atomic<uint32_t> release_epoch { 0u };
+	//! amount of threads that are waiting in acquire()
+	atomic<uint32_t> waiters { 0u };
+	
+	//! tries to acquire a resource, returns its index on success, ~0u on failure
+	uint32_t try_acquire_index() {
+		for (uint32_t mask_idx = 0; mask_idx < mask_count; ++mask_idx) {
+			const auto valid = valid_mask(mask_idx);
+			auto& mask = resources_in_use[mask_idx];
+			auto cur_mask = mask.load(memory_order_relaxed);
+			while ((cur_mask & valid) != valid) {
+				const auto bit_idx = uint32_t(countr_one(cur_mask));
+				if (mask.compare_exchange_weak(cur_mask, cur_mask | (1ull << bit_idx), memory_order_acquire, memory_order_relaxed)) {
+					return mask_idx * 64u + bit_idx;
+				}
+			}
+		}
+		return ~0u;
+	}
 	
 };
 
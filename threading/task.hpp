@@ -25,71 +25,55 @@
 #include <string>
 #include <functional>
 #include <floor/threading/thread_safety.hpp>
+#include <floor/threading/task_scheduler.hpp>
 #include <floor/core/logger.hpp>
 #include <floor/core/core.hpp>
 using namespace std;
 
 namespace task {
 
-//! creates ("spawns") a new task that asynchronously executes the supplied function in a separate thread
-//! NOTE: memory management of the task object is not necessary as it will automatically self-destruct
-//! after completing the task op or after encountering an unhandled exception.
+//! runs "op", catching and logging all exceptions (used by spawn() and spawn_blocking())
+static inline void run_task(const std::function<void()>& op, const string& task_name) {
+	try {
+		op();
+	} catch (exception& exc) {
+		log_error("encountered an unhandled exception while running task \"$\": $", task_name, exc.what());
+	} catch (...) {
+		log_error("encountered an unhandled exception while running task \"$\"", task_name);
+	}
+}
+
+//! creates ("spawns") a new task that asynchronously executes the supplied function on the global task scheduler
 //! NOTE: example usage: task::spawn([]() { cout << "do something in here" << endl; });
-static inline void spawn(std::function<void()> op, const string task_name = "task") {
-	struct task {
-		task(std::function<void()> op_, const string task_name_) :
-		op(op_), task_name(task_name_),
-		thread_obj(&task::run, this, [this]() {
-			// the task thread is not allowed to run until the task thread object has been detached from the callers thread
-			while(!initialized) { this_thread::yield(); }
-			// finally: call the users task op
-			op();
-		}) {
-			thread_obj.detach();
-		}
-		~task() = default;
-		
-		const std::function<void()> op;
-		const string task_name;
-		atomic<bool> initialized { false };
-		thread thread_obj;
-		
-		unique_ptr<task> task_alloc;
-		
-		//! moves the outside task allocation to the interior and starts the task execution
-		void set_alloc_and_start(unique_ptr<task>&& alloc) {
-			task_alloc = move(alloc);
-			task_alloc->initialized = true;
-		}
+//! NOTE: tasks are executed by a fixed amount of worker threads -> long blocking tasks must use spawn_blocking() instead
+static inline void spawn(std::function<void()> op, const string task_name = "task",
+						 const task_scheduler::PRIORITY priority = task_scheduler::PRIORITY::NORMAL) {
+	task_scheduler::get_global().submit([op = std::move(op), task_name]() {
+		run_task(op, task_name);
+	}, priority);
+}
 		
-		//! the tasks threads run method (only used internally)
-		static void run(task* this_task, std::function<void()> task_op) {
-			// the task thread is not allowed to run until the task thread object has been detached from the callers thread
-			while(!this_task->initialized) { this_thread::yield(); }
-			
-			core::set_current_thread_name(this_task->task_name);
-			
-			try {
-				// NOTE: this is the function object created above (not the users task op!)
-				task_op();
-			} catch (exception& exc) {
-				log_error("encountered an unhandled exception while running task \"$\": $",
-						  core::get_current_thread_name(), exc.what());
-			} catch (...) {
-				log_error("encountered an unhandled exception while running task \"$\"",
-						  core::get_current_thread_name());
-			}
-			this_task->task_alloc = nullptr;
-		}
+//! creates ("spawns") a new task that asynchronously executes the supplied function in a separate (detached) thread
+//! NOTE: use this instead of spawn() for tasks that block for a longer time (waiting on devices, I/O, child processes),
+//!       so that they don't occupy a worker thread of the global task scheduler
+static inline void spawn_blocking(std::function<void()> op, const string task_name = "task") {
+	thread([op = std::move(op), task_name]() {
+		core::set_current_thread_name(task_name);
+		run_task(op, task_name);
+	}).detach();
+}
 		
-		// prohibit copying
-		task(const task& tsk) = delete;
-		task& operator=(const task& tsk) = delete;
+//! asynchronously executes "op" on the global task scheduler and returns a future of its result
+template <typename F>
+static inline auto async(F&& op, const task_scheduler::PRIORITY priority = task_scheduler::PRIORITY::NORMAL) {
+	return task_scheduler::get_global().async(std::forward<F>(op), priority);
+}
 		
-	};
-	auto task_obj = make_unique<task>(op, task_name);
-	auto task_ptr = task_obj.get();
-	task_ptr->set_alloc_and_start(move(task_obj));
+//! executes op(i) for all i in [begin, end) on the global task scheduler, blocks until all have been processed
+static inline void parallel_for(const size_t begin, const size_t end, const std::function<void(size_t)>& op,
+								const size_t grain_size = 0u,
+								const task_scheduler::PRIORITY priority = task_scheduler::PRIORITY::NORMAL) {
+	task_scheduler::get_global().parallel_for(begin, end, op, grain_size, priority);
 }
 
 } // namespace task
@@ -0,0 +1,251 @@
+/*
+ *  Flo's Open libRary (floor)
+ *  Copyright (C) 2004 - 2022 Florian Ziesche
+ *  
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; version 2 of the License only.
+ *  
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <floor/threading/task_scheduler.hpp>
+#include <floor/core/logger.hpp>
+#include <floor/core/core.hpp>
+
+//! the scheduler and worker index of the calling thread (if it is a worker thread)
+static thread_local const task_scheduler* tls_scheduler { nullptr };
+static thread_local uint32_t tls_worker_idx { ~0u };
+
+task_scheduler::task_scheduler(const uint32_t worker_count_) {
+	const auto worker_count = (worker_count_ > 0u ? worker_count_ : max(core::get_hw_thread_count(), 1u));
+	queues.reserve(worker_count);
+	for (uint32_t i = 0; i < worker_count; ++i) {
+		queues.emplace_back(make_unique<worker_queue>());
+	}
+	workers.reserve(worker_count);
+	for (uint32_t i = 0; i < worker_count; ++i) {
+		workers.emplace_back(&task_scheduler::worker_run, this, i);
+	}
+}
+
+task_scheduler::~task_scheduler() {
+	{
+		lock_guard<mutex> lock(sleep_lock);
+		shutdown = true;
+	}
+	sleep_cv.notify_all();
+	for (auto& worker : workers) {
+		if (worker.joinable()) {
+			worker.join();
+		}
+	}
+}
+
+task_scheduler& task_scheduler::get_global() {
+	static task_scheduler global_scheduler;
+	return global_scheduler;
+}
+
+uint32_t task_scheduler::get_current_worker_index() const {
+	return (tls_scheduler == this ? tls_worker_idx : ~0u);
+}
+
+void task_scheduler::submit(std::function<void()> op, const PRIORITY priority) {
+	auto queue_idx = get_current_worker_index();
+	if (queue_idx == ~0u) {
+		queue_idx = next_queue++ % uint32_t(queues.size());
+	}
+	{
+		auto& queue = *queues[queue_idx];
+		GUARD(queue.lock);
+		queue.tasks[uint32_t(priority)].emplace_back(task_entry { std::move(op) });
+	}
+	
+	// NOTE: the pending increment must happen before checking for sleeping workers,
+	//       while workers increment the sleeping count before checking for pending tasks
+	++pending_tasks;
+	if (sleeping_workers > 0) {
+		{
+			lock_guard<mutex> lock(sleep_lock);
+		}
+		sleep_cv.notify_one();
+	}
+}
+
+bool task_scheduler::pop_task(const uint32_t queue_idx, task_entry& task) {
+	if (pending_tasks <= 0) {
+		return false;
+	}
+	
+	const auto queue_count = uint32_t(queues.size());
+	for (uint32_t prio = 0; prio < priority_count; ++prio) {
+		// own tasks first (LIFO)
+		if (queue_idx != ~0u) {
+			auto& queue = *queues[queue_idx];
+			GUARD(queue.lock);
+			auto& tasks = queue.tasks[prio];
+			if (!tasks.empty()) {
+				task = std::move(tasks.back());
+				tasks.pop_back();
+				--pending_tasks;
+				return true;
+			}
+		}
+		
+		// steal from other workers (FIFO), starting at the next worker to spread out contention
+		const auto start_idx = (queue_idx != ~0u ? queue_idx + 1u : 0u);
+		for (uint32_t i = 0; i < queue_count; ++i) {
+			const auto victim_idx = (start_idx + i) % queue_count;
+			if (victim_idx == queue_idx) {
+				continue;
+			}
+			auto& queue = *queues[victim_idx];
+			GUARD(queue.lock);
+			auto& tasks = queue.tasks[prio];
+			if (!tasks.empty()) {
+				task = std::move(tasks.front());
+				tasks.pop_front();
+				--pending_tasks;
+				return true;
+			}
+		}
+	}
+	return false;
+}
+
+void task_scheduler::execute(task_entry& task) {
+	try {
+		task.op();
+	} catch (exception& exc) {
+		log_error("encountered an unhandled exception while running a task: $", exc.what());
+	} catch (...) {
+		log_error("encountered an unhandled exception while running a task");
+	}
+	task.op = nullptr;
+}
+
+bool task_scheduler::run_pending_task() {
+	task_entry task;
+	if (!pop_task(get_current_worker_index(), task)) {
+		return false;
+	}
+	execute(task);
+	return true;
+}
+
+void task_scheduler::worker_run(const uint32_t worker_idx) {
+	tls_scheduler = this;
+	tls_worker_idx = worker_idx;
+	core::set_current_thread_name("task_worker_" + to_string(worker_idx));
+	
+	task_entry task;
+	for (;;) {
+		if (pop_task(worker_idx, task)) {
+			execute(task);
+			continue;
+		}
+		
+		unique_lock<mutex> lock(sleep_lock);
+		++sleeping_workers;
+		sleep_cv.wait(lock, [this] {
+			return (pending_tasks > 0 || shutdown);
+		});
+		--sleeping_workers;
+		if (shutdown && pending_tasks <= 0) {
+			break;
+		}
+	}
+}
+
+void task_scheduler::parallel_for(const size_t begin, const size_t end, const std::function<void(size_t)>& op,
+								  const size_t grain_size, const PRIORITY priority) {
+	if (begin >= end) {
+		return;
+	}
+	const auto count = end - begin;
+	const auto worker_count = size_t(workers.size());
+	const auto grain = (grain_size > 0u ? grain_size : max(count / (worker_count * 4u), size_t(1u)));
+	const auto chunk_count = (count + grain - 1u) / grain;
+	
+	// shared state, since helper tasks may only start executing once all chunks have already been processed
+	struct parallel_for_state {
+		const std::function<void(size_t)>* op;
+		size_t begin;
+		size_t end;
+		size_t grain;
+		size_t chunk_count;
+		atomic<size_t> next_chunk { 0u };
+		atomic<size_t> done_chunks { 0u };
+		atomic<bool> failed { false };
+		mutex exception_lock;
+		exception_ptr exception;
+		mutex done_lock;
+		condition_variable done_cv;
+		
+		//! processes chunks until there are none left
+		void run() {
+			for (;;) {
+				const auto chunk = next_chunk++;
+				if (chunk >= chunk_count) {
+					return;
+				}
+				if (!failed) {
+					const auto chunk_begin = begin + chunk * grain;
+					const auto chunk_end = min(chunk_begin + grain, end);
+					try {
+						for (auto idx = chunk_begin; idx < chunk_end; ++idx) {
+							(*op)(idx);
+						}
+					} catch (...) {
+						lock_guard<mutex> lock(exception_lock);
+						if (!failed.exchange(true)) {
+							exception = current_exception();
+						}
+					}
+				}
+				if (++done_chunks == chunk_count) {
+					{
+						lock_guard<mutex> lock(done_lock);
+					}
+					done_cv.notify_all();
+				}
+			}
+		}
+	};
+	auto state = make_shared<parallel_for_state>();
+	state->op = &op;
+	state->begin = begin;
+	state->end = end;
+	state->grain = grain;
+	state->chunk_count = chunk_count;
+	
+	// start helpers (the calling thread is the last participant)
+	const auto helper_count = min(chunk_count, worker_count + 1u) - 1u;
+	for (size_t i = 0; i < helper_count; ++i) {
+		submit([state] { state->run(); }, priority);
+	}
+	state->run();
+	
+	// wait until all chunks have been processed, help with other tasks in the mean time
+	while (state->done_chunks < chunk_count) {
+		if (run_pending_task()) {
+			continue;
+		}
+		unique_lock<mutex> lock(state->done_lock);
+		state->done_cv.wait_for(lock, 1ms, [&state, chunk_count] {
+			return (state->done_chunks == chunk_count);
+		});
+	}
+	
+	if (state->exception) {
+		rethrow_exception(state->exception);
+	}
+}
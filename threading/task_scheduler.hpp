@@ -0,0 +1,311 @@
+/*
+ *  Flo's Open libRary (floor)
+ *  Copyright (C) 2004 - 2022 Florian Ziesche
+ *  
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; version 2 of the License only.
+ *  
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *  
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef __FLOOR_TASK_SCHEDULER_HPP__
+#define __FLOOR_TASK_SCHEDULER_HPP__
+
+#include <floor/core/essentials.hpp>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <deque>
+#include <vector>
+#include <array>
+#include <memory>
+#include <optional>
+#include <exception>
+#include <type_traits>
+#include <floor/threading/thread_safety.hpp>
+using namespace std;
+
+template <typename T> class task_future;
+
+//! work-stealing task scheduler:
+//! each worker thread has its own set of task deques (one per priority), tasks that are submitted from a worker thread
+//! are pushed onto that worker's deques, tasks submitted from any other thread are distributed over all workers.
+//! workers execute their own tasks in LIFO order and steal tasks from other workers in FIFO order when they run out.
+//! tasks are always executed in priority order (higher priority tasks of any worker are executed before lower ones).
+//! NOTE: threads that wait on task results (task_future::wait/get, parallel_for) help executing pending tasks
+class task_scheduler {
+public:
+	//! task priority (lower value -> higher priority)
+	enum class PRIORITY : uint32_t {
+		HIGH = 0,
+		NORMAL = 1,
+		LOW = 2,
+	};
+	static constexpr const uint32_t priority_count { 3u };
+	
+	//! creates a scheduler with "worker_count" worker threads (0 = #h/w threads)
+	explicit task_scheduler(const uint32_t worker_count = 0u);
+	//! finishes all pending tasks and joins all worker threads
+	~task_scheduler();
+	
+	//! returns the global scheduler (with #h/w threads workers)
+	//! NOTE: the global scheduler is created on first use and is destroyed at exit (static destruction), which finishes
+	//!       all pending tasks and joins all workers
+	static task_scheduler& get_global();
+	
+	//! submits the task "op" for asynchronous execution
+	//! NOTE: any exception escaping "op" is caught and logged
+	void submit(std::function<void()> op, const PRIORITY priority = PRIORITY::NORMAL);
+	
+	//! asynchronously executes "op" and returns a future of its result
+	template <typename F>
+	auto async(F&& op, const PRIORITY priority = PRIORITY::NORMAL) -> task_future<invoke_result_t<decay_t<F>>>;
+	
+	//! executes op(i) for all i in [begin, end), split into chunks of "grain_size" indices (0 = automatic),
+	//! blocks until all indices have been processed (the calling thread also executes chunks)
+	//! NOTE: if any op call throws, no further chunks are started and the first exception is rethrown in the calling thread
+	void parallel_for(const size_t begin, const size_t end, const std::function<void(size_t)>& op,
+					  const size_t grain_size = 0u, const PRIORITY priority = PRIORITY::NORMAL);
+	
+	//! executes a single pending task in the calling thread (if there is any), returns true if a task was executed
+	bool run_pending_task();
+	
+	//! returns the amount of worker threads
+	uint32_t get_worker_count() const {
+		return uint32_t(workers.size());
+	}
+
+protected:
+	struct task_entry {
+		std::function<void()> op;
+	};
+	
+	//! per-worker task deques
+	struct alignas(64) worker_queue {
+		safe_mutex lock;
+		array<deque<task_entry>, priority_count> tasks GUARDED_BY(lock);
+	};
+	
+	vector<unique_ptr<worker_queue>> queues;
+	vector<thread> workers;
+	
+	//! amount of submitted, but not yet started tasks
+	//! NOTE: this may temporarily be negative, since tasks are counted after they have been added to a queue
+	atomic<int64_t> pending_tasks { 0 };
+	//! used to distribute tasks that are submitted from non-worker threads
+	atomic<uint32_t> next_queue { 0u };
+	
+	// sleep handling of idle workers
+	mutex sleep_lock;
+	condition_variable sleep_cv;
+	atomic<uint32_t> sleeping_workers { 0u };
+	atomic<bool> shutdown { false };
+	
+	//! worker thread function
+	void worker_run(const uint32_t worker_idx);
+	
+	//! returns the queue index of the calling thread if it is a worker of this scheduler, ~0u otherwise
+	uint32_t get_current_worker_index() const;
+	
+	//! tries to retrieve a task (own queue first, then steals from others), "queue_idx" may be ~0u for non-workers
+	bool pop_task(const uint32_t queue_idx, task_entry& task);
+	
+	//! executes the specified task (catching and logging all exceptions)
+	void execute(task_entry& task);
+	
+	// prohibit copying
+	task_scheduler(const task_scheduler&) = delete;
+	task_scheduler& operator=(const task_scheduler&) = delete;
+
+};
+
+//! internal shared state of a task_future
+template <typename T>
+struct task_future_state {
+	using value_type = conditional_t<is_void_v<T>, bool, T>;
+	
+	task_scheduler* scheduler { nullptr };
+	task_scheduler::PRIORITY priority { task_scheduler::PRIORITY::NORMAL };
+	
+	mutex lock;
+	condition_variable cv;
+	atomic<bool> ready { false };
+	optional<value_type> value;
+	exception_ptr exception;
+	//! continuations that are submitted once this has completed
+	vector<std::function<void()>> continuations;
+	
+	//! sets the result value (constructed from "args"), then submits all continuations
+	template <typename... Args>
+	void complete_value(Args&&... args) {
+		complete([&] {
+			value.emplace(std::forward<Args>(args)...);
+		});
+	}
+	
+	//! completes a void task, then submits all continuations
+	void complete_void() requires(is_void_v<T>) {
+		complete_value(true);
+	}
+	
+	//! sets the result exception, then submits all continuations
+	void complete_exception(exception_ptr exc) {
+		complete([&] {
+			exception = std::move(exc);
+		});
+	}
+	
+	//! adds a continuation, or directly submits it if this has already completed
+	void add_continuation(std::function<void()> cont) {
+		{
+			lock_guard<mutex> guard(lock);
+			if (!ready) {
+				continuations.emplace_back(std::move(cont));
+				return;
+			}
+		}
+		scheduler->submit(std::move(cont), priority);
+	}
+	
+	//! sets the result via "set_result" (with the lock held), then submits all continuations
+	template <typename F>
+	void complete(F&& set_result) {
+		vector<std::function<void()>> conts;
+		{
+			lock_guard<mutex> guard(lock);
+			set_result();
+			ready = true;
+			conts.swap(continuations);
+		}
+		cv.notify_all();
+		for (auto& cont : conts) {
+			scheduler->submit(std::move(cont), priority);
+		}
+	}
+	
+	//! blocks until completion, executes other pending tasks in the mean time
+	void wait() {
+		while (!ready) {
+			if (scheduler->run_pending_task()) {
+				continue;
+			}
+			// nothing to help with: sleep until completion, but recheck for new tasks periodically
+			// (the task we're waiting on might depend on tasks that are yet to be submitted)
+			unique_lock<mutex> guard(lock);
+			cv.wait_for(guard, 1ms, [this] { return ready.load(); });
+		}
+	}
+};
+
+//! future of an asynchronously executed task, supporting continuations
+template <typename T>
+class task_future {
+public:
+	task_future() = default;
+	explicit task_future(shared_ptr<task_future_state<T>> state_) : state(std::move(state_)) {}
+	
+	//! returns true if this refers to a task
+	bool valid() const {
+		return (state != nullptr);
+	}
+	
+	//! returns true if the task has completed
+	bool is_ready() const {
+		return (state && state->ready);
+	}
+	
+	//! blocks until the task has completed (executes other pending tasks in the mean time)
+	void wait() const {
+		state->wait();
+	}
+	
+	//! blocks until the task has completed and returns its result (or rethrows its exception)
+	//! NOTE: copyable results are copied, i.e. this may be called multiple times and alongside continuations,
+	//!       move-only results are moved out of the future, i.e. this may only be called once and must be the only consumer
+	T get() {
+		state->wait();
+		if (state->exception) {
+			rethrow_exception(state->exception);
+		}
+		if constexpr (is_copy_constructible_v<T>) {
+			return *state->value;
+		} else if constexpr (!is_void_v<T>) {
+			return std::move(*state->value);
+		}
+	}
+	
+	//! executes "op" once this task has completed, with the task result as its argument (or no argument if void),
+	//! returns a future of the result of "op"
+	//! NOTE: "op" receives a const reference to the result, i.e. multiple continuations can be added to a task
+	//! NOTE: if this task failed with an exception, "op" is not executed and the exception is propagated instead
+	template <typename F>
+	auto then(F&& op) {
+		using ret_type = decltype(invoke_then(declval<decay_t<F>&>(), declval<const task_future_state<T>&>()));
+		auto next_state = make_shared<task_future_state<ret_type>>();
+		next_state->scheduler = state->scheduler;
+		next_state->priority = state->priority;
+		state->add_continuation([prev_state = state, next_state, op = decay_t<F>(std::forward<F>(op))]() mutable {
+			if (prev_state->exception) {
+				next_state->complete_exception(prev_state->exception);
+				return;
+			}
+			try {
+				if constexpr (is_void_v<ret_type>) {
+					invoke_then(op, *prev_state);
+					next_state->complete_void();
+				} else {
+					next_state->complete_value(invoke_then(op, *prev_state));
+				}
+			} catch (...) {
+				next_state->complete_exception(current_exception());
+			}
+		});
+		return task_future<ret_type>(next_state);
+	}
+
+protected:
+	shared_ptr<task_future_state<T>> state;
+	
+	template <typename F>
+	static decltype(auto) invoke_then(F& op, const task_future_state<T>& prev_state) {
+		if constexpr (is_void_v<T>) {
+			return op();
+		} else {
+			return op(*prev_state.value);
+		}
+	}
+
+};
+
+template <typename F>
+auto task_scheduler::async(F&& op, const PRIORITY priority) -> task_future<invoke_result_t<decay_t<F>>> {
+	using ret_type = invoke_result_t<decay_t<F>>;
+	auto state = make_shared<task_future_state<ret_type>>();
+	state->scheduler = this;
+	state->priority = priority;
+	submit([state, op = decay_t<F>(std::forward<F>(op))]() mutable {
+		try {
+			if constexpr (is_void_v<ret_type>) {
+				op();
+				state->complete_void();
+			} else {
+				state->complete_value(op());
+			}
+		} catch (...) {
+			state->complete_exception(current_exception());
+		}
+	}, priority);
+	return task_future<ret_type>(state);
+}
+
+#endif
@@ -52,7 +52,7 @@ void thread_base::restart() {
 	// terminate old thread if it is still running
 	if(thread_obj != nullptr) {
 		if(thread_obj->joinable()) {
-			thread_should_finish_flag = true;
+			set_thread_should_finish();
 			thread_obj->join();
 		}
 	}
@@ -69,6 +69,7 @@ int thread_base::_thread_run(thread_base* this_thread_obj) {
 	
 	while(true) {
 		// wait until we get the thread lock
+		const uint64_t epoch = this_thread_obj->unlock_epoch;
 		if(this_thread_obj->try_lock()) {
 			// if the "finish flag" has been set in the mean time, don't call the run method!
 			if(!this_thread_obj->thread_should_finish()) {
@@ -88,7 +89,13 @@ int thread_base::_thread_run(thread_base* this_thread_obj) {
 			if(!this_thread_obj->thread_should_finish()) {
 				// reduce system load and make other locks possible
 				const size_t thread_delay = this_thread_obj->get_thread_delay();
-				if(thread_delay > 0) {
+				if(this_thread_obj->is_event_driven()) {
+					// block until notified or the thread delay has passed
+					this_thread_obj->wait_for_notify(thread_delay > 0 ?
+													 chrono::milliseconds(thread_delay) :
+													 chrono::milliseconds::max());
+				}
+				else if(thread_delay > 0) {
 					this_thread::sleep_for(chrono::milliseconds(thread_delay));
 				}
 				else {
@@ -100,7 +107,15 @@ int thread_base::_thread_run(thread_base* this_thread_obj) {
 			}
 		}
 		else {
-			if(this_thread_obj->get_yield_after_run()) {
+			if(this_thread_obj->is_event_driven()) {
+				// block until the thread lock has been released by its current holder
+				unique_lock<mutex> lock(this_thread_obj->notify_lock);
+				this_thread_obj->notify_cv.wait(lock, [this_thread_obj, epoch] {
+					return (this_thread_obj->unlock_epoch != epoch || this_thread_obj->thread_should_finish() ||
+							!this_thread_obj->is_event_driven());
+				});
+			}
+			else if(this_thread_obj->get_yield_after_run()) {
 				this_thread::yield();
 			}
 		}
@@ -120,12 +135,9 @@ void thread_base::finish() {
 			get_thread_status() == THREAD_STATUS::INIT) {
 			// already finished or uninitialized, nothing to do here
 		} else {
-			// signal thread to finish
+			// signal thread to finish (this also wakes up the thread if it is blocked in event-driven mode)
 			set_thread_should_finish();
 			
-			// wait a few ms
-			this_thread::sleep_for(100ms);
-			
 			// this will block until the thread is finished
 			if (thread_obj->joinable()) {
 				thread_obj->join();
@@ -173,6 +185,15 @@ void thread_base::unlock() {
 	} catch(...) {
 		cout << "unable to unlock thread" << endl;
 	}
+	
+	if(event_driven) {
+		// wake up the thread if it is blocked on the thread lock
+		{
+			lock_guard<mutex> lock(notify_lock);
+			++unlock_epoch;
+		}
+		notify_cv.notify_all();
+	}
 }
 
 void thread_base::set_thread_status(const thread_base::THREAD_STATUS status) {
@@ -191,6 +212,7 @@ bool thread_base::is_running() const {
 
 void thread_base::set_thread_should_finish() {
 	thread_should_finish_flag = true;
+	wake();
 }
 
 bool thread_base::thread_should_finish() {
@@ -213,6 +235,45 @@ bool thread_base::get_yield_after_run() const {
 	return yield_after_run;
 }
 
+void thread_base::set_event_driven(const bool state) {
+	event_driven = state;
+	// wake up the thread in case it is currently waiting in the previous mode
+	notify();
+}
+
+bool thread_base::is_event_driven() const {
+	return event_driven;
+}
+
+void thread_base::notify() {
+	{
+		lock_guard<mutex> lock(notify_lock);
+		notified = true;
+	}
+	notify_cv.notify_all();
+}
+
+void thread_base::wake() {
+	{
+		lock_guard<mutex> lock(notify_lock);
+	}
+	notify_cv.notify_all();
+}
+
+bool thread_base::wait_for_notify(const chrono::milliseconds timeout) {
+	unique_lock<mutex> lock(notify_lock);
+	const auto pred = [this] {
+		return (notified || thread_should_finish());
+	};
+	if(timeout == chrono::milliseconds::max()) {
+		notify_cv.wait(lock, pred);
+	}
+	else {
+		notify_cv.wait_for(lock, timeout, pred);
+	}
+	return exchange(notified, false);
+}
+
 const string& thread_base::get_thread_name() const {
 	return thread_name;
 }
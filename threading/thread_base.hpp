@@ -22,6 +22,8 @@
 #include <floor/core/essentials.hpp>
 #include <thread>
 #include <mutex>
+#include <condition_variable>
+#include <chrono>
 #include <string>
 #include <atomic>
 #include <memory>
@@ -31,6 +33,8 @@ using namespace std;
 //! if you need a class that should be executed in a separate thread, you can use this simple base class to do so.
 //! usage: inherit from this class, add a virtual destructor, override the run() method and call start(). call finish()
 //! to finish/end the thread execution. look up the documentation for each of these calls.
+//! by default, the thread sleeps for the set thread delay after each run() call. in event-driven mode (-> set_event_driven()),
+//! the thread instead blocks after each run() call until notify() is called or the thread delay has passed.
 //! NOTE: for simpler "execute once in a separate thread" things, it might be easier to use a task (-> task.hpp).
 class thread_base {
 public:
@@ -97,6 +101,17 @@ public:
 	//! returns the "yield after run" flag
 	bool get_yield_after_run() const;
 	
+	//! enables or disables the event-driven mode:
+	//! if enabled, the thread will block after each run() call until it is notified (-> notify()), it should finish,
+	//! or the thread delay has passed (a thread delay of 0 will block indefinitely until notified)
+	void set_event_driven(const bool state);
+	//! returns true if the event-driven mode is enabled
+	bool is_event_driven() const;
+	
+	//! wakes up the thread in event-driven mode, run() will be called (again) as soon as possible
+	//! NOTE: notifications are not counted, multiple notifications before the next run() call result in a single run() call
+	void notify();
+	
 	//! returns the given name of the thread
 	const string& get_thread_name() const;
 	
@@ -110,6 +125,22 @@ protected:
 	atomic<size_t> thread_delay { 50 };
 	atomic<bool> thread_should_finish_flag { false };
 	atomic<bool> yield_after_run { true };
+	atomic<bool> event_driven { false };
+	
+	// event-driven mode wake-up handling
+	mutex notify_lock;
+	condition_variable notify_cv;
+	//! NOTE: protected by notify_lock
+	bool notified { false };
+	//! incremented on each unlock() in event-driven mode, so that a blocked thread can wait for the thread lock
+	atomic<uint64_t> unlock_epoch { 0u };
+	
+	//! blocks the calling thread until notify() has been called, the thread should finish, or "timeout" has passed,
+	//! returns true if notified (this also consumes the notification)
+	//! NOTE: this can also be called from inside run() to wait for further work (e.g. for batching purposes)
+	bool wait_for_notify(const chrono::milliseconds timeout);
+	//! signals "notify_cv" while holding "notify_lock" (so that the wake-up can't get lost)
+	void wake();
 	
 	//! this _must_ be called from the inheriting class to actually start the thread
 	void start();